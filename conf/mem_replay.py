@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""Replay recorded memory traces against a candidate cache/memory configuration.
+
+Input: the logs dir of a riscv32_mixed run with `--mem-trace packet|elastic`
+(`--trace-dir`), holding mem_trace.json and the traces it lists.
+
+- packet: one TrafficGen per cluster replays that cluster's L1 -> L2
+  requests, at their recorded ticks, into a candidate L2
+  (`--l2-size/--l2-assoc/--l2-prefetcher`). The TRACE state runs for the
+  captured duration, then an EXIT state ends the run.
+- elastic: one TraceCPU per traced O3 hart, with candidate L1I/L1D
+  (`--l1i-size/--l1d-size/--l1-assoc`) on its cluster's L1 crossbar and L2.
+  Dependencies are replayed, so the run ends when the last trace does and
+  simTicks is the candidate's execution time.
+
+Both rebuild the captured memory ranges behind one membus with the
+candidate memory (`--mem-type/--mem-channels/--mem-intlv-size`, `--membus-*`,
+`--l2bus-*`); unset options keep the captured configuration. MMIO requests
+in a trace reach a BadAddr responder on the membus default port. No ISA or
+guest software runs, which is what makes a replay much faster than the
+full-system capture.
+
+This script supports:
+- plain Python mode (`--print-json`) for dry-run planning
+- gem5 runtime mode when executed by gem5 binary
+"""
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, List
+
+from omx_gem5 import (
+    MEM_TRACE_SIDECAR,
+    MEM_TYPES,
+    PREFETCHERS,
+    add_stats_period_arguments,
+    add_stats_profile_arguments,
+    add_xbar_arguments,
+    apply_stats_profile,
+    attach_prefetcher,
+    configure_xbar,
+    make_memory_ctrls,
+    memory_plan,
+    simulate_in_slices,
+    stats_profile_plan,
+    xbar_plan,
+)
+
+REPLAY_SIDECAR = "mem_replay.json"
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Replay riscv32_mixed --mem-trace captures against candidate caches/memory",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--trace-dir", required=True, help=f"capture logs dir holding {MEM_TRACE_SIDECAR}")
+    p.add_argument("--l1i-size", default="", help="elastic: candidate L1I size (default: captured)")
+    p.add_argument("--l1d-size", default="", help="elastic: candidate L1D size (default: captured)")
+    p.add_argument("--l1-assoc", type=int, default=0, help="elastic: candidate L1 associativity (0: captured)")
+    p.add_argument("--l2-size", default="", help="candidate L2 size of every cluster (default: captured per cluster)")
+    p.add_argument("--l2-assoc", type=int, default=0, help="candidate L2 associativity (0: captured)")
+    p.add_argument("--l2-prefetcher", choices=PREFETCHERS, default="none")
+    p.add_argument("--mem-type", choices=sorted(MEM_TYPES), default=None, help="default: captured")
+    p.add_argument("--mem-channels", type=int, default=0, help="power of two (0: captured)")
+    p.add_argument("--mem-intlv-size", type=int, default=0, help="bytes, power of two (0: captured)")
+    add_xbar_arguments(p)
+    p.add_argument("--sys-clock", default="1GHz")
+    p.add_argument("--cpu-clock", default="1GHz", help="elastic: TraceCPU clock")
+    p.add_argument("--replay-ticks", type=int, default=0, help="packet: TRACE state length (0: captured duration)")
+    p.add_argument("--max-ticks", type=int, default=0, help="simulation limit (0: 4x the replay length)")
+    add_stats_period_arguments(p)
+    add_stats_profile_arguments(p)
+    p.add_argument("--print-json", action="store_true")
+    return p
+
+
+def _load_sidecar(trace_dir: Path) -> Dict[str, object]:
+    path = trace_dir / MEM_TRACE_SIDECAR
+    if not path.exists():
+        raise FileNotFoundError(f"{path} missing: capture with riscv32_mixed.py --mem-trace packet|elastic")
+    sidecar = json.loads(path.read_text(encoding="utf-8"))
+    if sidecar.get("kind") != "omx-mem-trace" or sidecar.get("mode") not in ("packet", "elastic"):
+        raise ValueError(f"{path}: not a packet/elastic mem_trace sidecar")
+    return sidecar
+
+
+def build_plan(args: argparse.Namespace) -> Dict[str, object]:
+    trace_dir = Path(args.trace_dir)
+    sidecar = _load_sidecar(trace_dir)
+    capture = sidecar["capture"]
+    captured_mem = capture["memory"]
+    mem_args = argparse.Namespace(
+        mem_type=args.mem_type or captured_mem["type"],
+        mem_channels=args.mem_channels or captured_mem["channels"],
+        mem_intlv_size=args.mem_intlv_size or captured_mem["intlv_size"],
+    )
+    mode = sidecar["mode"]
+    replay_ticks = args.replay_ticks or int(sidecar["sim_ticks"])
+    l2_assoc = args.l2_assoc or int(capture["l2_assoc"])
+
+    clusters: List[Dict[str, object]] = []
+    missing: List[str] = []
+    for cluster in sidecar["clusters"]:
+        item = {
+            "index": cluster["index"],
+            "name": cluster["name"],
+            "l2": {"size": args.l2_size or cluster["l2_size"], "assoc": l2_assoc, "prefetcher": args.l2_prefetcher},
+        }
+        if mode == "packet":
+            item["packet_trace"] = str(trace_dir / cluster["packet_trace"])
+            missing += [] if Path(item["packet_trace"]).exists() else [item["packet_trace"]]
+        else:
+            item["harts"] = [hart for hart in sidecar["harts"] if hart["cluster"] == cluster["index"]]
+            if not item["harts"]:
+                continue
+        clusters.append(item)
+    for hart in sidecar["harts"]:
+        for key in ("fetch_trace", "data_trace"):
+            hart[key] = str(trace_dir / hart[key])
+            missing += [] if Path(hart[key]).exists() else [hart[key]]
+
+    return {
+        "target": "mem_replay",
+        "mode": mode,
+        "trace_dir": str(trace_dir),
+        "source": {"target": sidecar["source"], "topology": sidecar["topology"], "sim_ticks": sidecar["sim_ticks"]},
+        "replay_ticks": replay_ticks,
+        "max_ticks": args.max_ticks or 4 * replay_ticks,
+        "stats_period": args.stats_period,
+        "stats": stats_profile_plan(args),
+        "memory_ranges": sidecar["memory_ranges"],
+        "memory": memory_plan(mem_args),
+        "xbars": xbar_plan(args),
+        "l1": {
+            "l1i_size": args.l1i_size or capture["l1i_size"],
+            "l1d_size": args.l1d_size or capture["l1d_size"],
+            "assoc": args.l1_assoc or int(capture["l1_assoc"]),
+        },
+        "o3": capture["o3"],
+        "clusters": clusters,
+        "missing_traces": missing,
+    }
+
+
+def _has_gem5_runtime() -> bool:
+    try:
+        import m5  # noqa: F401
+    except Exception:
+        return False
+    return True
+
+
+def _traffic_gen_config(path: Path, trace: str, ticks: int) -> str:
+    """TrafficGen state machine: replay the trace for `ticks`, then end the simulation."""
+    path.write_text(
+        "\n".join(
+            [
+                "# conf/mem_replay.py: packet trace replay",
+                f"STATE 0 {ticks} TRACE {trace} 0",
+                "STATE 1 0 EXIT",
+                "INIT 0",
+                "TRANSITION 0 1 1",
+                "TRANSITION 1 1 1",
+            ]
+        )
+        + "\n",
+        encoding="utf-8",
+    )
+    return str(path)
+
+
+def _run_gem5_runtime(args: argparse.Namespace) -> int:
+    import m5  # type: ignore
+    from m5.objects import (  # type: ignore
+        AddrRange,
+        BadAddr,
+        L2XBar,
+        Root,
+        SrcClockDomain,
+        System,
+        SystemXBar,
+        TraceCPU,
+        TrafficGen,
+        VoltageDomain,
+    )
+    from m5.util import addToPath  # type: ignore
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common.Caches import L1_DCache, L1_ICache, L2Cache  # type: ignore
+
+    plan = build_plan(args)
+    if plan["missing_traces"]:
+        raise FileNotFoundError(f"missing trace: {plan['missing_traces'][0]}")
+
+    system = System()
+    system.voltage_domain = VoltageDomain(voltage="1.0V")
+    system.clk_domain = SrcClockDomain(clock=args.sys_clock, voltage_domain=system.voltage_domain)
+    system.cpu_clk_domain = SrcClockDomain(clock=args.cpu_clock, voltage_domain=system.voltage_domain)
+    system.mem_mode = "timing"
+    system.cache_line_size = 64
+    system.mem_ranges = [AddrRange(start=r["base"], size=r["size"]) for r in plan["memory_ranges"]]
+
+    system.membus = configure_xbar(SystemXBar(), plan["xbars"]["membus"])
+    system.membus.badaddr_responder = BadAddr()
+    system.membus.default = system.membus.badaddr_responder.pio
+    system.system_port = system.membus.cpu_side_ports
+    mem_ctrls = []
+    for r in plan["memory_ranges"]:
+        mem_ctrls.extend(make_memory_ctrls(plan["memory"], r["base"], r["size"]))
+    system.mem_ctrls = mem_ctrls
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
+
+    outdir = Path(m5.options.outdir)
+    trace_cpus = []
+    for cluster in plan["clusters"]:
+        idx = int(cluster["index"])
+        l2 = L2Cache(size=cluster["l2"]["size"], assoc=cluster["l2"]["assoc"])
+        attach_prefetcher(l2, cluster["l2"]["prefetcher"])
+        setattr(system, f"cluster{idx}_l2", l2)
+        l2.mem_side = system.membus.cpu_side_ports
+        if plan["mode"] == "packet":
+            config = _traffic_gen_config(
+                outdir / f"cluster{idx}_replay.cfg", str(Path(cluster["packet_trace"]).resolve()), plan["replay_ticks"]
+            )
+            gen = TrafficGen(config_file=config)
+            setattr(system, f"cluster{idx}_gen", gen)
+            gen.port = l2.cpu_side
+            continue
+
+        bus = configure_xbar(L2XBar(), plan["xbars"]["l2bus"])
+        setattr(system, f"cluster{idx}_bus", bus)
+        l2.cpu_side = bus.mem_side_ports
+        for hart in cluster["harts"]:
+            cpu = TraceCPU(
+                cpu_id=hart["cpu_id"],
+                clk_domain=system.cpu_clk_domain,
+                instTraceFile=str(Path(hart["fetch_trace"]).resolve()),
+                dataTraceFile=str(Path(hart["data_trace"]).resolve()),
+                sizeROB=plan["o3"]["rob_entries"],
+                sizeLoadBuffer=plan["o3"]["lq_entries"],
+                sizeStoreBuffer=plan["o3"]["sq_entries"],
+            )
+            cpu.l1i = L1_ICache(size=plan["l1"]["l1i_size"], assoc=plan["l1"]["assoc"])
+            cpu.l1d = L1_DCache(size=plan["l1"]["l1d_size"], assoc=plan["l1"]["assoc"])
+            cpu.l1i.cpu_side = cpu.icache_port
+            cpu.l1d.cpu_side = cpu.dcache_port
+            cpu.l1i.mem_side = bus.cpu_side_ports
+            cpu.l1d.mem_side = bus.cpu_side_ports
+            trace_cpus.append(cpu)
+    if trace_cpus:
+        system.cpu = trace_cpus
+        for cpu in system.cpu:
+            cpu.createThreads()
+
+    root = Root(full_system=False, system=system)
+    print(
+        "[INFO] replay launch:",
+        f"mode={plan['mode']}",
+        f"trace_dir={plan['trace_dir']}",
+        f"clusters={len(plan['clusters'])}",
+        f"trace_cpus={len(trace_cpus)}",
+        *(f"cluster{c['index']}_l2={c['l2']['size']}/{c['l2']['assoc']}way" for c in plan["clusters"]),
+        f"mem={plan['memory']['type']}x{plan['memory']['channels']}",
+        f"replay_ticks={plan['replay_ticks']}",
+        f"stats_period={args.stats_period}",
+        f"stats={args.stats_profile}/{args.stats_format}",
+    )
+
+    apply_stats_profile(plan["stats"], m5.options.outdir)
+    m5.instantiate()
+    exit_event = simulate_in_slices(plan["max_ticks"], args.stats_period)
+    cause = exit_event.getCause()
+    tick = m5.curTick()
+    print(f"[INFO] gem5 exit cause: {cause}")
+    print(f"[INFO] gem5 exit tick: {tick}")
+    (outdir / REPLAY_SIDECAR).write_text(
+        json.dumps(dict(plan, exit_cause=cause, exit_tick=tick), indent=2) + "\n", encoding="utf-8"
+    )
+    # A replay that hits the limit did not finish its traces.
+    return 1 if "simulate() limit reached" in cause else 0
+
+
+def main() -> int:
+    args = parser().parse_args()
+    plan = build_plan(args)
+
+    if args.print_json or not _has_gem5_runtime():
+        print(json.dumps(plan, indent=2))
+        return 0
+
+    return _run_gem5_runtime(args)
+
+
+if __name__ in {"__main__", "__m5_main__"}:
+    raise SystemExit(main())
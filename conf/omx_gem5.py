@@ -0,0 +1,751 @@
+"""Shared gem5 object helpers for the platform configs in conf/.
+
+The platform scripts import this module both as plain Python (`--print-json`)
+and under the gem5 binary, so m5 is only imported inside the builders.
+"""
+
+import argparse
+from typing import Dict, List, Optional, Sequence, Tuple
+
+# Prefetcher name -> gem5 SimObject class (also fs.py's --l1d/l2-hwp-type).
+PREFETCHER_CLASSES = {
+    "stride": "StridePrefetcher",
+    "tagged": "TaggedPrefetcher",
+    "bop": "BOPPrefetcher",
+    "ampm": "AMPMPrefetcher",
+}
+PREFETCHERS = ("none", *PREFETCHER_CLASSES)
+CPU_MODELS = ("atomic", "timing", "minor", "o3")
+
+# --mem-type name -> gem5 memory class (SimpleMemory or a DRAM interface).
+MEM_TYPES = {
+    "simple": "SimpleMemory",
+    "ddr3": "DDR3_1600_8x8",
+    "ddr4": "DDR4_2400_8x8",
+    "lpddr5": "LPDDR5_6400_1x16_BG_BL32",
+    "hbm": "HBM_2000_4H_1x64",
+}
+
+# --<bus>-* option families. membus is the SystemXBar, l2bus every L2XBar
+# (cluster/L2 and LLC crossbars), iobus the IOXBar; True marks the coherent
+# crossbars that take a snoop response latency.
+XBAR_BUSES = {"membus": True, "l2bus": True, "iobus": False}
+XBAR_LATENCIES = ("frontend", "forward", "response", "snoop-response")
+
+# First match wins; the generic names are what single-ISA builds export.
+_CPU_CLASS_NAMES = {
+    "atomic": ("AtomicSimpleCPU", "RiscvAtomicSimpleCPU"),
+    "timing": ("TimingSimpleCPU", "RiscvTimingSimpleCPU"),
+    "minor": ("MinorCPU", "RiscvMinorCPU"),
+    "o3": ("RiscvO3CPU", "O3CPU", "DerivO3CPU"),
+}
+
+
+def parse_cluster_spec(
+    value: str, clusters: Sequence[str], option: str, choices: Sequence[str]
+) -> List[str]:
+    """Expand a per-cluster option into one name per cluster.
+
+    `stride` applies to every cluster; `none,bop` lists one name per cluster
+    in cluster order.
+    """
+    names = [item.strip().lower() for item in value.split(",") if item.strip()]
+    if len(names) == 1:
+        names = names * len(clusters)
+    if len(names) != len(clusters):
+        raise ValueError(
+            f"{option} expects 1 or {len(clusters)} comma-separated names "
+            f"({', '.join(clusters)}), got {value!r}"
+        )
+    for name in names:
+        if name not in choices:
+            raise ValueError(f"{option}: unknown value {name!r} (choices: {', '.join(choices)})")
+    return names
+
+
+def parse_prefetcher_spec(value: str, clusters: Sequence[str], option: str) -> List[str]:
+    return parse_cluster_spec(value, clusters, option, PREFETCHERS)
+
+
+def add_o3_arguments(p: argparse.ArgumentParser, prefix: str = "") -> None:
+    p.add_argument(f"--{prefix}o3-width", type=int, default=4, help="O3 fetch/decode/rename/issue/commit width")
+    p.add_argument(f"--{prefix}o3-rob-entries", type=int, default=128)
+    p.add_argument(f"--{prefix}o3-iq-entries", type=int, default=64)
+    p.add_argument(f"--{prefix}o3-lq-entries", type=int, default=32)
+    p.add_argument(f"--{prefix}o3-sq-entries", type=int, default=32)
+
+
+def o3_params(args: argparse.Namespace, prefix: str = "") -> Dict[str, int]:
+    key = prefix.replace("-", "_")
+    return {
+        "width": getattr(args, f"{key}o3_width"),
+        "rob_entries": getattr(args, f"{key}o3_rob_entries"),
+        "iq_entries": getattr(args, f"{key}o3_iq_entries"),
+        "lq_entries": getattr(args, f"{key}o3_lq_entries"),
+        "sq_entries": getattr(args, f"{key}o3_sq_entries"),
+    }
+
+
+def mem_mode_for(models: Sequence[str]) -> str:
+    """gem5 runs one memory mode per system; atomic cannot mix with the rest."""
+    if all(model == "atomic" for model in models):
+        return "atomic"
+    if any(model == "atomic" for model in models):
+        raise ValueError(f"cannot mix atomic with timing-mode CPU models in one system: {list(models)}")
+    return "timing"
+
+
+def cpu_class(model: str):
+    import m5.objects  # type: ignore
+
+    for name in _CPU_CLASS_NAMES[model]:
+        cls = getattr(m5.objects, name, None)
+        if cls is not None:
+            return cls
+    raise ValueError(f"gem5 binary has no CPU class for model {model!r} (tried {_CPU_CLASS_NAMES[model]})")
+
+
+def make_cpu(model: str, o3: Dict[str, int], **kwargs):
+    cpu = cpu_class(model)(**kwargs)
+    if model == "o3":
+        width = o3["width"]
+        cpu.fetchWidth = width
+        cpu.decodeWidth = width
+        cpu.renameWidth = width
+        cpu.dispatchWidth = width
+        cpu.issueWidth = width
+        cpu.wbWidth = width
+        cpu.commitWidth = width
+        cpu.squashWidth = width
+        cpu.numROBEntries = o3["rob_entries"]
+        cpu.numIQEntries = o3["iq_entries"]
+        cpu.LQEntries = o3["lq_entries"]
+        cpu.SQEntries = o3["sq_entries"]
+    return cpu
+
+
+def make_prefetcher(name: str) -> Optional[object]:
+    if name == "none":
+        return None
+
+    import m5.objects  # type: ignore
+
+    return getattr(m5.objects, PREFETCHER_CLASSES[name])()
+
+
+def attach_prefetcher(cache, name: str) -> None:
+    prefetcher = make_prefetcher(name)
+    if prefetcher is not None:
+        cache.prefetcher = prefetcher
+
+
+_FREQ_UNITS = (("ghz", 1_000_000_000), ("mhz", 1_000_000), ("khz", 1_000), ("hz", 1))
+
+
+def _freq_hz(text: str) -> int:
+    lowered = text.strip().lower()
+    for suffix, scale in _FREQ_UNITS:
+        if lowered.endswith(suffix):
+            return int(float(lowered[: -len(suffix)]) * scale)
+    raise ValueError(f"frequency needs a Hz/kHz/MHz/GHz suffix: {text!r}")
+
+
+def parse_opp_table(value: str, option: str) -> List[Dict[str, str]]:
+    """Parse `1GHz:1.0V,800MHz:0.9V` into operating points, fastest first.
+
+    gem5 numbers perf levels from the fastest clock, so the table must be in
+    strictly decreasing frequency order.
+    """
+    points: List[Dict[str, str]] = []
+    for item in value.split(","):
+        clock, sep, voltage = item.strip().partition(":")
+        if not sep or not voltage.strip().lower().endswith("v"):
+            raise ValueError(f"{option}: expected <freq>:<voltage>V entries, got {item!r}")
+        points.append({"clock": clock.strip(), "voltage": voltage.strip()})
+    freqs = [_freq_hz(point["clock"]) for point in points]
+    if any(later >= earlier for earlier, later in zip(freqs, freqs[1:])):
+        raise ValueError(f"{option}: operating points must be in decreasing frequency order")
+    return points
+
+
+def add_memory_arguments(
+    p: argparse.ArgumentParser, prefix: str = "", default_type: str = "simple"
+) -> None:
+    p.add_argument(f"--{prefix}mem-type", choices=sorted(MEM_TYPES), default=default_type)
+    p.add_argument(
+        f"--{prefix}mem-channels",
+        type=int,
+        default=1,
+        help="memory channels interleaved across each range (power of two)",
+    )
+    p.add_argument(
+        f"--{prefix}mem-intlv-size",
+        type=int,
+        default=64,
+        help="channel interleaving granularity in bytes (power of two)",
+    )
+
+
+def memory_plan(args: argparse.Namespace, prefix: str = "") -> Dict[str, object]:
+    key = prefix.replace("-", "_")
+    mem_type = getattr(args, f"{key}mem_type")
+    channels = getattr(args, f"{key}mem_channels")
+    intlv_size = getattr(args, f"{key}mem_intlv_size")
+    for name, value in (("mem-channels", channels), ("mem-intlv-size", intlv_size)):
+        if value < 1 or value & (value - 1):
+            raise ValueError(f"--{prefix}{name} must be a power of two, got {value}")
+    return {
+        "type": mem_type,
+        "gem5_class": MEM_TYPES[mem_type],
+        "channels": channels,
+        "intlv_size": intlv_size,
+    }
+
+
+def make_memory_ctrls(
+    plan: Dict[str, object],
+    base: int,
+    size,
+    image: str = "",
+    simple_latency: str = "50ns",
+) -> List[object]:
+    """Controllers covering [base, base+size), interleaved over plan channels.
+
+    Memory images are written through the owning controller only, so a range
+    that carries an image file must stay on a single channel.
+    """
+    import m5.objects  # type: ignore
+    from m5.objects import AddrRange, MemCtrl, SimpleMemory  # type: ignore
+
+    channels = int(plan["channels"])
+    if image and channels > 1:
+        raise ValueError(f"range 0x{base:x} loads {image}; image ranges cannot be interleaved")
+
+    intlv_bits = channels.bit_length() - 1
+    intlv_low_bit = int(plan["intlv_size"]).bit_length() - 1
+    ctrls = []
+    for match in range(channels):
+        if channels > 1:
+            addr_range = AddrRange(
+                base,
+                size=size,
+                intlvHighBit=intlv_low_bit + intlv_bits - 1,
+                xorHighBit=0,
+                intlvBits=intlv_bits,
+                intlvMatch=match,
+            )
+        else:
+            addr_range = AddrRange(start=base, size=size)
+
+        if plan["type"] == "simple":
+            mem = SimpleMemory(range=addr_range, latency=simple_latency)
+            if image:
+                mem.image_file = image
+            ctrls.append(mem)
+            continue
+
+        dram = getattr(m5.objects, str(plan["gem5_class"]))(range=addr_range)
+        if image:
+            dram.image_file = image
+        ctrls.append(MemCtrl(dram=dram))
+    return ctrls
+
+
+def add_shared_region_arguments(p: argparse.ArgumentParser) -> None:
+    p.add_argument(
+        "--shared-mem",
+        choices=["dram", "sram"],
+        default="dram",
+        help="backing of the shared IPC segment: main memory, or an on-chip SRAM scratchpad",
+    )
+    p.add_argument(
+        "--shared-cacheable",
+        choices=["on", "off"],
+        default="on",
+        help="off adds the shared segment to the PMAChecker uncacheable ranges",
+    )
+    p.add_argument("--sram-latency", default="2ns", help="scratchpad access latency per bank")
+    p.add_argument("--sram-bandwidth", default="32GiB/s", help="scratchpad bandwidth per bank")
+    p.add_argument("--sram-banks", type=int, default=4, help="scratchpad banks (power of two)")
+    p.add_argument("--sram-bank-intlv", type=int, default=64, help="bank interleaving in bytes (power of two)")
+
+
+def shared_region_plan(args: argparse.Namespace) -> Dict[str, object]:
+    plan: Dict[str, object] = {
+        "backing": args.shared_mem,
+        "cacheable": args.shared_cacheable == "on",
+    }
+    if args.shared_mem == "sram":
+        for name, value in (("sram-banks", args.sram_banks), ("sram-bank-intlv", args.sram_bank_intlv)):
+            if value < 1 or value & (value - 1):
+                raise ValueError(f"--{name} must be a power of two, got {value}")
+        plan.update(
+            latency=args.sram_latency,
+            bandwidth=args.sram_bandwidth,
+            banks=args.sram_banks,
+            bank_intlv=args.sram_bank_intlv,
+        )
+    return plan
+
+
+def make_scratchpad(plan: Dict[str, object], base: int, size) -> Tuple[object, List[object]]:
+    """SRAM banks for [base, base+size) behind their own non-coherent xbar.
+
+    Returns (xbar, banks); the caller connects xbar.cpu_side_ports to the
+    crossbar both clusters share. Banks are SimpleMemory instances so the
+    bank latency/bandwidth, not a DRAM timing model, bound the access cost.
+    """
+    from m5.objects import NoncoherentXBar  # type: ignore
+
+    bank_plan = {
+        "type": "simple",
+        "gem5_class": "SimpleMemory",
+        "channels": plan["banks"],
+        "intlv_size": plan["bank_intlv"],
+    }
+    banks = make_memory_ctrls(bank_plan, base, size, simple_latency=str(plan["latency"]))
+    xbar = NoncoherentXBar(width=16, frontend_latency=1, forward_latency=0, response_latency=1)
+    for bank in banks:
+        bank.bandwidth = plan["bandwidth"]
+        bank.latency_var = "0ns"
+        bank.port = xbar.mem_side_ports
+    return xbar, banks
+
+
+def add_xbar_arguments(p: argparse.ArgumentParser, prefix: str = "") -> None:
+    for bus, coherent in XBAR_BUSES.items():
+        p.add_argument(
+            f"--{prefix}{bus}-width",
+            type=int,
+            default=None,
+            help=f"{bus} data path width in bytes (default: gem5 class default)",
+        )
+        for latency in XBAR_LATENCIES:
+            if latency == "snoop-response" and not coherent:
+                continue
+            p.add_argument(
+                f"--{prefix}{bus}-{latency}-latency",
+                type=int,
+                default=None,
+                help=f"{bus} {latency} latency in cycles (default: gem5 class default)",
+            )
+
+
+def xbar_plan(args: argparse.Namespace, prefix: str = "") -> Dict[str, Dict[str, int]]:
+    """Per-bus crossbar overrides as gem5 parameter names; unset ones are omitted."""
+    key = prefix.replace("-", "_")
+    plan: Dict[str, Dict[str, int]] = {}
+    for bus, coherent in XBAR_BUSES.items():
+        params: Dict[str, int] = {}
+        width = getattr(args, f"{key}{bus}_width")
+        if width is not None:
+            if width < 1:
+                raise ValueError(f"--{prefix}{bus}-width must be positive, got {width}")
+            params["width"] = width
+        for latency in XBAR_LATENCIES:
+            if latency == "snoop-response" and not coherent:
+                continue
+            param = latency.replace("-", "_") + "_latency"
+            value = getattr(args, f"{key}{bus}_{param}")
+            if value is None:
+                continue
+            if value < 0:
+                raise ValueError(f"--{prefix}{bus}-{latency}-latency must be >= 0, got {value}")
+            params[param] = value
+        plan[bus] = params
+    return plan
+
+
+def configure_xbar(xbar, params: Dict[str, int]):
+    for name, value in params.items():
+        setattr(xbar, name, value)
+    return xbar
+
+
+def make_comm_monitor(downstream):
+    """CommMonitor whose mem side is already bound to `downstream`.
+
+    The caller connects the upstream mem_side to monitor.cpu_side_port; the
+    monitor's latency/bandwidth histograms then cover everything past it.
+    """
+    from m5.objects import CommMonitor  # type: ignore
+
+    monitor = CommMonitor()
+    monitor.mem_side_port = downstream
+    return monitor
+
+
+# --mem-trace capture modes for conf/mem_replay.py: packet traces of every
+# cluster's L1 -> L2 requests (MemTraceProbe, gem5 built with protobuf) or
+# elastic traces of each O3 hart (ElasticTrace, replayed by TraceCPU).
+MEM_TRACE_MODES = ("off", "packet", "elastic")
+MEM_TRACE_SIDECAR = "mem_trace.json"
+
+
+def add_mem_trace_arguments(p: argparse.ArgumentParser) -> None:
+    p.add_argument(
+        "--mem-trace",
+        choices=MEM_TRACE_MODES,
+        default="off",
+        help="record L1->L2 packet traces per cluster or elastic traces per O3 hart for conf/mem_replay.py "
+        f"(listed in <outdir>/{MEM_TRACE_SIDECAR})",
+    )
+
+
+def make_trace_monitor(downstream, trace_file: str):
+    """make_comm_monitor plus a MemTraceProbe writing each request it sees to <outdir>/<trace_file>."""
+    from m5.objects import MemTraceProbe  # type: ignore
+
+    monitor = make_comm_monitor(downstream)
+    monitor.trace = MemTraceProbe(trace_file=trace_file)
+    return monitor
+
+
+def mem_trace_file(outdir: str, name: str) -> str:
+    """Trace name as written in outdir (MemTraceProbe may add .gz when compressing)."""
+    from pathlib import Path
+
+    for candidate in (name, name + ".gz"):
+        if (Path(outdir) / candidate).exists():
+            return candidate
+    return name
+
+
+def attach_elastic_trace(cpu, prefix: str) -> Tuple[str, str]:
+    """ElasticTrace probe on an O3 CPU; returns the (fetch, data) trace names in the outdir.
+
+    As in gem5's own etrace configs, ROB/LQ/SQ grow during capture so their
+    stalls are not baked into the trace as compute delay; TraceCPU models
+    the real sizes on replay.
+    """
+    from m5.objects import ElasticTrace  # type: ignore
+
+    fetch, data = f"{prefix}.fetch.proto.gz", f"{prefix}.data.proto.gz"
+    cpu.traceListener = ElasticTrace(
+        instFetchTraceFile=fetch,
+        dataDepTraceFile=data,
+        depWindowSize=3 * cpu.numROBEntries,
+    )
+    cpu.numROBEntries = 512
+    cpu.LQEntries = 128
+    cpu.SQEntries = 128
+    return fetch, data
+
+
+# --tick-terminal value -> (text_ticks, binary_ticks) of OmxTickTerminal.
+TICK_TERMINAL_FORMATS = {
+    "off": None,
+    "text": (True, False),
+    "binary": (False, True),
+    "both": (True, True),
+}
+
+
+def add_tick_terminal_arguments(p: argparse.ArgumentParser) -> None:
+    p.add_argument(
+        "--tick-terminal",
+        choices=list(TICK_TERMINAL_FORMATS),
+        default="off",
+        help="replace each Terminal with an OmxTickTerminal that stamps console lines with their tick "
+        "(<terminal>.ticks text, .ticks.bin binary; gem5 built with EXTRAS=gem5_ext, no telnet input)",
+    )
+
+
+def make_terminal(fmt: str, port: int = 3456, number: int = 0):
+    """Terminal, or an OmxTickTerminal capture device for --tick-terminal text|binary|both."""
+    import m5.objects  # type: ignore
+
+    stamps = TICK_TERMINAL_FORMATS[fmt]
+    if stamps is None:
+        return m5.objects.Terminal(port=port, number=number)
+    if not hasattr(m5.objects, "OmxTickTerminal"):
+        raise ValueError("--tick-terminal needs a gem5 binary built with EXTRAS=gem5_ext (OmxTickTerminal)")
+    return m5.objects.OmxTickTerminal(text_ticks=stamps[0], binary_ticks=stamps[1])
+
+
+def replace_platform_terminal(platform, fmt: str) -> None:
+    """Swap HiFive's UART0 Terminal for an OmxTickTerminal (no-op for --tick-terminal off)."""
+    if TICK_TERMINAL_FORMATS[fmt] is None:
+        return
+    platform.terminal = make_terminal(fmt)
+    platform.uart.device = platform.terminal
+
+
+# Ticks of the dumps simulate_in_slices makes, one per line, so readers can tell
+# them from guest m5 dumpstats dumps (scripts/run_gem5.py blk_metrics).
+PERIODIC_DUMPS = "periodic_dumps.txt"
+
+
+def add_stats_period_arguments(p: argparse.ArgumentParser) -> None:
+    p.add_argument(
+        "--stats-period",
+        type=int,
+        default=0,
+        help="dump cumulative stats every N ticks for the time series of scripts/stats_series.py (0 = off)",
+    )
+
+
+def simulate_in_slices(max_ticks: int, period: int):
+    """m5.simulate up to max_ticks; with period > 0, in slices with a cumulative stats dump after each.
+
+    The dumps never reset the stats, so the final one still covers the whole
+    run and end-of-run parsers read the last block. Any exit other than a
+    slice boundary (workload exit, TrafficGen EXIT state) is returned as is.
+    Each dump's tick is appended to <outdir>/PERIODIC_DUMPS.
+    """
+    import os
+
+    import m5  # type: ignore
+
+    if period <= 0:
+        return m5.simulate(max_ticks)
+    log = os.path.join(m5.options.outdir, PERIODIC_DUMPS)
+    open(log, "w").close()
+    while True:
+        exit_event = m5.simulate(min(period, max_ticks - m5.curTick()))
+        if exit_event.getCause() != "simulate() limit reached" or m5.curTick() >= max_ticks:
+            return exit_event
+        m5.stats.dump()
+        with open(log, "a") as fp:
+            fp.write(f"{m5.curTick()}\n")
+
+
+# --stats-profile globs over full stat names ("system.l2.overallMisses"; vector and
+# histogram entries follow their stat). minimal holds what the run manifests'
+# checks and the dashboard summary read; series adds scripts/stats_series.py's inputs.
+STATS_GLOBALS = ("sim*", "finalTick", "host*")
+STATS_PROFILES = {
+    "full": None,
+    "minimal": STATS_GLOBALS,
+    "series": STATS_GLOBALS
+    + ("*.numCycles", "*.numInsts", "*.committedInsts", "*.overallMisses", "*Layer*.occupancy"),
+}
+STATS_FORMATS = ("text", "json")
+STATS_JSON = "stats.jsonl"
+
+
+def add_stats_profile_arguments(p: argparse.ArgumentParser) -> None:
+    p.add_argument(
+        "--stats-profile",
+        choices=list(STATS_PROFILES),
+        default="full",
+        help="stats kept at each dump: full, minimal (summary and checks) or series (minimal + stats_series.py)",
+    )
+    p.add_argument("--stats-include", default="", help="comma-separated globs kept on top of --stats-profile")
+    p.add_argument("--stats-exclude", default="", help="comma-separated globs dropped from the selection")
+    p.add_argument(
+        "--stats-format",
+        choices=STATS_FORMATS,
+        default="text",
+        help=f"text: gem5's stats.txt; json: one compact JSON line per dump in <outdir>/{STATS_JSON} "
+        "instead (scalars, vectors, 2-D vectors and histogram buckets)",
+    )
+
+
+def stats_profile_plan(args: argparse.Namespace, keep: Sequence[str] = ()) -> Dict[str, object]:
+    """Selected globs; include None keeps every stat. keep: what the target's own checks parse."""
+    include = STATS_PROFILES[args.stats_profile]
+    extra = [glob for glob in args.stats_include.split(",") if glob.strip()]
+    if include is not None:
+        include = [*include, *keep, *extra]
+    return {
+        "profile": args.stats_profile,
+        "format": args.stats_format,
+        "include": include,
+        "exclude": [glob for glob in args.stats_exclude.split(",") if glob.strip()],
+    }
+
+
+def _stats_selector(plan: Dict[str, object]):
+    """Name -> kept, memoised: every dump visits the same stat names."""
+    import fnmatch
+    import re
+
+    def pattern(globs: Sequence[str]):
+        return re.compile("|".join(fnmatch.translate(glob.strip()) for glob in globs)) if globs else None
+
+    include = None if plan["include"] is None else pattern(plan["include"])
+    exclude = pattern(plan["exclude"])
+    cache: Dict[str, bool] = {}
+
+    def selected(name: str) -> bool:
+        if name not in cache:
+            cache[name] = (
+                (plan["include"] is None or bool(include and include.match(name)))
+                and not (exclude and exclude.match(name))
+            )
+        return cache[name]
+
+    return selected
+
+
+class JsonStatsOutput:
+    """m5.stats output writing each dump as one JSON line of {name: value}."""
+
+    def __init__(self, path: str):
+        self.path = path
+        self.values: Dict[str, object] = {}
+        open(path, "w").close()
+
+    def valid(self) -> bool:
+        return True
+
+    def begin(self) -> None:
+        self.values = {}
+
+    def beginGroup(self, name: str) -> None:  # noqa: N802 - m5.stats visitor interface
+        pass
+
+    def endGroup(self) -> None:  # noqa: N802 - m5.stats visitor interface
+        pass
+
+    def add(self, name: str, info) -> None:
+        import math
+
+        import _m5.stats  # type: ignore
+
+        def put(key: str, value) -> None:
+            value = float(value)
+            self.values[key] = int(value) if value.is_integer() else (value if math.isfinite(value) else None)
+
+        def sub(names, index: int) -> str:
+            return names[index] if index < len(names) and names[index] else str(index)
+
+        if isinstance(info, _m5.stats.ScalarInfo):
+            put(name, info.value)
+        elif isinstance(info, _m5.stats.DistInfo):
+            buckets = list(info.values)
+            samples = sum(buckets) + info.underflow + info.overflow
+            put(f"{name}::samples", samples)
+            put(f"{name}::mean", info.sum / samples if samples else 0.0)
+            put(f"{name}::underflows", info.underflow)
+            put(f"{name}::overflows", info.overflow)
+            size = info.bucket_size
+            for index, count in enumerate(buckets):
+                low = info.min_val + index * size
+                put(f"{name}::{low:g}-{low + size - 1:g}" if size > 1 else f"{name}::{low:g}", count)
+        elif isinstance(info, (_m5.stats.VectorInfo, _m5.stats.FormulaInfo)):
+            subnames = list(info.subnames)
+            for index, value in enumerate(info.value):
+                put(f"{name}::{sub(subnames, index)}", value)
+            put(f"{name}::total", info.total)
+        elif isinstance(info, _m5.stats.Vector2dInfo):
+            # value is row-major x_size * y_size; rows and columns keep their subnames.
+            xnames, ynames = list(info.x_subnames), list(info.y_subnames)
+            values = list(info.value)
+            for x in range(info.x_size):
+                row = values[x * info.y_size:(x + 1) * info.y_size]
+                for y, value in enumerate(row):
+                    put(f"{name}::{sub(xnames, x)}::{sub(ynames, y)}", value)
+                put(f"{name}::{sub(xnames, x)}::total", sum(row))
+            put(f"{name}::total", sum(values))
+
+    @staticmethod
+    def encodes(info) -> bool:
+        """add() writes info; sparse histograms and vector distributions have no Python view."""
+        import _m5.stats  # type: ignore
+
+        return isinstance(
+            info,
+            (
+                _m5.stats.ScalarInfo,
+                _m5.stats.DistInfo,
+                _m5.stats.VectorInfo,
+                _m5.stats.FormulaInfo,
+                _m5.stats.Vector2dInfo,
+            ),
+        )
+
+    def end(self) -> None:
+        import json
+
+        import m5  # type: ignore
+
+        with open(self.path, "a") as fp:
+            fp.write(json.dumps({"tick": m5.curTick(), "stats": self.values}, separators=(",", ":")) + "\n")
+
+
+def apply_stats_profile(plan: Dict[str, object], outdir: str) -> None:
+    """Filter every stats dump (periodic, guest m5 dumpstats, exit) by plan; json replaces stats.txt.
+
+    Wraps m5.stats._dump_to_visitor (gem5 v22+), which walks the stat groups
+    for each registered output: unselected stats are skipped before any
+    formatting or file I/O, which is where a full text dump spends its time.
+    """
+    if plan["include"] is None and not plan["exclude"] and plan["format"] == "text":
+        return
+    import os
+
+    import m5.stats  # type: ignore
+    from m5.objects import Root  # type: ignore
+
+    if not hasattr(m5.stats, "_dump_to_visitor"):
+        raise ValueError("--stats-profile/--stats-format need m5.stats._dump_to_visitor (gem5 v22 or newer)")
+    selected = _stats_selector(plan)
+
+    def dump_to_visitor(visitor, roots=None):
+        def emit(stat, name: str) -> None:
+            if not selected(name):
+                return
+            if isinstance(visitor, JsonStatsOutput):
+                visitor.add(name, stat)
+            else:
+                stat.visit(visitor)
+
+        def visit(group, path: str) -> None:
+            for stat in group.getStats():
+                emit(stat, path + stat.name)
+            for child, sub in group.getStatGroups().items():
+                visitor.beginGroup(child)
+                visit(sub, f"{path}{child}.")
+                visitor.endGroup()
+
+        # m5.stats.dump() passes roots=[] unless extra roots were registered; as upstream,
+        # an empty list means the legacy globals (simInsts, hostInstRate, ...) plus Root.
+        if not roots:
+            for stat in getattr(m5.stats, "stats_list", []):
+                emit(stat, stat.name)
+        for root in roots or [Root.getInstance()]:
+            if root is None:
+                continue
+            prefix = root.path_list()
+            for name in prefix:
+                visitor.beginGroup(name)
+            visit(root, "".join(f"{name}." for name in prefix))
+            for _ in prefix:
+                visitor.endGroup()
+
+    m5.stats._dump_to_visitor = dump_to_visitor
+    if plan["format"] == "json":
+        m5.stats.outputList[:] = [JsonStatsOutput(os.path.join(outdir, STATS_JSON))]
+        _refuse_unencodable_stats(selected)
+
+
+def _refuse_unencodable_stats(selected) -> None:
+    """Fail at m5.instantiate (where gem5 enables stats) if json would have to drop a selected stat."""
+    import m5.stats  # type: ignore
+    from m5.objects import Root  # type: ignore
+
+    enable = m5.stats.enable
+
+    def walk(group, path: str):
+        for stat in group.getStats():
+            yield path + stat.name, stat
+        for child, sub in group.getStatGroups().items():
+            yield from walk(sub, f"{path}{child}.")
+
+    def checked_enable() -> None:
+        enable()
+        root = Root.getInstance()
+        stats = [(stat.name, stat) for stat in getattr(m5.stats, "stats_list", [])]
+        if root is not None:
+            stats += walk(root, "".join(f"{name}." for name in root.path_list()))
+        dropped = [name for name, stat in stats if selected(name) and not JsonStatsOutput.encodes(stat)]
+        if dropped:
+            raise ValueError(
+                f"--stats-format json cannot encode {', '.join(dropped[:5])}"
+                + (f" and {len(dropped) - 5} more" if len(dropped) > 5 else "")
+                + "; drop them with --stats-exclude or use --stats-format text"
+            )
+
+    m5.stats.enable = checked_enable
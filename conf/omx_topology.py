@@ -0,0 +1,304 @@
+"""Cluster/hart topology descriptions for the rv32 mixed platform.
+
+A description (conf/topology/*.json) lists clusters, harts per cluster, the
+AMP/SMP mode and the memory segments. `derive_topology` expands it into the
+per-image view every consumer shares: conf/riscv32_mixed.py (gem5 objects),
+scripts/gen_topology.py (boot jump table, memory map, Zephyr overlays) and
+scripts/run_gem5.py (workload assignments and markers).
+
+Images: an AMP cluster runs one Zephyr image per hart, an SMP cluster one
+image across all its harts. Image i owns UART i and sync slot i.
+
+Boot: scripts/riscv32_mixed_boot.S reads one boot table row per hart
+(entry, stack, a0, a1, flags, release mtime). A cluster's optional `boot`
+block sets the release policy of its harts:
+
+  "boot": {"delay": 0, "stagger": 0, "hold": false, "a1": 0}
+
+delay/stagger (CLINT mtime ticks): the n-th hart of the cluster waits until
+mtime >= delay + n * stagger. hold: the hart then waits in WFI until another
+hart writes a non-zero word to release_base + 4 * hartid and raises its
+CLINT MSIP. The release words and per-hart stacks sit at the top of the boot
+segment.
+"""
+
+import json
+import struct
+from pathlib import Path
+from typing import Dict, List, Optional
+
+CLUSTER_MODES = ("amp", "smp")
+
+# Image 0 uses the HiFive UART; images 1-2 keep the original mixed-platform
+# addresses, later ones move above the 0x10004000-0x10008fff device window.
+_LEGACY_UART_BASES = (0x10000000, 0x10001000, 0x10002000)
+_EXTRA_UART_BASE = 0x10010000
+MAX_IMAGES = 32  # one bit per image in the ROLE_SYNC ready mask
+
+CLINT_BASE = 0x02000000  # HiFive CLINT: msip, mtimecmp and mtime
+BOOT_RELEASE_SIZE = 0x1000  # release words, top page of the boot segment
+BOOT_STACK_SIZE = 0x400  # per-hart trampoline stack, below the release words
+BOOT_CODE_SIZE = 0x10000  # kept free for the trampoline at the segment base
+BOOT_FLAG_HOLD = 1
+BOOT_FLAG_DELAY = 2
+
+# Linux<->Zephyr window of conf/riscv_hybrid.py --hybrid-shm (rv32 view):
+# uncached, just above the default shared segment. memory.hybrid_shm
+# ({base, size, responder}) overrides it; the responder image gets it in
+# its overlay.
+HYBRID_SHM_BASE = 0xA0000000
+HYBRID_SHM_SIZE = 0x00100000
+HYBRID_SHM_RESPONDER = "cluster0_amp_cpu1"
+# OmxDvfsCtrl MMIO block of conf/riscv32_mixed.py --dvfs. memory.dvfs_ctrl
+# ({base}) overrides it; each domain-owning image gets it in its overlay.
+DVFS_CTRL_BASE = 0x10004000
+
+
+def _int(value) -> int:
+    return value if isinstance(value, int) else int(str(value), 0)
+
+
+def _align_up(value: int, align: int) -> int:
+    return (value + align - 1) // align * align
+
+
+def uart_base(index: int) -> int:
+    if index < len(_LEGACY_UART_BASES):
+        return _LEGACY_UART_BASES[index]
+    return _EXTRA_UART_BASE + 0x1000 * (index - len(_LEGACY_UART_BASES))
+
+
+def elf_entry(path: Path) -> Optional[int]:
+    """e_entry of a little-endian ELF32/ELF64 file, None if unreadable."""
+    try:
+        header = Path(path).read_bytes()[:0x20]
+    except OSError:
+        return None
+    if len(header) < 0x20 or header[:4] != b"\x7fELF" or header[5] != 1:
+        return None
+    if header[4] == 1:
+        return struct.unpack_from("<I", header, 0x18)[0]
+    return struct.unpack_from("<Q", header, 0x18)[0]
+
+
+def load_topology(path: str) -> Dict[str, object]:
+    desc = json.loads(Path(path).read_text(encoding="utf-8"))
+    desc.setdefault("name", Path(path).stem)
+    desc["source"] = str(path)
+    return desc
+
+
+def _image_names(cluster: Dict[str, object], harts: List[int]) -> List[Dict[str, object]]:
+    name = str(cluster["name"])
+    if cluster["mode"] == "amp":
+        return [
+            {
+                "name": f"{name}_amp_cpu{hart}",
+                "role": f"{name}-amp-cpu{hart}",
+                "marker_role": f"AMP CPU{hart}",
+                "harts": [hart],
+            }
+            for hart in harts
+        ]
+    return [
+        {
+            "name": f"{name}_smp",
+            "role": f"{name}-smp",
+            "marker_role": f"{name.upper()} SMP",
+            "harts": list(harts),
+        }
+    ]
+
+
+def derive_topology(desc: Dict[str, object]) -> Dict[str, object]:
+    """Expand a description into clusters, images, segments and boot table.
+
+    Image bases (and sizes) come from `image_bases`/`image_sizes` when a
+    cluster lists them, otherwise images of `image_size` are packed upwards
+    from memory.images_base, each aligned to its own size.
+    """
+    memory = desc["memory"]
+    boot = {"base": _int(memory["boot"]["base"]), "size": _int(memory["boot"]["size"])}
+    shared = {"base": _int(memory["shared"]["base"]), "size": _int(memory["shared"]["size"])}
+    cursor = _int(memory.get("images_base", boot["base"] + boot["size"]))
+
+    clusters: List[Dict[str, object]] = []
+    images: List[Dict[str, object]] = []
+    next_hart = 0
+    for idx, cluster in enumerate(desc["clusters"]):
+        mode = str(cluster.get("mode", "smp")).lower()
+        if mode not in CLUSTER_MODES:
+            raise ValueError(f"cluster {cluster.get('name')!r}: mode must be amp or smp, got {mode!r}")
+        count = int(cluster["harts"])
+        if count < 1:
+            raise ValueError(f"cluster {cluster.get('name')!r}: needs at least one hart")
+        harts = list(range(next_hart, next_hart + count))
+        next_hart += count
+        cluster = dict(cluster, mode=mode, name=str(cluster.get("name", f"cluster{idx}")))
+
+        cluster_images = _image_names(cluster, harts)
+        bases = [_int(base) for base in cluster.get("image_bases", [])]
+        sizes = [_int(size) for size in cluster.get("image_sizes", [])]
+        for key, values in (("image_bases", bases), ("image_sizes", sizes)):
+            if values and len(values) != len(cluster_images):
+                raise ValueError(
+                    f"cluster {cluster['name']!r}: {key} lists {len(values)} entries "
+                    f"for {len(cluster_images)} images"
+                )
+        for pos, image in enumerate(cluster_images):
+            size = sizes[pos] if sizes else _int(cluster["image_size"])
+            if bases:
+                base = bases[pos]
+            else:
+                base = _align_up(cursor, size)
+                cursor = base + size
+            image.update(
+                index=len(images),
+                cluster=cluster["name"],
+                cluster_index=idx,
+                mode=mode,
+                boot_hart=image["harts"][0],
+                base=base,
+                size=size,
+                # The first image of a cluster drives that cluster's DVFS domain.
+                dvfs_domain=idx if pos == 0 else None,
+            )
+            images.append(image)
+
+        clusters.append(
+            {
+                "name": cluster["name"],
+                "index": idx,
+                "mode": mode,
+                "harts": harts,
+                "l2_size": cluster.get("l2_size"),
+                "opp": cluster.get("opp"),
+                "images": [image["name"] for image in cluster_images],
+            }
+        )
+
+    if len(images) > MAX_IMAGES:
+        raise ValueError(f"topology has {len(images)} images; at most {MAX_IMAGES} are supported")
+
+    for image in images:
+        image["uart_index"] = image["index"]
+        image["uart_base"] = uart_base(image["index"])
+        image["uart_policy"] = f"uart{image['index']}" + ("-shared" if image["mode"] == "smp" else "")
+
+    segments = [{"name": "boot", "base": boot["base"], "size": boot["size"], "image": None}]
+    segments += [
+        {"name": image["name"], "base": image["base"], "size": image["size"], "image": image["name"]}
+        for image in images
+    ]
+    segments.append({"name": "shared", "base": shared["base"], "size": shared["size"], "image": None})
+    ordered = sorted(segments, key=lambda seg: seg["base"])
+    for lower, upper in zip(ordered, ordered[1:]):
+        if lower["base"] + lower["size"] > upper["base"]:
+            raise ValueError(f"memory segments {lower['name']} and {upper['name']} overlap")
+    if ordered[-1]["base"] + ordered[-1]["size"] > 1 << 32:
+        raise ValueError(f"segment {ordered[-1]['name']} ends above the 32-bit address space")
+
+    shm = memory.get("hybrid_shm", {})
+    hybrid_shm = {
+        "base": _int(shm.get("base", HYBRID_SHM_BASE)),
+        "size": _int(shm.get("size", HYBRID_SHM_SIZE)),
+        "responder": shm.get("responder", HYBRID_SHM_RESPONDER),
+    }
+    if hybrid_shm["responder"] not in {image["name"] for image in images}:
+        hybrid_shm["responder"] = None
+    for seg in segments:
+        if seg["base"] < hybrid_shm["base"] + hybrid_shm["size"] and hybrid_shm["base"] < seg["base"] + seg["size"]:
+            raise ValueError(f"hybrid_shm window overlaps memory segment {seg['name']}")
+    if hybrid_shm["base"] + hybrid_shm["size"] > 1 << 32:
+        raise ValueError("hybrid_shm window ends above the 32-bit address space")
+
+    dvfs_ctrl = {"base": _int(memory.get("dvfs_ctrl", {}).get("base", DVFS_CTRL_BASE))}
+
+    release_base = boot["base"] + boot["size"] - BOOT_RELEASE_SIZE
+    if next_hart * 4 > BOOT_RELEASE_SIZE or release_base - next_hart * BOOT_STACK_SIZE < (
+        boot["base"] + BOOT_CODE_SIZE
+    ):
+        raise ValueError(f"boot segment too small for {next_hart} harts")
+    boot.update(
+        clint_base=CLINT_BASE,
+        release_base=release_base,
+        stack_size=BOOT_STACK_SIZE,
+    )
+
+    hart_image = {hart: image for image in images for hart in image["harts"]}
+    boot_table: List[Dict[str, object]] = []
+    for cluster, source in zip(clusters, desc["clusters"]):
+        policy = source.get("boot", {})
+        delay = _int(policy.get("delay", 0))
+        stagger = _int(policy.get("stagger", 0))
+        for pos, hart in enumerate(cluster["harts"]):
+            release_mtime = delay + pos * stagger
+            # The trampoline compares against the low word of mtime only.
+            if not 0 <= release_mtime < 1 << 32:
+                raise ValueError(f"cluster {cluster['name']!r}: hart {hart} release mtime out of range")
+            boot_table.append(
+                {
+                    "hart": hart,
+                    "cluster": cluster["name"],
+                    "image": hart_image[hart]["name"],
+                    "entry": hart_image[hart]["base"],
+                    "stack": release_base - hart * BOOT_STACK_SIZE,
+                    "a0": hart,
+                    "a1": _int(policy.get("a1", 0)),
+                    "hold": bool(policy.get("hold", False)),
+                    "release_mtime": release_mtime,
+                }
+            )
+
+    return {
+        "name": desc.get("name", "custom"),
+        "source": desc.get("source"),
+        "num_harts": next_hart,
+        "clusters": clusters,
+        "images": images,
+        "memory_segments": segments,
+        "boot": boot,
+        "boot_table": boot_table,
+        "hybrid_shm": hybrid_shm,
+        "dvfs_ctrl": dvfs_ctrl,
+        "sync": {
+            "base": shared["base"],
+            "ready_mask": (1 << len(images)) - 1,
+            # The last image waits for every other image's ready signature.
+            "master": images[-1]["name"],
+        },
+    }
+
+
+def boot_flags(row: Dict[str, object]) -> int:
+    return (BOOT_FLAG_HOLD if row["hold"] else 0) | (BOOT_FLAG_DELAY if _int(row["release_mtime"]) else 0)
+
+
+def apply_elf_entries(topology: Dict[str, object]) -> None:
+    """Point every image (and its boot table rows) at its ELF entry when built.
+
+    Images need an `elf` path; unbuilt ones keep their segment base.
+    """
+    entries: Dict[str, int] = {}
+    for image in topology["images"]:
+        entry = elf_entry(Path(str(image["elf"])))
+        image["entry_source"] = "elf" if entry is not None else "segment_base"
+        image["entry"] = entry if entry is not None else int(image["base"])
+        entries[str(image["name"])] = int(image["entry"])
+    for row in topology["boot_table"]:
+        row["entry"] = entries[str(row["image"])]
+
+
+def hart_clusters(topology: Dict[str, object]) -> List[int]:
+    """Cluster index of every hart, indexed by hart id."""
+    out: List[int] = []
+    for cluster in topology["clusters"]:
+        out.extend(cluster["index"] for _ in cluster["harts"])
+    return out
+
+
+def image_for(topology: Dict[str, object], name: str) -> Optional[Dict[str, object]]:
+    for image in topology["images"]:
+        if image["name"] == name:
+            return image
+    return None
@@ -3,12 +3,33 @@
 
 Goal:
 - one gem5 process
-- six RV32 harts
+- six RV32 harts by default
   - Hart0 -> Zephyr AMP CPU0 image
   - Hart1 -> Zephyr AMP CPU1 image
   - Hart2-5 -> Zephyr SMP image
+- or any N-cluster x M-hart layout from a topology description
+  (`--topology conf/topology/riscv32_4x4.json`, see conf/omx_topology.py)
+- per-cluster CPU model (`--cluster-cpu-types minor,o3`; atomic/timing/minor/o3)
+- per-cluster clock/voltage domains with operating-point tables; `--dvfs`
+  adds the DVFS handler and a guest-visible OmxDvfsCtrl block (gem5_ext/)
 - per-core private L1I/L1D
 - per-cluster shared L2 (cluster0: hart0/1, cluster1: hart2-5)
+- optional per-cluster L1D/L2 prefetchers (`--l1d-prefetcher`, `--l2-prefetcher`)
+- optional LLC shared by both clusters (`--shared-llc`) behind a
+  snoop-filtered crossbar
+- optional SRAM scratchpad for the shared IPC segment (`--shared-mem sram`),
+  cacheable or not per run (`--shared-cacheable on|off`)
+- crossbar width/latency overrides per bus family (`--membus-*`, `--l2bus-*`,
+  `--iobus-*`) and optional CommMonitors between each cluster L2 and the
+  next level (`--comm-monitor`)
+- optional Ruby memory system (`--memory-system ruby-mesi|ruby-chi`):
+  per-cluster routers around one shared directory; the MESI L2 is shared and
+  banked by address rather than private per cluster
+- optional tick-stamped console capture (`--tick-terminal`): every UART
+  backend becomes an OmxTickTerminal (gem5_ext/)
+- optional memory-access trace capture for conf/mem_replay.py
+  (`--mem-trace packet|elastic`): a traced CommMonitor between each
+  cluster's L1 crossbar and its L2, or an ElasticTrace probe per O3 hart
 
 This script supports:
 - plain Python mode (`--print-json`) for dry-run planning
@@ -17,9 +38,51 @@ This script supports:
 
 import argparse
 import json
-from dataclasses import asdict, dataclass
+from dataclasses import asdict, dataclass, field
 from pathlib import Path
-from typing import Dict, List
+from typing import Dict, List, Optional, Tuple
+
+from omx_gem5 import (
+    CPU_MODELS,
+    MEM_TRACE_SIDECAR,
+    MEM_TYPES,
+    add_mem_trace_arguments,
+    add_memory_arguments,
+    add_o3_arguments,
+    add_shared_region_arguments,
+    add_stats_period_arguments,
+    add_stats_profile_arguments,
+    add_tick_terminal_arguments,
+    add_xbar_arguments,
+    apply_stats_profile,
+    attach_elastic_trace,
+    attach_prefetcher,
+    configure_xbar,
+    make_comm_monitor,
+    make_cpu,
+    make_memory_ctrls,
+    make_scratchpad,
+    make_terminal,
+    make_trace_monitor,
+    mem_mode_for,
+    mem_trace_file,
+    memory_plan,
+    o3_params,
+    parse_cluster_spec,
+    parse_opp_table,
+    parse_prefetcher_spec,
+    replace_platform_terminal,
+    shared_region_plan,
+    simulate_in_slices,
+    stats_profile_plan,
+    xbar_plan,
+)
+from omx_topology import apply_elf_entries, derive_topology, hart_clusters, load_topology
+
+DEFAULT_OPP = "1GHz:1.0V,800MHz:0.9V,500MHz:0.8V"
+# What scripts/run_gem5.py mixed_llc_summary and dvfs_summary read, kept under a reduced --stats-profile.
+LLC_STATS = ("system.llc.overall*", "system.llc_bus.snoop*")
+DVFS_STATS = ("system.platform.dvfs_ctrl.*",)
 
 
 @dataclass
@@ -28,6 +91,7 @@ class CacheConfig:
     kind: str
     size: str
     assoc: int
+    prefetcher: str = "none"
 
 
 @dataclass
@@ -40,6 +104,7 @@ class CoreConfig:
     l1i: CacheConfig
     l1d: CacheConfig
     uart: str
+    cpu_model: str = "timing"
 
 
 @dataclass
@@ -49,6 +114,8 @@ class ClusterConfig:
     cores: List[int]
     l2: CacheConfig
     uart: str
+    cpu_model: str = "timing"
+    opp: List[Dict[str, str]] = field(default_factory=list)
 
 
 @dataclass
@@ -59,45 +126,121 @@ class MemorySegment:
     image: str
 
 
+@dataclass
+class ImageConfig:
+    name: str
+    role: str
+    cluster: str
+    mode: str
+    harts: List[int]
+    base: str
+    size: str
+    uart: str
+    elf: str
+
+
 @dataclass
 class WorkloadConfig:
     boot_elf: str
-    amp_cpu0_elf: str
-    amp_cpu1_elf: str
-    smp_elf: str
+    images: Dict[str, str]
+
+
+@dataclass
+class SharedLlcConfig:
+    cache: CacheConfig
+    inclusion: str
+    snoop_filter: bool
+    snoop_filter_size: str
+    snoop_filter_latency: int
+
+
+@dataclass
+class MemorySystemConfig:
+    kind: str
+    protocol: str
+    network: Optional[str]
+    cluster_link_latency: Optional[int]
+    cross_link_latency: Optional[int]
+    router_latency: Optional[int]
 
 
 @dataclass
 class PlatformPlan:
     target: str
     isa: str
-    topology: Dict[str, int]
+    topology: Dict[str, object]
     cores: List[CoreConfig]
     clusters: List[ClusterConfig]
+    images: List[ImageConfig]
+    boot: Dict[str, str]
+    boot_table: List[Dict[str, object]]
     memory_segments: List[MemorySegment]
+    memory: Dict[str, object]
+    shared_region: Dict[str, object]
+    interconnect: Dict[str, object]
+    memory_system: MemorySystemConfig
+    shared_llc: Optional[SharedLlcConfig]
+    o3: Optional[Dict[str, int]]
+    dvfs: Optional[Dict[str, str]]
     workload: WorkloadConfig
+    tick_terminal: str = "off"
+    mem_trace: str = "off"
+    stats_period: int = 0
+    stats: Optional[Dict[str, object]] = None
 
 
-def parser() -> argparse.ArgumentParser:
-    p = argparse.ArgumentParser(
-        description="RV32 mixed AMP/SMP single-gem5 configuration",
-        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
-    )
-    p.add_argument("--boot-elf", default="build/boot/riscv32_mixed_boot.elf")
-    p.add_argument("--amp-cpu0-elf", default="build/zephyr/cluster0_amp_cpu0/zephyr/zephyr.elf")
-    p.add_argument("--amp-cpu1-elf", default="build/zephyr/cluster0_amp_cpu1/zephyr/zephyr.elf")
-    p.add_argument("--smp-elf", default="build/zephyr/cluster1_smp/zephyr/zephyr.elf")
+RUBY_PROTOCOLS = {
+    "ruby-mesi": "MESI_Two_Level",
+    "ruby-chi": "CHI",
+}
 
-    p.add_argument("--num-cpus", type=int, default=6)
-    p.add_argument("--cpu-type", choices=["timing", "atomic"], default="timing")
-    p.add_argument("--max-ticks", type=int, default=2_000_000_000)
 
+def add_layout_arguments(p: argparse.ArgumentParser) -> None:
+    """Cluster, cache, crossbar and memory layout options, shared with conf/traffic_mixed.py."""
+    p.add_argument(
+        "--topology",
+        default="",
+        help="cluster/hart description (conf/topology/*.json); replaces the fixed 2-cluster layout",
+    )
     p.add_argument("--l1i-size", default="16kB")
     p.add_argument("--l1d-size", default="16kB")
     p.add_argument("--l1-assoc", type=int, default=2)
     p.add_argument("--l2-cluster0-size", default="256kB")
-    p.add_argument("--l2-cluster1-size", default="512kB")
+    p.add_argument("--l2-cluster1-size", default="512kB", help="L2 size of cluster1 and later clusters without l2_size")
     p.add_argument("--l2-assoc", type=int, default=8)
+    p.add_argument(
+        "--l1d-prefetcher",
+        default="none",
+        help="none|stride|tagged|bop|ampm, or one name per cluster (e.g. none,stride)",
+    )
+    p.add_argument(
+        "--l2-prefetcher",
+        default="none",
+        help="none|stride|tagged|bop|ampm, or one name per cluster (e.g. none,bop)",
+    )
+    p.add_argument("--shared-llc", action="store_true", help="add an LLC shared by both cluster L2s")
+    p.add_argument("--llc-size", default="2MB")
+    p.add_argument("--llc-assoc", type=int, default=16)
+    p.add_argument(
+        "--llc-inclusion",
+        choices=["inclusive", "exclusive"],
+        default="inclusive",
+        help="LLC clusivity towards the cluster L2s (gem5 mostly_incl/mostly_excl)",
+    )
+    p.add_argument(
+        "--llc-snoop-filter",
+        choices=["on", "off"],
+        default="on",
+        help="snoop filter on the cluster-L2 -> LLC crossbar",
+    )
+    p.add_argument("--snoop-filter-size", default="8MB", help="tracked capacity of the LLC-bus snoop filter")
+    p.add_argument("--snoop-filter-latency", type=int, default=1, help="cycles per snoop filter lookup")
+    add_xbar_arguments(p)
+    p.add_argument(
+        "--comm-monitor",
+        action="store_true",
+        help="insert a CommMonitor between each cluster L2 and the membus/LLC bus (classic only)",
+    )
 
     p.add_argument("--boot-base", default="0x80000000")
     p.add_argument("--boot-size", default="0x01000000")
@@ -109,6 +252,71 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--cluster1-smp-size", default="0x08000000")
     p.add_argument("--shared-base", default="0x90000000")
     p.add_argument("--shared-size", default="0x10000000")
+    # Channels interleave the image-less segments (boot, shared); the Zephyr
+    # image segments stay on one channel each so their images can be loaded.
+    add_memory_arguments(p)
+    add_shared_region_arguments(p)
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="RV32 mixed AMP/SMP single-gem5 configuration",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--boot-elf", default="build/boot/riscv32_mixed_boot.elf")
+    p.add_argument("--amp-cpu0-elf", default="build/zephyr/cluster0_amp_cpu0/zephyr/zephyr.elf")
+    p.add_argument("--amp-cpu1-elf", default="build/zephyr/cluster0_amp_cpu1/zephyr/zephyr.elf")
+    p.add_argument("--smp-elf", default="build/zephyr/cluster1_smp/zephyr/zephyr.elf")
+    p.add_argument(
+        "--image-dir",
+        default="build/zephyr",
+        help="with --topology: Zephyr build root holding <image>/zephyr/zephyr.elf",
+    )
+    add_layout_arguments(p)
+
+    p.add_argument("--num-cpus", type=int, default=0, help="hart count check (0: from the topology)")
+    p.add_argument("--cpu-type", choices=CPU_MODELS, default="timing")
+    p.add_argument(
+        "--cluster-cpu-types",
+        default="",
+        help="per-cluster CPU models overriding --cpu-type, e.g. minor,o3 (cluster0,cluster1)",
+    )
+    add_o3_arguments(p)
+    p.add_argument("--max-ticks", type=int, default=2_000_000_000)
+    add_stats_period_arguments(p)
+    add_stats_profile_arguments(p)
+
+    p.add_argument(
+        "--cluster0-opp",
+        default="",
+        help=f"cluster0 operating points <freq>:<voltage>, fastest first (default: topology opp or {DEFAULT_OPP})",
+    )
+    p.add_argument(
+        "--cluster1-opp",
+        default="",
+        help="cluster1 operating points <freq>:<voltage>, fastest first (perf level 0)",
+    )
+    p.add_argument(
+        "--dvfs",
+        action="store_true",
+        help="enable the DVFS handler and the OmxDvfsCtrl MMIO block (gem5 built with EXTRAS=gem5_ext)",
+    )
+    p.add_argument("--dvfs-transition-latency", default="100us")
+
+    add_mem_trace_arguments(p)
+    add_tick_terminal_arguments(p)
+
+    p.add_argument(
+        "--memory-system",
+        choices=["classic", *RUBY_PROTOCOLS],
+        default="classic",
+        help="classic caches/xbars, or a Ruby protocol (needs a matching PROTOCOL= gem5 build)",
+    )
+    p.add_argument("--ruby-network", choices=["simple", "garnet"], default="simple")
+    p.add_argument("--ruby-clock", default="1GHz")
+    p.add_argument("--ruby-cluster-link-latency", type=int, default=1, help="cycles, controller <-> router")
+    p.add_argument("--ruby-cross-link-latency", type=int, default=4, help="cycles, cluster router <-> directory")
+    p.add_argument("--ruby-router-latency", type=int, default=1, help="cycles per router hop")
 
     p.add_argument("--print-json", action="store_true")
     return p
@@ -118,96 +326,279 @@ def _to_int(value: str) -> int:
     return int(value, 0)
 
 
+def _default_description(args: argparse.Namespace) -> Dict[str, object]:
+    """The fixed two-cluster layout, built from the per-segment options."""
+    return {
+        "name": "riscv32_mixed",
+        "source": "command line",
+        "clusters": [
+            {
+                "name": "cluster0",
+                "mode": "amp",
+                "harts": 2,
+                "l2_size": args.l2_cluster0_size,
+                "image_bases": [args.amp_cpu0_base, args.amp_cpu1_base],
+                "image_sizes": [args.amp_cpu0_size, args.amp_cpu1_size],
+            },
+            {
+                "name": "cluster1",
+                "mode": "smp",
+                "harts": 4,
+                "l2_size": args.l2_cluster1_size,
+                "image_bases": [args.cluster1_smp_base],
+                "image_sizes": [args.cluster1_smp_size],
+            },
+        ],
+        "memory": {
+            "boot": {"base": args.boot_base, "size": args.boot_size},
+            "shared": {"base": args.shared_base, "size": args.shared_size},
+        },
+    }
+
+
+def layout_topology(args: argparse.Namespace) -> Dict[str, object]:
+    """Derived topology of the add_layout_arguments options, before any ELF is attached."""
+    if args.topology:
+        desc = load_topology(args.topology)
+        # The boot and shared segments stay on the command line so the
+        # shared-region options keep working across topologies.
+        desc.setdefault("memory", {})
+        desc["memory"]["boot"] = {"base": args.boot_base, "size": args.boot_size}
+        desc["memory"]["shared"] = {"base": args.shared_base, "size": args.shared_size}
+    else:
+        desc = _default_description(args)
+    return derive_topology(desc)
+
+
+def _topology(args: argparse.Namespace) -> Dict[str, object]:
+    topology = layout_topology(args)
+
+    legacy_elfs = {
+        "cluster0_amp_cpu0": args.amp_cpu0_elf,
+        "cluster0_amp_cpu1": args.amp_cpu1_elf,
+        "cluster1_smp": args.smp_elf,
+    }
+    for image in topology["images"]:
+        if args.topology:
+            image["elf"] = str(Path(args.image_dir) / str(image["name"]) / "zephyr" / "zephyr.elf")
+        else:
+            image["elf"] = legacy_elfs[str(image["name"])]
+    apply_elf_entries(topology)
+    return topology
+
+
+def _cluster_names(topology: Dict[str, object]) -> List[str]:
+    return [str(cluster["name"]) for cluster in topology["clusters"]]
+
+
+def _cluster_prefetchers(args: argparse.Namespace, topology: Dict[str, object]) -> Tuple[List[str], List[str]]:
+    names = _cluster_names(topology)
+    return (
+        parse_prefetcher_spec(args.l1d_prefetcher, names, "--l1d-prefetcher"),
+        parse_prefetcher_spec(args.l2_prefetcher, names, "--l2-prefetcher"),
+    )
+
+
+def _cluster_cpu_models(args: argparse.Namespace, topology: Dict[str, object]) -> List[str]:
+    return parse_cluster_spec(
+        args.cluster_cpu_types or args.cpu_type, _cluster_names(topology), "--cluster-cpu-types", CPU_MODELS
+    )
+
+
+def _cluster_opps(args: argparse.Namespace, topology: Dict[str, object]) -> List[List[Dict[str, str]]]:
+    """Per-cluster OPP tables: --clusterN-opp, then the topology, then DEFAULT_OPP."""
+    overrides = {0: args.cluster0_opp, 1: args.cluster1_opp}
+    opps = []
+    for cluster in topology["clusters"]:
+        idx = int(cluster["index"])
+        value = overrides.get(idx) or cluster.get("opp") or DEFAULT_OPP
+        opps.append(parse_opp_table(str(value), f"cluster{idx} opp"))
+    return opps
+
+
+def _cluster_l2_size(args: argparse.Namespace, cluster: Dict[str, object]) -> str:
+    if cluster.get("l2_size"):
+        return str(cluster["l2_size"])
+    return args.l2_cluster0_size if cluster["index"] == 0 else args.l2_cluster1_size
+
+
+def _segment_elf(topology: Dict[str, object], segment: Dict[str, object]) -> str:
+    for image in topology["images"]:
+        if image["name"] == segment["image"]:
+            return str(image["elf"])
+    return ""
+
+
+def _uart_summary(cluster: Dict[str, object], images: List[Dict[str, object]]) -> str:
+    own = [image for image in images if image["cluster"] == cluster["name"]]
+    if cluster["mode"] == "amp":
+        return " + ".join(f"UART{image['uart_index']}/CPU{image['harts'][0]}" for image in own)
+    harts = cluster["harts"]
+    return f"UART{own[0]['uart_index']} shared by CPU{harts[0]}-{harts[-1]}"
+
+
 def build_plan(args: argparse.Namespace) -> PlatformPlan:
+    topology = _topology(args)
+    l1d_pf, l2_pf = _cluster_prefetchers(args, topology)
+    cpu_models = _cluster_cpu_models(args, topology)
+    opps = _cluster_opps(args, topology)
     l1i = CacheConfig(level="L1I", kind="private", size=args.l1i_size, assoc=args.l1_assoc)
-    l1d = CacheConfig(level="L1D", kind="private", size=args.l1d_size, assoc=args.l1_assoc)
-    l2_cluster0 = CacheConfig(level="L2", kind="unified", size=args.l2_cluster0_size, assoc=args.l2_assoc)
-    l2_cluster1 = CacheConfig(level="L2", kind="unified", size=args.l2_cluster1_size, assoc=args.l2_assoc)
-
-    cores: List[CoreConfig] = [
-        CoreConfig(
-            cpu_id=0,
-            isa="rv32",
-            cluster="cluster0",
-            mode="AMP",
-            entry=args.amp_cpu0_base,
-            l1i=l1i,
-            l1d=l1d,
-            uart="UART0",
-        ),
-        CoreConfig(
-            cpu_id=1,
-            isa="rv32",
-            cluster="cluster0",
-            mode="AMP",
-            entry=args.amp_cpu1_base,
-            l1i=l1i,
-            l1d=l1d,
-            uart="UART1",
-        ),
-    ]
-    for cpu_id in [2, 3, 4, 5]:
-        cores.append(
-            CoreConfig(
-                cpu_id=cpu_id,
-                isa="rv32",
-                cluster="cluster1",
-                mode="SMP",
-                entry=args.cluster1_smp_base,
-                l1i=l1i,
-                l1d=l1d,
-                uart="UART2",
+    images = topology["images"]
+    image_of_hart = {hart: image for image in images for hart in image["harts"]}
+
+    cores: List[CoreConfig] = []
+    clusters: List[ClusterConfig] = []
+    for cluster in topology["clusters"]:
+        idx = int(cluster["index"])
+        l1d = CacheConfig(
+            level="L1D", kind="private", size=args.l1d_size, assoc=args.l1_assoc, prefetcher=l1d_pf[idx]
+        )
+        for hart in cluster["harts"]:
+            image = image_of_hart[hart]
+            cores.append(
+                CoreConfig(
+                    cpu_id=hart,
+                    isa="rv32",
+                    cluster=str(cluster["name"]),
+                    mode=str(cluster["mode"]).upper(),
+                    entry=f"0x{int(image['entry']):08x}",
+                    l1i=l1i,
+                    l1d=l1d,
+                    uart=f"UART{image['uart_index']}",
+                    cpu_model=cpu_models[idx],
+                )
+            )
+        clusters.append(
+            ClusterConfig(
+                name=str(cluster["name"]),
+                mode=str(cluster["mode"]).upper(),
+                cores=list(cluster["harts"]),
+                l2=CacheConfig(
+                    level="L2",
+                    kind="unified",
+                    size=_cluster_l2_size(args, cluster),
+                    assoc=args.l2_assoc,
+                    prefetcher=l2_pf[idx],
+                ),
+                uart=_uart_summary(cluster, images),
+                cpu_model=cpu_models[idx],
+                opp=opps[idx],
             )
         )
 
-    clusters = [
-        ClusterConfig(
-            name="cluster0",
-            mode="AMP",
-            cores=[0, 1],
-            l2=l2_cluster0,
-            uart="UART0/CPU0 + UART1/CPU1",
-        ),
-        ClusterConfig(
-            name="cluster1",
-            mode="SMP",
-            cores=[2, 3, 4, 5],
-            l2=l2_cluster1,
-            uart="UART2 shared by CPU2-5",
-        ),
+    image_configs = [
+        ImageConfig(
+            name=str(image["name"]),
+            role=str(image["role"]),
+            cluster=str(image["cluster"]),
+            mode=str(image["mode"]).upper(),
+            harts=list(image["harts"]),
+            base=f"0x{int(image['base']):08x}",
+            size=f"0x{int(image['size']):08x}",
+            uart=f"UART{image['uart_index']}@0x{int(image['uart_base']):08x}",
+            elf=str(image["elf"]),
+        )
+        for image in images
     ]
-
     memory_segments = [
-        MemorySegment(name="boot", base=args.boot_base, size=args.boot_size, image=""),
-        MemorySegment(name="amp_cpu0", base=args.amp_cpu0_base, size=args.amp_cpu0_size, image=args.amp_cpu0_elf),
-        MemorySegment(name="amp_cpu1", base=args.amp_cpu1_base, size=args.amp_cpu1_size, image=args.amp_cpu1_elf),
         MemorySegment(
-            name="cluster1_smp",
-            base=args.cluster1_smp_base,
-            size=args.cluster1_smp_size,
-            image=args.smp_elf,
-        ),
-        MemorySegment(name="shared", base=args.shared_base, size=args.shared_size, image=""),
+            name=str(segment["name"]),
+            base=f"0x{int(segment['base']):08x}",
+            size=f"0x{int(segment['size']):08x}",
+            image=_segment_elf(topology, segment),
+        )
+        for segment in topology["memory_segments"]
     ]
 
+    if args.memory_system == "classic":
+        memory_system = MemorySystemConfig(
+            kind="classic",
+            protocol="classic",
+            network=None,
+            cluster_link_latency=None,
+            cross_link_latency=None,
+            router_latency=None,
+        )
+    else:
+        # Ruby has no per-cluster L2 size: MESI_Two_Level banks one L2 shared by every
+        # cluster and CHI gives each CPU a private L2, both at --l2-cluster1-size.
+        if args.l2_cluster0_size != parser().get_default("l2_cluster0_size"):
+            raise ValueError(
+                f"--memory-system {args.memory_system} sizes every L2 bank with --l2-cluster1-size; "
+                "--l2-cluster0-size needs --memory-system classic"
+            )
+        memory_system = MemorySystemConfig(
+            kind="ruby",
+            protocol=RUBY_PROTOCOLS[args.memory_system],
+            network=args.ruby_network,
+            cluster_link_latency=args.ruby_cluster_link_latency,
+            cross_link_latency=args.ruby_cross_link_latency,
+            router_latency=args.ruby_router_latency,
+        )
+
+    shared_llc: Optional[SharedLlcConfig] = None
+    if args.shared_llc:
+        shared_llc = SharedLlcConfig(
+            cache=CacheConfig(level="LLC", kind="shared", size=args.llc_size, assoc=args.llc_assoc),
+            inclusion=args.llc_inclusion,
+            snoop_filter=args.llc_snoop_filter == "on",
+            snoop_filter_size=args.snoop_filter_size,
+            snoop_filter_latency=args.snoop_filter_latency,
+        )
+
     workload = WorkloadConfig(
         boot_elf=args.boot_elf,
-        amp_cpu0_elf=args.amp_cpu0_elf,
-        amp_cpu1_elf=args.amp_cpu1_elf,
-        smp_elf=args.smp_elf,
+        images={str(image["name"]): str(image["elf"]) for image in images},
     )
 
     return PlatformPlan(
         target="riscv32_mixed",
         isa="rv32",
-        topology={"clusters": 2, "cores": 6},
+        topology={
+            "name": topology["name"],
+            "source": topology["source"],
+            "clusters": len(clusters),
+            "cores": topology["num_harts"],
+            "sync_ready_mask": f"0x{int(topology['sync']['ready_mask']):x}",
+            "sync_master": topology["sync"]["master"],
+        },
         cores=cores,
         clusters=clusters,
+        images=image_configs,
+        boot={key: f"0x{int(value):08x}" for key, value in topology["boot"].items()},
+        boot_table=[
+            dict(row, **{key: f"0x{int(row[key]):08x}" for key in ("entry", "stack", "a1")})
+            for row in topology["boot_table"]
+        ],
         memory_segments=memory_segments,
+        memory=memory_plan(args),
+        shared_region=shared_region_plan(args),
+        interconnect={"xbars": xbar_plan(args), "comm_monitor": args.comm_monitor},
+        memory_system=memory_system,
+        shared_llc=shared_llc,
+        o3=o3_params(args) if "o3" in cpu_models else None,
+        dvfs=(
+            {
+                # From the topology, so the generated overlays agree with the device.
+                "ctrl_base": f"0x{int(topology['dvfs_ctrl']['base']):08x}",
+                "transition_latency": args.dvfs_transition_latency,
+                "domains": ",".join(f"{name}={idx}" for idx, name in enumerate(_cluster_names(topology))),
+            }
+            if args.dvfs
+            else None
+        ),
         workload=workload,
+        tick_terminal=args.tick_terminal,
+        mem_trace=args.mem_trace,
+        stats_period=args.stats_period,
+        stats=_stats_plan(args),
     )
 
 
+def _stats_plan(args: argparse.Namespace) -> dict:
+    return stats_profile_plan(args, (LLC_STATS if args.shared_llc else ()) + (DVFS_STATS if args.dvfs else ()))
+
+
 def _has_gem5_runtime() -> bool:
     try:
         import m5  # noqa: F401
@@ -216,64 +607,421 @@ def _has_gem5_runtime() -> bool:
     return True
 
 
+def _mixed_segments(topology: Dict[str, object]) -> List[Tuple[str, int, int, str]]:
+    return [
+        (str(segment["name"]), int(segment["base"]), int(segment["size"]), _segment_elf(topology, segment))
+        for segment in topology["memory_segments"]
+    ]
+
+
+def _attach_shared_llc(args: argparse.Namespace, system):
+    """Insert a shared LLC between the cluster L2s and the membus.
+
+    Returns the port the cluster L2s should connect their mem_side to. The
+    crossbar in front of the LLC carries every cross-cluster snoop, so its
+    snoop filter stats (system.llc_bus.snoop_filter.*) are the cross-cluster
+    coherence counters.
+    """
+    from m5.objects import L2XBar, NULL, SnoopFilter  # type: ignore
+    from common.Caches import L2Cache  # type: ignore
+
+    system.llc_bus = configure_xbar(L2XBar(), xbar_plan(args)["l2bus"])
+    if args.llc_snoop_filter == "on":
+        system.llc_bus.snoop_filter = SnoopFilter(
+            lookup_latency=args.snoop_filter_latency,
+            max_capacity=args.snoop_filter_size,
+        )
+    else:
+        system.llc_bus.snoop_filter = NULL
+
+    system.llc = L2Cache(
+        size=args.llc_size,
+        assoc=args.llc_assoc,
+        tag_latency=30,
+        data_latency=30,
+        response_latency=30,
+        mshrs=32,
+        tgts_per_mshr=12,
+        clusivity="mostly_excl" if args.llc_inclusion == "exclusive" else "mostly_incl",
+    )
+    system.llc.cpu_side = system.llc_bus.mem_side_ports
+    system.llc.mem_side = system.membus.cpu_side_ports
+    return system.llc_bus.cpu_side_ports
+
+
+def attach_cluster_l2s(
+    args: argparse.Namespace, system, topology: Dict[str, object], trace_l1: bool = False
+) -> List[object]:
+    """Per-cluster L1 crossbar and L2 down to the membus (or the shared LLC).
+
+    Returns the cluster crossbars, in cluster order, whose cpu_side_ports take
+    the cluster's L1s. `trace_l1` puts the --mem-trace packet monitor between
+    each crossbar and its L2.
+    """
+    from m5.objects import L2XBar  # type: ignore
+    from m5.util import addToPath  # type: ignore
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common.Caches import L2Cache  # type: ignore
+
+    _, l2_pf = _cluster_prefetchers(args, topology)
+    l2bus_params = xbar_plan(args)["l2bus"]
+    l2_downstream = _attach_shared_llc(args, system) if args.shared_llc else system.membus.cpu_side_ports
+    # An exclusive LLC only fills on L2 evictions, so clean lines must be
+    # written back too.
+    writeback_clean = args.shared_llc and args.llc_inclusion == "exclusive"
+
+    cluster_buses = []
+    for cluster in topology["clusters"]:
+        idx = int(cluster["index"])
+        bus = configure_xbar(L2XBar(), l2bus_params)
+        l2 = L2Cache(size=_cluster_l2_size(args, cluster), assoc=args.l2_assoc, writeback_clean=writeback_clean)
+        attach_prefetcher(l2, l2_pf[idx])
+        setattr(system, f"cluster{idx}_bus", bus)
+        setattr(system, f"cluster{idx}_l2", l2)
+        if trace_l1:
+            # Every L1 (and walker) request of the cluster, as the L2 sees it.
+            l1_monitor = make_trace_monitor(l2.cpu_side, f"cluster{idx}_l1l2.trc.gz")
+            setattr(system, f"cluster{idx}_l1_monitor", l1_monitor)
+            bus.mem_side_ports = l1_monitor.cpu_side_port
+        else:
+            l2.cpu_side = bus.mem_side_ports
+        if args.comm_monitor:
+            # stats: system.cluster<N>_monitor.{read,write}{Latency,Bandwidth}Hist
+            monitor = make_comm_monitor(l2_downstream)
+            setattr(system, f"cluster{idx}_monitor", monitor)
+            l2.mem_side = monitor.cpu_side_port
+        else:
+            l2.mem_side = l2_downstream
+        cluster_buses.append(bus)
+    return cluster_buses
+
+
+def _attach_classic_memory_system(args: argparse.Namespace, system, topology: Dict[str, object]) -> None:
+    from m5.util import addToPath  # type: ignore
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common.Caches import L1_DCache, L1_ICache  # type: ignore
+
+    l1d_pf, _ = _cluster_prefetchers(args, topology)
+    cluster_buses = attach_cluster_l2s(args, system, topology, trace_l1=args.mem_trace == "packet")
+
+    hart_cluster = hart_clusters(topology)
+    for i, cpu in enumerate(system.cpu):
+        l1i = L1_ICache(size=args.l1i_size, assoc=args.l1_assoc)
+        l1d = L1_DCache(size=args.l1d_size, assoc=args.l1_assoc)
+        attach_prefetcher(l1d, l1d_pf[hart_cluster[i]])
+        setattr(cpu, "l1i", l1i)
+        setattr(cpu, "l1d", l1d)
+        l1i.cpu_side = cpu.icache_port
+        l1d.cpu_side = cpu.dcache_port
+
+        cluster_bus = cluster_buses[hart_cluster[i]]
+        l1i.mem_side = cluster_bus.cpu_side_ports
+        l1d.mem_side = cluster_bus.cpu_side_ports
+        cpu.mmu.connectWalkerPorts(cluster_bus.cpu_side_ports, cluster_bus.cpu_side_ports)
+
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
+
+
+def _write_mem_trace_sidecar(
+    args: argparse.Namespace,
+    topology: Dict[str, object],
+    segments: List[Tuple[str, int, int, str]],
+    cpu_models: List[str],
+    elastic_traces: List[Tuple[int, str, str]],
+    tick: int,
+) -> None:
+    """<outdir>/mem_trace.json: what conf/mem_replay.py needs to rebuild the memory side."""
+    import m5  # type: ignore
+
+    outdir = m5.options.outdir
+    hart_cluster = hart_clusters(topology)
+    sidecar = {
+        "kind": "omx-mem-trace",
+        "mode": args.mem_trace,
+        "source": "riscv32_mixed",
+        "topology": topology["name"],
+        "sim_ticks": tick,
+        "memory_ranges": [{"name": name, "base": base, "size": size} for name, base, size, _ in segments],
+        "capture": {
+            "l1i_size": args.l1i_size,
+            "l1d_size": args.l1d_size,
+            "l1_assoc": args.l1_assoc,
+            "l2_assoc": args.l2_assoc,
+            "memory": memory_plan(args),
+            "o3": o3_params(args),
+        },
+        "clusters": [
+            {
+                "index": int(cluster["index"]),
+                "name": cluster["name"],
+                "harts": [i for i, owner in enumerate(hart_cluster) if owner == int(cluster["index"])],
+                "cpu_model": cpu_models[int(cluster["index"])],
+                "l2_size": _cluster_l2_size(args, cluster),
+                "packet_trace": (
+                    mem_trace_file(outdir, f"cluster{int(cluster['index'])}_l1l2.trc.gz")
+                    if args.mem_trace == "packet"
+                    else None
+                ),
+            }
+            for cluster in topology["clusters"]
+        ],
+        "harts": [
+            {
+                "cpu_id": cpu_id,
+                "cluster": hart_cluster[cpu_id],
+                "fetch_trace": mem_trace_file(outdir, fetch),
+                "data_trace": mem_trace_file(outdir, data),
+            }
+            for cpu_id, fetch, data in elastic_traces
+        ],
+    }
+    path = Path(outdir) / MEM_TRACE_SIDECAR
+    path.write_text(json.dumps(sidecar, indent=2) + "\n", encoding="utf-8")
+    print(f"[INFO] mem trace: {path}")
+
+
+def _ruby_protocol_built(protocol: str) -> bool:
+    from m5.defines import buildEnv  # type: ignore
+
+    if buildEnv.get("PROTOCOL") == protocol:
+        return True
+    # Multi-protocol builds expose one flag per compiled protocol.
+    return bool(buildEnv.get(f"RUBY_PROTOCOL_{protocol.upper()}"))
+
+
+def _ruby_cluster_topology(args: argparse.Namespace, topology: Dict[str, object]):
+    """One router per cluster, all hanging off one directory router.
+
+    Per-CPU controllers (anything with a sequencer) join the router of the
+    cluster owning that CPU, and so do CHI private L2s (the downstream of
+    exactly one CPU's L1s). MESI L2 banks join the router of the cluster with
+    the same index, and directory/DMA/home nodes join the central router.
+    The MESI L2 is one cache banked by address across the clusters, not a
+    private L2 per cluster, so about half of each cluster's L1 misses cross
+    the central router to the other cluster's bank.
+    """
+    from topologies.BaseTopology import SimpleTopology  # type: ignore
+
+    hart_cluster = hart_clusters(topology)
+    num_clusters = len(topology["clusters"])
+
+    class MixedClusterTopology(SimpleTopology):
+        description = "riscv32_mixed per-cluster topology"
+
+        def _private_owners(self) -> Dict[int, int]:
+            """id(controller) -> hart for controllers below exactly one CPU's L1s."""
+            harts: Dict[int, set] = {}
+            for node in self.nodes:
+                hart = self._hart_of(node)
+                if hart is None:
+                    continue
+                for dest in getattr(node, "downstream_destinations", []):
+                    if not getattr(dest, "is_HN", False):
+                        harts.setdefault(id(dest), set()).add(hart)
+            return {node: next(iter(owners)) for node, owners in harts.items() if len(owners) == 1}
+
+        @staticmethod
+        def _hart_of(node) -> Optional[int]:
+            sequencer = getattr(node, "sequencer", None)
+            if sequencer is not None and hasattr(sequencer, "version"):
+                return int(sequencer.version)
+            return None
+
+        def _router_for(self, node, private: Dict[int, int]) -> int:
+            hart = self._hart_of(node)
+            if hart is None:
+                hart = private.get(id(node))
+            if hart is not None:
+                return hart_cluster[hart]
+            if node.type == "L2Cache_Controller":
+                return min(int(node.version), num_clusters - 1)
+            # Directory, DMA and home nodes: the central router.
+            return num_clusters
+
+        def makeTopology(self, options, network, IntLink, ExtLink, Router):
+            routers = [
+                Router(router_id=i, latency=args.ruby_router_latency) for i in range(num_clusters + 1)
+            ]
+            network.routers = routers
+
+            private = self._private_owners()
+            ext_links = []
+            for link_id, node in enumerate(self.nodes):
+                ext_links.append(
+                    ExtLink(
+                        link_id=link_id,
+                        ext_node=node,
+                        int_node=routers[self._router_for(node, private)],
+                        latency=args.ruby_cluster_link_latency,
+                    )
+                )
+            network.ext_links = ext_links
+
+            int_links = []
+            link_id = len(ext_links)
+            central = routers[num_clusters]
+            for cluster in range(num_clusters):
+                for src, dst in ((routers[cluster], central), (central, routers[cluster])):
+                    int_links.append(
+                        IntLink(
+                            link_id=link_id,
+                            src_node=src,
+                            dst_node=dst,
+                            latency=args.ruby_cross_link_latency,
+                            weight=1,
+                        )
+                    )
+                    link_id += 1
+            network.int_links = int_links
+
+    return MixedClusterTopology
+
+
+def _attach_ruby_memory_system(args: argparse.Namespace, system, topology: Dict[str, object]) -> None:
+    import importlib
+
+    from m5.objects import SimpleMemory, SrcClockDomain  # type: ignore
+    from m5.util import addToPath  # type: ignore
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common import Options  # type: ignore
+    from ruby import Ruby  # type: ignore
+
+    protocol = RUBY_PROTOCOLS[args.memory_system]
+    if not _ruby_protocol_built(protocol):
+        raise ValueError(
+            f"--memory-system {args.memory_system} needs a gem5 binary built with "
+            f"PROTOCOL={protocol}"
+        )
+
+    ruby_parser = argparse.ArgumentParser()
+    Options.addCommonOptions(ruby_parser)
+    Ruby.define_options(ruby_parser)
+    opts = ruby_parser.parse_args([])
+    opts.ruby = True
+    opts.num_cpus = int(topology["num_harts"])
+    opts.num_dirs = 1
+    # One L2 bank per cluster; MESI_Two_Level selects banks by address bits.
+    num_clusters = len(topology["clusters"])
+    if num_clusters & (num_clusters - 1):
+        raise ValueError(f"Ruby memory systems need a power-of-two cluster count, got {num_clusters}")
+    opts.num_l2caches = num_clusters
+    opts.num_l3caches = 1
+    opts.l1i_size = args.l1i_size
+    opts.l1d_size = args.l1d_size
+    opts.l1i_assoc = args.l1_assoc
+    opts.l1d_assoc = args.l1_assoc
+    # MESI_Two_Level banks one shared L2 across the clusters and CHI adds a
+    # private L2 per CPU; build_plan rejects a separate cluster0 size.
+    opts.l2_size = args.l2_cluster1_size
+    opts.l2_assoc = args.l2_assoc
+    opts.cacheline_size = 64
+    opts.mem_type = MEM_TYPES[args.mem_type]
+    opts.network = args.ruby_network
+    opts.ruby_clock = args.ruby_clock
+
+    # The protocol modules bind create_topology at import time; point the
+    # selected one at the cluster-aware topology.
+    topology_cls = _ruby_cluster_topology(args, topology)
+    protocol_module = importlib.import_module(f"ruby.{protocol}")
+    protocol_module.create_topology = lambda controllers, _options: topology_cls(controllers)
+
+    Ruby.create_system(opts, True, system, piobus=system.iobus)
+    system.ruby.clk_domain = SrcClockDomain(clock=args.ruby_clock, voltage_domain=system.voltage_domain)
+
+    for i, cpu in enumerate(system.cpu):
+        ruby_port = system.ruby._cpu_ports[i]
+        cpu.icache_port = ruby_port.in_ports
+        cpu.dcache_port = ruby_port.in_ports
+        cpu.mmu.connectWalkerPorts(ruby_port.in_ports, ruby_port.in_ports)
+
+    images = {base: image for _, base, _, image in _mixed_segments(topology) if image}
+    for ctrl in system.mem_ctrls:
+        mem = getattr(ctrl, "dram", ctrl)
+        if isinstance(mem, SimpleMemory):
+            mem.latency = "50ns"
+        image = images.get(int(mem.range.start))
+        if image:
+            mem.image_file = image
+
+
 def _run_gem5_runtime(args: argparse.Namespace) -> int:
     import m5  # type: ignore
     from m5.objects import (  # type: ignore
         AddrRange,
-        AtomicSimpleCPU,
         Bridge,
         Frequency,
         HiFive,
         IOXBar,
-        L2XBar,
         PMAChecker,
         RiscvBareMetal,
         RiscvRTC,
         RiscvSystem,
         SystemXBar,
-        Terminal,
         Root,
-        SimpleMemory,
         SrcClockDomain,
-        TimingSimpleCPU,
         Uart8250,
         VoltageDomain,
     )
-    from m5.util import addToPath  # type: ignore
 
-    repo_root = Path(__file__).resolve().parents[1]
-    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
-    from common.Caches import L1_DCache, L1_ICache, L2Cache  # type: ignore
-
-    if args.num_cpus != 6:
-        raise ValueError("--num-cpus must be 6 for riscv32_mixed")
-
-    required = [args.boot_elf, args.amp_cpu0_elf, args.amp_cpu1_elf, args.smp_elf]
+    topology = _topology(args)
+    num_cpus = int(topology["num_harts"])
+    if args.num_cpus and args.num_cpus != num_cpus:
+        raise ValueError(f"--num-cpus {args.num_cpus} does not match topology {topology['name']} ({num_cpus} harts)")
+    hart_cluster = hart_clusters(topology)
+    images = topology["images"]
+
+    cpu_models = _cluster_cpu_models(args, topology)
+    mem_mode = mem_mode_for(cpu_models)
+    use_ruby = args.memory_system != "classic"
+    if use_ruby and mem_mode != "timing":
+        raise ValueError(f"--memory-system {args.memory_system} requires timing-mode CPUs (timing/minor/o3)")
+    if use_ruby and args.shared_llc:
+        raise ValueError("--shared-llc is a classic-cache option; Ruby protocols bring their own L2/L3")
+    shared_region = shared_region_plan(args)
+    if use_ruby and (shared_region["backing"] == "sram" or not shared_region["cacheable"]):
+        raise ValueError("--shared-mem sram / --shared-cacheable off need the classic memory system")
+    if use_ruby and (args.l1d_prefetcher != "none" or args.l2_prefetcher != "none"):
+        raise ValueError("--l1d-prefetcher/--l2-prefetcher apply to classic caches only")
+    xbars = xbar_plan(args)
+    if use_ruby and (args.comm_monitor or xbars["membus"] or xbars["l2bus"]):
+        raise ValueError("--comm-monitor and --membus-*/--l2bus-* need the classic memory system")
+    if use_ruby and args.mem_trace == "packet":
+        raise ValueError("--mem-trace packet needs the classic memory system (cluster L1 crossbars)")
+    if args.mem_trace == "elastic" and "o3" not in cpu_models:
+        raise ValueError("--mem-trace elastic needs at least one o3 cluster (--cluster-cpu-types)")
+
+    required = [args.boot_elf, *(str(image["elf"]) for image in images)]
     for f in required:
         if not Path(f).exists():
             raise FileNotFoundError(f"missing file: {f}")
 
-    cpu_cls = TimingSimpleCPU if args.cpu_type == "timing" else AtomicSimpleCPU
-
-    segments = [
-        ("boot", _to_int(args.boot_base), _to_int(args.boot_size), ""),
-        ("amp_cpu0", _to_int(args.amp_cpu0_base), _to_int(args.amp_cpu0_size), args.amp_cpu0_elf),
-        ("amp_cpu1", _to_int(args.amp_cpu1_base), _to_int(args.amp_cpu1_size), args.amp_cpu1_elf),
-        (
-            "cluster1_smp",
-            _to_int(args.cluster1_smp_base),
-            _to_int(args.cluster1_smp_size),
-            args.smp_elf,
-        ),
-        ("shared", _to_int(args.shared_base), _to_int(args.shared_size), ""),
-    ]
+    segments = _mixed_segments(topology)
+    mem_plan = memory_plan(args)
+    if use_ruby and int(mem_plan["channels"]) > 1:
+        raise ValueError("--mem-channels applies to the classic memory system only")
 
-    memories = []
+    mem_ctrls = []
     for name, base, size, image in segments:
-        mem = SimpleMemory(range=AddrRange(start=base, size=size), latency="50ns")
-        if image:
-            mem.image_file = image
-        memories.append(mem)
+        if name == "shared" and shared_region["backing"] == "sram":
+            print(
+                "[INFO] memory",
+                f"name={name}",
+                f"base=0x{base:08x}",
+                f"size=0x{size:08x}",
+                f"sram_banks={shared_region['banks']}",
+                f"sram_latency={shared_region['latency']}",
+            )
+            continue
+        if not use_ruby:
+            seg_plan = dict(mem_plan, channels=1) if image else mem_plan
+            mem_ctrls.extend(make_memory_ctrls(seg_plan, base, size, image=image))
         print(
             "[INFO] memory",
             f"name={name}",
@@ -282,46 +1030,71 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
             f"image={image or '-'}",
         )
 
-    system = RiscvSystem(memories=memories)
-    system.mem_mode = "timing" if args.cpu_type == "timing" else "atomic"
+    system = RiscvSystem()
+    # Ruby builds its own directory-side memory controllers.
+    if mem_ctrls:
+        system.mem_ctrls = mem_ctrls
+    system.mem_mode = mem_mode
     system.mem_ranges = [AddrRange(start=base, size=size) for _, base, size, _ in segments]
     system.cache_line_size = 64
 
     system.voltage_domain = VoltageDomain(voltage="1.0V")
     system.clk_domain = SrcClockDomain(clock="1GHz", voltage_domain=system.voltage_domain)
-    system.cpu_voltage_domain = VoltageDomain()
-    system.cpu_clk_domain = SrcClockDomain(clock="1GHz", voltage_domain=system.cpu_voltage_domain)
+    # One clock/voltage domain per cluster; domain_id doubles as the
+    # OmxDvfsCtrl domain index the guest selects.
+    cluster_clk_domains = []
+    for idx, opp in enumerate(_cluster_opps(args, topology)):
+        voltage_domain = VoltageDomain(voltage=[point["voltage"] for point in opp])
+        clk_domain = SrcClockDomain(
+            clock=[point["clock"] for point in opp],
+            voltage_domain=voltage_domain,
+            domain_id=idx,
+            init_perf_level=0,
+        )
+        setattr(system, f"cluster{idx}_voltage_domain", voltage_domain)
+        setattr(system, f"cluster{idx}_clk_domain", clk_domain)
+        cluster_clk_domains.append(clk_domain)
 
-    system.iobus = IOXBar()
-    system.membus = SystemXBar()
-    system.system_port = system.membus.cpu_side_ports
+    if args.dvfs:
+        system.dvfs_handler.domains = cluster_clk_domains
+        system.dvfs_handler.enable = True
+        system.dvfs_handler.transition_latency = args.dvfs_transition_latency
+
+    system.iobus = configure_xbar(IOXBar(), xbars["iobus"])
+    if not use_ruby:
+        system.membus = configure_xbar(SystemXBar(), xbars["membus"])
+        system.system_port = system.membus.cpu_side_ports
 
     system.platform = HiFive()
     system.platform.rtc = RiscvRTC(frequency=Frequency("100MHz"))
     system.platform.clint.int_pin = system.platform.rtc.int_pin
-    system.platform.setNumCores(args.num_cpus)
+    system.platform.setNumCores(num_cpus)
 
-    # UART topology:
+    # UART topology: image i owns UART i (omx_topology.uart_base). Default:
     # - UART0 (0x10000000): Zephyr RTOS Instance 0 (CPU0 AMP)
     # - UART1 (0x10001000): Zephyr RTOS Instance 1 (CPU1 AMP)
     # - UART2 (0x10002000): Zephyr RTOS Instance 2 (CPU2-5 SMP)
-    system.platform.terminal1 = Terminal(port=3457, number=1)
-    system.platform.terminal2 = Terminal(port=3458, number=2)
+    replace_platform_terminal(system.platform, args.tick_terminal)
     system.platform.uart.device = system.platform.terminal
-    system.platform.uart1 = Uart8250(
-        pio_addr=0x10001000,
-        platform=system.platform,
-        device=system.platform.terminal1,
-    )
-    system.platform.uart2 = Uart8250(
-        pio_addr=0x10002000,
-        platform=system.platform,
-        device=system.platform.terminal2,
-    )
-    extra_uart_ranges = [
-        AddrRange(system.platform.uart1.pio_addr, size=system.platform.uart1.pio_size),
-        AddrRange(system.platform.uart2.pio_addr, size=system.platform.uart2.pio_size),
-    ]
+    extra_uarts = []
+    for image in images[1:]:
+        idx = int(image["uart_index"])
+        terminal = make_terminal(args.tick_terminal, port=3456 + idx, number=idx)
+        uart = Uart8250(pio_addr=int(image["uart_base"]), platform=system.platform, device=terminal)
+        setattr(system.platform, f"terminal{idx}", terminal)
+        setattr(system.platform, f"uart{idx}", uart)
+        extra_uarts.append(uart)
+    extra_io_ranges = [AddrRange(uart.pio_addr, size=uart.pio_size) for uart in extra_uarts]
+    if args.dvfs:
+        if not hasattr(m5.objects, "OmxDvfsCtrl"):
+            raise ValueError("--dvfs needs a gem5 binary built with EXTRAS=gem5_ext (OmxDvfsCtrl)")
+        system.platform.dvfs_ctrl = m5.objects.OmxDvfsCtrl(
+            pio_addr=int(topology["dvfs_ctrl"]["base"]),
+            dvfs_handler=system.dvfs_handler,
+        )
+        extra_io_ranges.append(
+            AddrRange(system.platform.dvfs_ctrl.pio_addr, size=system.platform.dvfs_ctrl.pio_size)
+        )
 
     system.iobus.cpu_side_ports = system.platform.pci_host.up_request_port()
     system.iobus.mem_side_ports = system.platform.pci_host.up_response_port()
@@ -329,83 +1102,109 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
     system.platform.pci_bus.default = system.platform.pci_host.down_response_port()
     system.platform.pci_bus.config_error_port = system.platform.pci_host.config_error.pio
 
-    system.bridge = Bridge(delay="50ns")
-    system.bridge.mem_side_port = system.iobus.cpu_side_ports
-    system.bridge.cpu_side_port = system.membus.mem_side_ports
-    system.bridge.ranges = [*system.platform._off_chip_ranges(), *extra_uart_ranges]
+    if use_ruby:
+        # Ruby sequencers forward uncacheable MMIO straight to the iobus.
+        system.platform.attachOnChipIO(system.iobus)
+    else:
+        system.bridge = Bridge(delay="50ns")
+        system.bridge.mem_side_port = system.iobus.cpu_side_ports
+        system.bridge.cpu_side_port = system.membus.mem_side_ports
+        system.bridge.ranges = [*system.platform._off_chip_ranges(), *extra_io_ranges]
 
-    system.iobridge = Bridge(delay="50ns", ranges=system.mem_ranges)
-    system.iobridge.cpu_side_port = system.iobus.mem_side_ports
-    system.iobridge.mem_side_port = system.membus.cpu_side_ports
+        system.iobridge = Bridge(delay="50ns", ranges=system.mem_ranges)
+        system.iobridge.cpu_side_port = system.iobus.mem_side_ports
+        system.iobridge.mem_side_port = system.membus.cpu_side_ports
 
-    system.platform.attachOnChipIO(system.membus)
+        system.platform.attachOnChipIO(system.membus)
     system.platform.attachOffChipIO(system.iobus)
-    system.platform.uart1.pio = system.iobus.mem_side_ports
-    system.platform.uart2.pio = system.iobus.mem_side_ports
+    for uart in extra_uarts:
+        uart.pio = system.iobus.mem_side_ports
+    if args.dvfs:
+        system.platform.dvfs_ctrl.pio = system.iobus.mem_side_ports
     system.platform.attachPlic()
 
-    system.cluster0_bus = L2XBar()
-    system.cluster1_bus = L2XBar()
-    system.cluster0_l2 = L2Cache(size=args.l2_cluster0_size, assoc=args.l2_assoc)
-    system.cluster1_l2 = L2Cache(size=args.l2_cluster1_size, assoc=args.l2_assoc)
-    system.cluster0_l2.cpu_side = system.cluster0_bus.mem_side_ports
-    system.cluster0_l2.mem_side = system.membus.cpu_side_ports
-    system.cluster1_l2.cpu_side = system.cluster1_bus.mem_side_ports
-    system.cluster1_l2.mem_side = system.membus.cpu_side_ports
-
-    system.cpu = [cpu_cls(clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(args.num_cpus)]
+    shared_base, shared_size = _to_int(args.shared_base), _to_int(args.shared_size)
+    if shared_region["backing"] == "sram":
+        # The scratchpad hangs off the membus, the first crossbar both
+        # clusters share, instead of sitting behind the DRAM controllers.
+        system.scratchpad_bus, system.scratchpad = make_scratchpad(shared_region, shared_base, shared_size)
+        system.scratchpad_bus.cpu_side_ports = system.membus.mem_side_ports
+
+    o3 = o3_params(args)
+    system.cpu = [
+        make_cpu(
+            cpu_models[hart_cluster[i]],
+            o3,
+            clk_domain=cluster_clk_domains[hart_cluster[i]],
+            cpu_id=i,
+        )
+        for i in range(num_cpus)
+    ]
     uncacheable = [
         *system.platform._on_chip_ranges(),
         *system.platform._off_chip_ranges(),
-        *extra_uart_ranges,
+        *extra_io_ranges,
     ]
-    for i, cpu in enumerate(system.cpu):
+    if not shared_region["cacheable"]:
+        uncacheable.append(AddrRange(start=shared_base, size=shared_size))
+    for cpu in system.cpu:
         cpu.ArchISA.riscv_type = "RV32"
         cpu.createThreads()
         cpu.createInterruptController()
-
-        l1i = L1_ICache(size=args.l1i_size, assoc=args.l1_assoc)
-        l1d = L1_DCache(size=args.l1d_size, assoc=args.l1_assoc)
-        setattr(cpu, "l1i", l1i)
-        setattr(cpu, "l1d", l1d)
-        l1i.cpu_side = cpu.icache_port
-        l1d.cpu_side = cpu.dcache_port
-
-        cluster_bus = system.cluster0_bus if i < 2 else system.cluster1_bus
-        l1i.mem_side = cluster_bus.cpu_side_ports
-        l1d.mem_side = cluster_bus.cpu_side_ports
-        cpu.mmu.connectWalkerPorts(cluster_bus.cpu_side_ports, cluster_bus.cpu_side_ports)
         cpu.mmu.pma_checker = PMAChecker(uncacheable=uncacheable)
 
-    for mem in system.memories:
-        mem.port = system.membus.mem_side_ports
+    elastic_traces = []
+    if args.mem_trace == "elastic":
+        for i, cpu in enumerate(system.cpu):
+            if cpu_models[hart_cluster[i]] == "o3":
+                elastic_traces.append((i, *attach_elastic_trace(cpu, f"cpu{i}")))
+
+    if use_ruby:
+        _attach_ruby_memory_system(args, system, topology)
+    else:
+        _attach_classic_memory_system(args, system, topology)
 
     system.workload = RiscvBareMetal(bootloader=args.boot_elf, bare_metal=True, auto_reset_vect=True)
 
     root = Root(full_system=True, system=system)
     print(
         "[INFO] runtime launch:",
-        f"cpus={args.num_cpus}",
-        f"cpu_type={args.cpu_type}",
+        f"topology={topology['name']}",
+        f"cpus={num_cpus}",
+        f"cpu_models={','.join(cpu_models)}",
+        f"memory_system={args.memory_system}",
+        f"shared_llc={args.llc_size if args.shared_llc else 'off'}",
+        f"shared_mem={shared_region['backing']}",
+        f"shared_cacheable={'on' if shared_region['cacheable'] else 'off'}",
+        f"dvfs={'on' if args.dvfs else 'off'}",
+        f"comm_monitor={'on' if args.comm_monitor else 'off'}",
+        f"mem_trace={args.mem_trace}",
+        f"tick_terminal={args.tick_terminal}",
+        *(f"{bus}={','.join(f'{k}={v}' for k, v in params.items())}" for bus, params in xbars.items() if params),
         f"boot_elf={args.boot_elf}",
-        f"amp_cpu0={args.amp_cpu0_elf}",
-        f"amp_cpu1={args.amp_cpu1_elf}",
-        f"smp={args.smp_elf}",
+        *(f"{image['name']}={image['elf']}" for image in images),
         f"max_ticks={args.max_ticks}",
+        f"stats_period={args.stats_period}",
+        f"stats={args.stats_profile}/{args.stats_format}",
     )
     print(
         "[INFO] uart map:",
-        "UART0=CPU0(system.platform.terminal)",
-        "UART1=CPU1(system.platform.terminal1)",
-        "UART2=CPU2-5 SMP(system.platform.terminal2)",
+        *(
+            f"UART{image['uart_index']}={image['name']}"
+            f"(system.platform.terminal{image['uart_index'] or ''})"
+            for image in images
+        ),
     )
 
+    apply_stats_profile(_stats_plan(args), m5.options.outdir)
     m5.instantiate()
-    exit_event = m5.simulate(args.max_ticks)
+    exit_event = simulate_in_slices(args.max_ticks, args.stats_period)
     cause = exit_event.getCause()
     tick = m5.curTick()
     print(f"[INFO] gem5 exit cause: {cause}")
     print(f"[INFO] gem5 exit tick: {tick}")
+    if args.mem_trace != "off":
+        _write_mem_trace_sidecar(args, topology, segments, cpu_models, elastic_traces, tick)
 
     lc = cause.lower()
     if "panic" in lc or "oops" in lc:
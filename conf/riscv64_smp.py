@@ -4,6 +4,23 @@
 Modes:
 - Plain Python: dry-run plan generator (`--print-json`).
 - gem5 runtime: instantiate and run a real RISC-V full-system simulation.
+
+Cache hierarchy (`--cache-hierarchy`):
+- shared-l2 (default): private L1I/L1D per core + one shared cluster L2
+- private-l2-llc: private L1I/L1D/L2 per core + shared LLC
+- none: CPU ports connect straight to membus (legacy behaviour)
+
+`--l1d-prefetcher` / `--l2-prefetcher` attach a gem5 prefetcher to every L1D
+and to the L2 level (shared or private) of the cluster.
+
+`--membus-*`, `--l2bus-*` (every L2XBar: L2, private-L2 and LLC buses) and
+`--iobus-*` override crossbar width and frontend/forward/response/snoop
+latencies.
+
+`--disk-image` is attached as virtio-block (/dev/vda) when it exists.
+`--blk-latency` / `--blk-bandwidth` swap gem5's VirtIOBlock (instant
+completion) for OmxVirtIOBlock (gem5_ext/), which holds each completion
+until max(submit + latency, transfer through one bandwidth-limited channel).
 """
 
 import argparse
@@ -11,7 +28,34 @@ import json
 import os
 from dataclasses import asdict, dataclass
 from pathlib import Path
-from typing import Dict, List
+from typing import Dict, List, Optional
+
+from omx_gem5 import (
+    CPU_MODELS,
+    add_memory_arguments,
+    add_o3_arguments,
+    add_stats_period_arguments,
+    add_stats_profile_arguments,
+    add_tick_terminal_arguments,
+    add_xbar_arguments,
+    apply_stats_profile,
+    attach_prefetcher,
+    configure_xbar,
+    make_cpu,
+    make_memory_ctrls,
+    mem_mode_for,
+    memory_plan,
+    o3_params,
+    parse_prefetcher_spec,
+    replace_platform_terminal,
+    simulate_in_slices,
+    stats_profile_plan,
+    xbar_plan,
+)
+
+CLUSTERS = ("cluster0",)
+# What scripts/run_gem5.py blk_metrics reads, kept under a reduced --stats-profile.
+BLOCK_STATS = ("system.platform.disk.vio.*",)
 
 
 @dataclass
@@ -20,6 +64,7 @@ class CacheConfig:
     kind: str
     size: str
     assoc: int
+    prefetcher: str = "none"
 
 
 @dataclass
@@ -27,8 +72,10 @@ class CoreConfig:
     cpu_id: int
     isa: str
     cluster: str
-    l1i: CacheConfig
-    l1d: CacheConfig
+    l1i: Optional[CacheConfig]
+    l1d: Optional[CacheConfig]
+    l2: Optional[CacheConfig] = None
+    ptw: Optional[CacheConfig] = None
 
 
 @dataclass
@@ -36,8 +83,9 @@ class ClusterConfig:
     name: str
     mode: str
     cores: List[int]
-    l2: CacheConfig
+    l2: Optional[CacheConfig]
     uart: str
+    llc: Optional[CacheConfig] = None
 
 
 @dataclass
@@ -53,9 +101,18 @@ class PlatformPlan:
     target: str
     isa: str
     topology: Dict[str, int]
+    cache_hierarchy: str
+    cpu_model: str
+    o3: Optional[Dict[str, int]]
+    memory: Dict[str, object]
+    xbars: Dict[str, Dict[str, int]]
+    block: Dict[str, str]
     cores: List[CoreConfig]
     clusters: List[ClusterConfig]
     workload: WorkloadConfig
+    tick_terminal: str = "off"
+    stats_period: int = 0
+    stats: Optional[Dict[str, object]] = None
 
 
 def default_cmdline() -> str:
@@ -66,22 +123,62 @@ def default_cmdline() -> str:
     )
 
 
+def _cluster_prefetchers(args: argparse.Namespace):
+    return (
+        parse_prefetcher_spec(args.l1d_prefetcher, CLUSTERS, "--l1d-prefetcher"),
+        parse_prefetcher_spec(args.l2_prefetcher, CLUSTERS, "--l2-prefetcher"),
+    )
+
+
+def block_plan(args: argparse.Namespace) -> Dict[str, str]:
+    timed = bool(args.blk_latency or args.blk_bandwidth)
+    return {
+        "image": args.disk_image,
+        "device": "OmxVirtIOBlock" if timed else "VirtIOBlock",
+        "latency": args.blk_latency or ("0ns" if timed else ""),
+        "bandwidth": args.blk_bandwidth or ("1TiB/s" if timed else ""),
+    }
+
+
 def build_plan(args: argparse.Namespace) -> PlatformPlan:
+    hierarchy = args.cache_hierarchy
+    l1d_pf, l2_pf = _cluster_prefetchers(args)
     l1i = CacheConfig(level="L1I", kind="private", size=args.l1i_size, assoc=args.l1_assoc)
-    l1d = CacheConfig(level="L1D", kind="private", size=args.l1d_size, assoc=args.l1_assoc)
-    l2 = CacheConfig(level="L2", kind="unified", size=args.l2_size, assoc=args.l2_assoc)
+    l1d = CacheConfig(
+        level="L1D", kind="private", size=args.l1d_size, assoc=args.l1_assoc, prefetcher=l1d_pf[0]
+    )
+    ptw = None
+    if args.ptw_cache:
+        ptw = CacheConfig(level="PTW", kind="private", size=args.ptw_cache_size, assoc=args.ptw_cache_assoc)
+
+    shared_l2 = None
+    private_l2 = None
+    llc = None
+    if hierarchy == "shared-l2":
+        shared_l2 = CacheConfig(
+            level="L2", kind="unified", size=args.l2_size, assoc=args.l2_assoc, prefetcher=l2_pf[0]
+        )
+    elif hierarchy == "private-l2-llc":
+        private_l2 = CacheConfig(
+            level="L2", kind="private", size=args.l2_size, assoc=args.l2_assoc, prefetcher=l2_pf[0]
+        )
+        llc = CacheConfig(level="LLC", kind="shared", size=args.llc_size, assoc=args.llc_assoc)
 
-    cores = [
-        CoreConfig(cpu_id=i, isa="rv64", cluster="cluster0", l1i=l1i, l1d=l1d)
-        for i in range(4)
-    ]
+    if hierarchy == "none":
+        cores = [CoreConfig(cpu_id=i, isa="rv64", cluster="cluster0", l1i=None, l1d=None) for i in range(4)]
+    else:
+        cores = [
+            CoreConfig(cpu_id=i, isa="rv64", cluster="cluster0", l1i=l1i, l1d=l1d, l2=private_l2, ptw=ptw)
+            for i in range(4)
+        ]
 
     cluster0 = ClusterConfig(
         name="cluster0",
         mode="SMP",
         cores=[0, 1, 2, 3],
-        l2=l2,
+        l2=shared_l2,
         uart="uart_shared_cluster0",
+        llc=llc,
     )
 
     workload = WorkloadConfig(
@@ -95,9 +192,18 @@ def build_plan(args: argparse.Namespace) -> PlatformPlan:
         target="riscv64_smp",
         isa="rv64",
         topology={"clusters": 1, "cores": 4},
+        cache_hierarchy=hierarchy,
+        cpu_model=args.cpu_type,
+        o3=o3_params(args) if args.cpu_type == "o3" else None,
+        memory=memory_plan(args),
+        xbars=xbar_plan(args),
+        block=block_plan(args),
         cores=cores,
         clusters=[cluster0],
         workload=workload,
+        tick_terminal=args.tick_terminal,
+        stats_period=args.stats_period,
+        stats=stats_profile_plan(args, BLOCK_STATS),
     )
 
 
@@ -113,22 +219,45 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--initramfs", default="build/initramfs/rootfs-shell.cpio")
     p.add_argument("--dtb", default="build/linux/arch/riscv/boot/dts/gem5-riscv64-smp.dtb")
     p.add_argument("--disk-image", default="build/buildroot/images/rootfs.ext2")
+    p.add_argument("--blk-latency", default="", help="virtio-block access latency, e.g. 80us (OmxVirtIOBlock)")
+    p.add_argument("--blk-bandwidth", default="", help="virtio-block backend bandwidth, e.g. 500MB/s (OmxVirtIOBlock)")
     p.add_argument("--cmdline", default=default_cmdline())
     p.add_argument("--num-cpus", type=int, default=4)
-    p.add_argument("--cpu-type", choices=["atomic", "timing"], default="atomic")
+    p.add_argument("--cpu-type", choices=CPU_MODELS, default="atomic")
+    add_o3_arguments(p)
     p.add_argument("--sys-clock", default="1GHz")
     p.add_argument("--cpu-clock", default="3GHz")
     p.add_argument("--mem-size", default="2GiB")
+    add_memory_arguments(p, default_type="ddr3")
     p.add_argument("--kernel-addr", default="0x80200000")
     p.add_argument("--dtb-addr", default="0x87E00000")
     p.add_argument("--initrd-addr", default="0xA0000000")
     p.add_argument("--max-ticks", type=int, default=5_000_000_000_000)
+    add_stats_period_arguments(p)
+    add_stats_profile_arguments(p)
 
     p.add_argument("--l1i-size", default="32kB")
     p.add_argument("--l1d-size", default="32kB")
     p.add_argument("--l1-assoc", type=int, default=4)
     p.add_argument("--l2-size", default="1MB")
     p.add_argument("--l2-assoc", type=int, default=8)
+    p.add_argument(
+        "--cache-hierarchy",
+        choices=["shared-l2", "private-l2-llc", "none"],
+        default="shared-l2",
+        help="shared-l2: private L1I/L1D + one cluster L2; "
+        "private-l2-llc: private L1I/L1D/L2 per core + shared LLC; "
+        "none: CPU ports straight to membus",
+    )
+    p.add_argument("--l1d-prefetcher", default="none", help="none|stride|tagged|bop|ampm")
+    p.add_argument("--l2-prefetcher", default="none", help="none|stride|tagged|bop|ampm")
+    p.add_argument("--llc-size", default="4MB")
+    p.add_argument("--llc-assoc", type=int, default=16)
+    p.add_argument("--ptw-cache", action="store_true", help="Add per-core itb and dtb page-walker caches")
+    p.add_argument("--ptw-cache-size", default="4kB")
+    p.add_argument("--ptw-cache-assoc", type=int, default=4)
+    add_xbar_arguments(p)
+    add_tick_terminal_arguments(p)
 
     p.add_argument(
         "--print-json",
@@ -211,18 +340,87 @@ def _generate_dtb(system, dtb_path: str, cmdline: str) -> None:
     fdt.writeDtbFile(str(out_dtb))
 
 
+def _attach_cache_hierarchy(args: argparse.Namespace, system) -> None:
+    """Wire CPU fetch/data/walker ports according to --cache-hierarchy."""
+    from m5.objects import L2XBar  # type: ignore
+    from m5.util import addToPath  # type: ignore
+
+    l1d_pf, l2_pf = _cluster_prefetchers(args)
+    l2bus_params = xbar_plan(args)["l2bus"]
+    if args.cache_hierarchy == "none":
+        if l1d_pf[0] != "none" or l2_pf[0] != "none":
+            raise ValueError("prefetchers need caches; use --cache-hierarchy shared-l2|private-l2-llc")
+        for cpu in system.cpu:
+            cpu.icache_port = system.membus.cpu_side_ports
+            cpu.dcache_port = system.membus.cpu_side_ports
+            cpu.mmu.connectWalkerPorts(system.membus.cpu_side_ports, system.membus.cpu_side_ports)
+        return
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common.Caches import L1_DCache, L1_ICache, L2Cache, PageTableWalkerCache  # type: ignore
+
+    if args.cache_hierarchy == "shared-l2":
+        system.l2bus = configure_xbar(L2XBar(), l2bus_params)
+        system.l2 = L2Cache(size=args.l2_size, assoc=args.l2_assoc)
+        attach_prefetcher(system.l2, l2_pf[0])
+        system.l2.cpu_side = system.l2bus.mem_side_ports
+        system.l2.mem_side = system.membus.cpu_side_ports
+    else:
+        # The LLC sits behind its own snooping crossbar so that the private
+        # L2s stay coherent with each other before reaching membus.
+        system.llc_bus = configure_xbar(L2XBar(), l2bus_params)
+        system.llc = L2Cache(
+            size=args.llc_size,
+            assoc=args.llc_assoc,
+            tag_latency=30,
+            data_latency=30,
+            response_latency=30,
+            mshrs=32,
+        )
+        system.llc.cpu_side = system.llc_bus.mem_side_ports
+        system.llc.mem_side = system.membus.cpu_side_ports
+
+    for cpu in system.cpu:
+        if args.cache_hierarchy == "shared-l2":
+            next_level = system.l2bus
+        else:
+            cpu.l2bus = configure_xbar(L2XBar(), l2bus_params)
+            cpu.l2 = L2Cache(size=args.l2_size, assoc=args.l2_assoc)
+            attach_prefetcher(cpu.l2, l2_pf[0])
+            cpu.l2.cpu_side = cpu.l2bus.mem_side_ports
+            cpu.l2.mem_side = system.llc_bus.cpu_side_ports
+            next_level = cpu.l2bus
+
+        cpu.l1i = L1_ICache(size=args.l1i_size, assoc=args.l1_assoc)
+        cpu.l1d = L1_DCache(size=args.l1d_size, assoc=args.l1_assoc)
+        attach_prefetcher(cpu.l1d, l1d_pf[0])
+        cpu.l1i.cpu_side = cpu.icache_port
+        cpu.l1d.cpu_side = cpu.dcache_port
+        cpu.l1i.mem_side = next_level.cpu_side_ports
+        cpu.l1d.mem_side = next_level.cpu_side_ports
+
+        if args.ptw_cache:
+            # RiscvMMU has separate itb and dtb walkers; each gets its own walker cache,
+            # as in gem5's common/CacheConfig.py.
+            cpu.iwalk_cache = PageTableWalkerCache(size=args.ptw_cache_size, assoc=args.ptw_cache_assoc)
+            cpu.dwalk_cache = PageTableWalkerCache(size=args.ptw_cache_size, assoc=args.ptw_cache_assoc)
+            cpu.iwalk_cache.mem_side = next_level.cpu_side_ports
+            cpu.dwalk_cache.mem_side = next_level.cpu_side_ports
+            cpu.mmu.connectWalkerPorts(cpu.iwalk_cache.cpu_side, cpu.dwalk_cache.cpu_side)
+        else:
+            cpu.mmu.connectWalkerPorts(next_level.cpu_side_ports, next_level.cpu_side_ports)
+
+
 def _run_gem5_runtime(args: argparse.Namespace) -> int:
     import m5  # type: ignore
     from m5.objects import (  # type: ignore
         AddrRange,
-        AtomicSimpleCPU,
         Bridge,
         CowDiskImage,
-        DDR3_1600_8x8,
         Frequency,
         HiFive,
         IOXBar,
-        MemCtrl,
         PMAChecker,
         RawDiskImage,
         RiscvBootloaderKernelWorkload,
@@ -233,7 +431,6 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
         Root,
         SystemXBar,
         SrcClockDomain,
-        TimingSimpleCPU,
         VirtIOBlock,
         VoltageDomain,
     )
@@ -253,10 +450,8 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
     if not dtb_path.exists():
         dtb_path = Path(m5.options.outdir) / "device.dtb"
 
-    cpu_cls = AtomicSimpleCPU if args.cpu_type == "atomic" else TimingSimpleCPU
-
     system = RiscvSystem()
-    system.mem_mode = "atomic" if args.cpu_type == "atomic" else "timing"
+    system.mem_mode = mem_mode_for([args.cpu_type])
     system.mem_ranges = [AddrRange(start=0x80000000, size=args.mem_size)]
     system.cache_line_size = 64
 
@@ -267,14 +462,16 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
         clock=args.cpu_clock, voltage_domain=system.cpu_voltage_domain
     )
 
-    system.iobus = IOXBar()
-    system.membus = SystemXBar()
+    xbars = xbar_plan(args)
+    system.iobus = configure_xbar(IOXBar(), xbars["iobus"])
+    system.membus = configure_xbar(SystemXBar(), xbars["membus"])
     system.system_port = system.membus.cpu_side_ports
 
     system.platform = HiFive()
     system.platform.rtc = RiscvRTC(frequency=Frequency("100MHz"))
     system.platform.clint.int_pin = system.platform.rtc.int_pin
     system.platform.setNumCores(args.num_cpus)
+    replace_platform_terminal(system.platform, args.tick_terminal)
 
     system.iobus.cpu_side_ports = system.platform.pci_host.up_request_port()
     system.iobus.mem_side_ports = system.platform.pci_host.up_response_port()
@@ -285,8 +482,15 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
     if disk_image.exists():
         image = CowDiskImage(child=RawDiskImage(read_only=True), read_only=False)
         image.child.image_file = str(disk_image)
+        block = block_plan(args)
+        if block["device"] == "OmxVirtIOBlock":
+            if not hasattr(m5.objects, "OmxVirtIOBlock"):
+                raise ValueError("--blk-latency/--blk-bandwidth need a gem5 binary built with EXTRAS=gem5_ext")
+            vio = m5.objects.OmxVirtIOBlock(image=image, latency=block["latency"], bandwidth=block["bandwidth"])
+        else:
+            vio = VirtIOBlock(image=image)
         system.platform.disk = RiscvMmioVirtIO(
-            vio=VirtIOBlock(image=image),
+            vio=vio,
             interrupt_id=0x8,
             pio_size=4096,
             pio_addr=0x10008000,
@@ -307,20 +511,20 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
     system.platform.attachOffChipIO(system.iobus)
     system.platform.attachPlic()
 
-    system.cpu = [cpu_cls(clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(args.num_cpus)]
+    o3 = o3_params(args)
+    system.cpu = [
+        make_cpu(args.cpu_type, o3, clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(args.num_cpus)
+    ]
     uncacheable = [*system.platform._on_chip_ranges(), *system.platform._off_chip_ranges()]
     for cpu in system.cpu:
         cpu.createThreads()
         cpu.createInterruptController()
-        cpu.icache_port = system.membus.cpu_side_ports
-        cpu.dcache_port = system.membus.cpu_side_ports
-        cpu.mmu.connectWalkerPorts(system.membus.cpu_side_ports, system.membus.cpu_side_ports)
         cpu.mmu.pma_checker = PMAChecker(uncacheable=uncacheable)
+    _attach_cache_hierarchy(args, system)
 
-    system.mem_ctrl = MemCtrl()
-    system.mem_ctrl.dram = DDR3_1600_8x8()
-    system.mem_ctrl.dram.range = system.mem_ranges[0]
-    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.mem_ctrls = make_memory_ctrls(memory_plan(args), 0x80000000, args.mem_size)
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
 
     has_bootloader = bootloader.exists()
     has_initramfs = initramfs.exists()
@@ -364,16 +568,20 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
         "[INFO] runtime launch:",
         f"cpus={args.num_cpus}",
         f"cpu_type={args.cpu_type}",
+        f"caches={args.cache_hierarchy}{'+ptw' if args.ptw_cache else ''}",
         f"kernel={kernel_path}",
         f"bootloader={'yes' if has_bootloader else 'no'}",
         f"initramfs={'yes' if has_initramfs else 'no'}",
-        f"disk={'yes' if disk_image.exists() else 'no'}",
+        f"disk={block_plan(args)['device'] if disk_image.exists() else 'no'}",
         f"dtb={system.workload.dtb_filename}",
         f"max_ticks={args.max_ticks}",
+        f"stats_period={args.stats_period}",
+        f"stats={args.stats_profile}/{args.stats_format}",
     )
 
+    apply_stats_profile(stats_profile_plan(args, BLOCK_STATS), m5.options.outdir)
     m5.instantiate()
-    exit_event = m5.simulate(args.max_ticks)
+    exit_event = simulate_in_slices(args.max_ticks, args.stats_period)
     cause = exit_event.getCause()
     tick = m5.curTick()
     print(f"[INFO] gem5 exit cause: {cause}")
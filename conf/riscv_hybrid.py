@@ -4,12 +4,59 @@
 Goal:
 - Use one gem5 process
 - Run RV32 mixed Zephyr topology and RV64 Linux topology together
+
+The two memory maps are disjoint unless --hybrid-shm adds a shared window:
+uncached memory in system32 at --hybrid-shm-base, which system64 reaches at
+--hybrid-shm-rv64-base (above its DRAM) through a RangeAddrMapper into
+system32's membus. Linux sees it as a reserved-memory region and the
+generic-uio device "omx-hybrid-shm"; the Zephyr responder image finds it in
+its overlay (conf/omx_topology.py HYBRID_SHM_*). The ring protocol on top is
+workloads/ipc/omx_shm_ring.h.
 """
 
 import argparse
 import json
+import re
 from pathlib import Path
 
+from omx_gem5 import (
+    CPU_MODELS,
+    add_memory_arguments,
+    add_o3_arguments,
+    add_shared_region_arguments,
+    add_stats_period_arguments,
+    add_stats_profile_arguments,
+    add_tick_terminal_arguments,
+    add_xbar_arguments,
+    apply_stats_profile,
+    attach_prefetcher,
+    configure_xbar,
+    make_comm_monitor,
+    make_cpu,
+    make_memory_ctrls,
+    make_scratchpad,
+    make_terminal,
+    mem_mode_for,
+    memory_plan,
+    o3_params,
+    parse_prefetcher_spec,
+    replace_platform_terminal,
+    shared_region_plan,
+    simulate_in_slices,
+    stats_profile_plan,
+    xbar_plan,
+)
+from omx_topology import HYBRID_SHM_BASE, HYBRID_SHM_RESPONDER, HYBRID_SHM_SIZE
+
+RV32_CLUSTERS = ("cluster0", "cluster1")
+RV64_DRAM_BASE = 0x80000000
+HYBRID_SHM_UIO_NAME = "omx-hybrid-shm"
+# uio_pdrv_genirq binds generic-uio nodes only when told the compatible.
+HYBRID_SHM_CMDLINE = "uio_pdrv_genirq.of_id=generic-uio"
+# What scripts/host_attribution.py reads, kept under a reduced --stats-profile.
+HOST_ATTRIBUTION_STATS = ("*.numCycles", "*.numInsts", "*.committedInsts", "*.pktCount")
+_MEM_UNITS = {"": 1, "b": 1, "kb": 1 << 10, "kib": 1 << 10, "mb": 1 << 20, "mib": 1 << 20, "gb": 1 << 30, "gib": 1 << 30}
+
 
 def parser() -> argparse.ArgumentParser:
     p = argparse.ArgumentParser(
@@ -21,7 +68,7 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--amp-cpu0-elf", default="build/zephyr/cluster0_amp_cpu0/zephyr/zephyr.elf")
     p.add_argument("--amp-cpu1-elf", default="build/zephyr/cluster0_amp_cpu1/zephyr/zephyr.elf")
     p.add_argument("--smp-elf", default="build/zephyr/cluster1_smp/zephyr/zephyr.elf")
-    p.add_argument("--rv32-cpu-type", choices=["timing", "atomic"], default="timing")
+    p.add_argument("--rv32-cpu-type", choices=CPU_MODELS, default="timing")
     p.add_argument("--rv32-uart0-port", type=int, default=3456)
     p.add_argument("--rv32-uart1-port", type=int, default=3457)
     p.add_argument("--rv32-uart2-port", type=int, default=3458)
@@ -36,6 +83,8 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--cluster1-smp-size", default="0x08000000")
     p.add_argument("--shared-base", default="0x90000000")
     p.add_argument("--shared-size", default="0x10000000")
+    add_memory_arguments(p, prefix="rv32-")
+    add_shared_region_arguments(p)
 
     p.add_argument("--rv32-l1i-size", default="16kB")
     p.add_argument("--rv32-l1d-size", default="16kB")
@@ -43,6 +92,22 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--rv32-l2-cluster0-size", default="256kB")
     p.add_argument("--rv32-l2-cluster1-size", default="512kB")
     p.add_argument("--rv32-l2-assoc", type=int, default=8)
+    p.add_argument(
+        "--rv32-l1d-prefetcher",
+        default="none",
+        help="none|stride|tagged|bop|ampm, or one name per rv32 cluster (e.g. none,stride)",
+    )
+    p.add_argument(
+        "--rv32-l2-prefetcher",
+        default="none",
+        help="none|stride|tagged|bop|ampm, or one name per rv32 cluster (e.g. none,bop)",
+    )
+    add_xbar_arguments(p, prefix="rv32-")
+    p.add_argument(
+        "--rv32-comm-monitor",
+        action="store_true",
+        help="insert a CommMonitor between each rv32 cluster L2 and the membus",
+    )
 
     # RV64 Linux inputs.
     p.add_argument("--kernel", default="build/linux/vmlinux")
@@ -59,9 +124,11 @@ def parser() -> argparse.ArgumentParser:
         ),
     )
     p.add_argument("--rv64-num-cpus", type=int, default=4)
-    p.add_argument("--rv64-cpu-type", choices=["timing", "atomic"], default="atomic")
+    p.add_argument("--rv64-cpu-type", choices=CPU_MODELS, default="atomic")
+    add_o3_arguments(p)
     p.add_argument("--rv64-uart-port", type=int, default=3460)
     p.add_argument("--rv64-mem-size", default="2GiB")
+    add_memory_arguments(p, prefix="rv64-", default_type="ddr3")
     p.add_argument("--kernel-addr", default="0x80200000")
     p.add_argument("--dtb-addr", default="0x87E00000")
     p.add_argument("--initrd-addr", default="0xA0000000")
@@ -70,12 +137,33 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--rv64-l1-assoc", type=int, default=4)
     p.add_argument("--rv64-l2-size", default="1MB")
     p.add_argument("--rv64-l2-assoc", type=int, default=8)
+    add_xbar_arguments(p, prefix="rv64-")
+
+    # Linux<->Zephyr shared window.
+    p.add_argument(
+        "--hybrid-shm",
+        action="store_true",
+        help="map a shared window into both systems (generic-uio node for Linux, overlay window for Zephyr)",
+    )
+    p.add_argument("--hybrid-shm-base", default=f"0x{HYBRID_SHM_BASE:08x}", help="window address in system32")
+    p.add_argument("--hybrid-shm-rv64-base", default="0x100000000", help="window address in system64, outside its DRAM")
+    p.add_argument("--hybrid-shm-size", default=f"0x{HYBRID_SHM_SIZE:08x}")
+    p.add_argument("--hybrid-shm-latency", default="40ns", help="access latency of the window memory")
 
     # Shared runtime.
     p.add_argument("--sys-clock", default="1GHz")
     p.add_argument("--rv32-cpu-clock", default="1GHz")
     p.add_argument("--rv64-cpu-clock", default="3GHz")
     p.add_argument("--max-ticks", type=int, default=2_000_000_000)
+    p.add_argument(
+        "--host-attribution-period",
+        type=int,
+        default=0,
+        help="dump cumulative stats every N ticks for per-system host-time attribution (0 = off)",
+    )
+    add_stats_period_arguments(p)
+    add_stats_profile_arguments(p)
+    add_tick_terminal_arguments(p)
     p.add_argument("--print-json", action="store_true")
     return p
 
@@ -92,6 +180,65 @@ def _has_gem5_runtime() -> bool:
     return True
 
 
+def _mem_bytes(value: str) -> int:
+    match = re.fullmatch(r"\s*(\d+)\s*([a-zA-Z]*)\s*", value)
+    if not match or match.group(2).lower() not in _MEM_UNITS:
+        raise ValueError(f"invalid memory size {value!r}")
+    return int(match.group(1)) * _MEM_UNITS[match.group(2).lower()]
+
+
+def _rv32_segments(args: argparse.Namespace):
+    """(name, base, size, image) of every rv32 memory segment."""
+    return [
+        ("boot", _to_int(args.boot_base), _to_int(args.boot_size), ""),
+        ("amp_cpu0", _to_int(args.amp_cpu0_base), _to_int(args.amp_cpu0_size), args.amp_cpu0_elf),
+        ("amp_cpu1", _to_int(args.amp_cpu1_base), _to_int(args.amp_cpu1_size), args.amp_cpu1_elf),
+        (
+            "cluster1_smp",
+            _to_int(args.cluster1_smp_base),
+            _to_int(args.cluster1_smp_size),
+            args.smp_elf,
+        ),
+        ("shared", _to_int(args.shared_base), _to_int(args.shared_size), ""),
+    ]
+
+
+def _hybrid_shm_plan(args: argparse.Namespace) -> dict:
+    if not args.hybrid_shm:
+        return {"enabled": False}
+    # system64 reaches the window through system32's membus; gem5 cannot take atomic
+    # accesses into a timing crossbar, and atomic ones would skip its queueing anyway.
+    if mem_mode_for([args.rv64_cpu_type]) != "timing" or mem_mode_for([args.rv32_cpu_type]) != "timing":
+        raise ValueError("--hybrid-shm needs timing-mode CPU models on both systems (--rv64-cpu-type/--rv32-cpu-type)")
+    rv32_base = _to_int(args.hybrid_shm_base)
+    rv64_base = _to_int(args.hybrid_shm_rv64_base)
+    size = _to_int(args.hybrid_shm_size)
+    for name, base, seg_size, _ in _rv32_segments(args):
+        if base < rv32_base + size and rv32_base < base + seg_size:
+            raise ValueError(f"--hybrid-shm-base window overlaps the rv32 {name} segment")
+    if rv32_base + size > 1 << 32:
+        raise ValueError("--hybrid-shm-base window ends above the rv32 address space")
+    rv64_dram_end = RV64_DRAM_BASE + _mem_bytes(args.rv64_mem_size)
+    if rv64_base < rv64_dram_end and RV64_DRAM_BASE < rv64_base + size:
+        raise ValueError("--hybrid-shm-rv64-base window overlaps rv64 DRAM")
+    return {
+        "enabled": True,
+        "rv32_base": rv32_base,
+        "rv64_base": rv64_base,
+        "size": size,
+        "latency": args.hybrid_shm_latency,
+        "responder": HYBRID_SHM_RESPONDER,
+        "uio_name": HYBRID_SHM_UIO_NAME,
+        "protocol": "workloads/ipc/omx_shm_ring.h",
+    }
+
+
+def _rv64_cmdline(args: argparse.Namespace) -> str:
+    if args.hybrid_shm and HYBRID_SHM_CMDLINE not in args.cmdline:
+        return f"{args.cmdline} {HYBRID_SHM_CMDLINE}"
+    return args.cmdline
+
+
 def _resolve_kernel_elf(args: argparse.Namespace) -> str:
     preferred = Path(args.kernel_elf)
     if preferred.exists():
@@ -103,10 +250,11 @@ def _resolve_kernel_elf(args: argparse.Namespace) -> str:
     return str(preferred)
 
 
-def _generate_dtb(system, dtb_path: str, cmdline: str) -> None:
+def _generate_dtb(system, dtb_path: str, cmdline: str, shm: dict) -> None:
     from m5.util.fdthelper import (  # type: ignore
         Fdt,
         FdtNode,
+        FdtProperty,
         FdtPropertyStrings,
         FdtPropertyWords,
         FdtState,
@@ -136,6 +284,23 @@ def _generate_dtb(system, dtb_path: str, cmdline: str) -> None:
             else:
                 root.append(node)
 
+    if shm["enabled"]:
+        # Keep the kernel off the window, then hand it to user space via UIO.
+        reg = state.addrCells(shm["rv64_base"]) + state.sizeCells(shm["size"])
+        reserved = FdtNode("reserved-memory")
+        reserved.append(state.addrCellsProperty())
+        reserved.append(state.sizeCellsProperty())
+        reserved.append(FdtProperty("ranges"))
+        region = FdtNode(f"{HYBRID_SHM_UIO_NAME}@{shm['rv64_base']:x}")
+        region.append(FdtPropertyWords("reg", reg))
+        region.append(FdtProperty("no-map"))
+        reserved.append(region)
+        root.append(reserved)
+        uio = FdtNode(f"{HYBRID_SHM_UIO_NAME}@{shm['rv64_base']:x}")
+        uio.appendCompatible(["generic-uio"])
+        uio.append(FdtPropertyWords("reg", reg))
+        root.append(uio)
+
     chosen = FdtNode("chosen")
     chosen.append(FdtPropertyStrings("bootargs", [cmdline]))
     chosen.append(FdtPropertyStrings("stdout-path", ["/soc/uart@10000000"]))
@@ -150,10 +315,16 @@ def _generate_dtb(system, dtb_path: str, cmdline: str) -> None:
     fdt.writeDtbFile(str(out_dtb))
 
 
+def _rv32_prefetchers(args: argparse.Namespace):
+    return (
+        parse_prefetcher_spec(args.rv32_l1d_prefetcher, RV32_CLUSTERS, "--rv32-l1d-prefetcher"),
+        parse_prefetcher_spec(args.rv32_l2_prefetcher, RV32_CLUSTERS, "--rv32-l2-prefetcher"),
+    )
+
+
 def _build_rv32_system(args: argparse.Namespace):
     from m5.objects import (  # type: ignore
         AddrRange,
-        AtomicSimpleCPU,
         Bridge,
         Frequency,
         HiFive,
@@ -166,8 +337,6 @@ def _build_rv32_system(args: argparse.Namespace):
         SimpleMemory,
         SrcClockDomain,
         SystemXBar,
-        Terminal,
-        TimingSimpleCPU,
         Uart8250,
         VoltageDomain,
     )
@@ -177,30 +346,23 @@ def _build_rv32_system(args: argparse.Namespace):
     addToPath(str(repo_root / "sources" / "gem5" / "configs"))
     from common.Caches import L1_DCache, L1_ICache, L2Cache  # type: ignore
 
-    cpu_cls = TimingSimpleCPU if args.rv32_cpu_type == "timing" else AtomicSimpleCPU
+    l1d_pf, l2_pf = _rv32_prefetchers(args)
 
-    segments = [
-        ("boot", _to_int(args.boot_base), _to_int(args.boot_size), ""),
-        ("amp_cpu0", _to_int(args.amp_cpu0_base), _to_int(args.amp_cpu0_size), args.amp_cpu0_elf),
-        ("amp_cpu1", _to_int(args.amp_cpu1_base), _to_int(args.amp_cpu1_size), args.amp_cpu1_elf),
-        (
-            "cluster1_smp",
-            _to_int(args.cluster1_smp_base),
-            _to_int(args.cluster1_smp_size),
-            args.smp_elf,
-        ),
-        ("shared", _to_int(args.shared_base), _to_int(args.shared_size), ""),
-    ]
+    segments = _rv32_segments(args)
 
-    memories = []
-    for _, base, size, image in segments:
-        mem = SimpleMemory(range=AddrRange(start=base, size=size), latency="50ns")
-        if image:
-            mem.image_file = image
-        memories.append(mem)
+    mem_plan = memory_plan(args, prefix="rv32-")
+    shared_region = shared_region_plan(args)
+    mem_ctrls = []
+    for name, base, size, image in segments:
+        if name == "shared" and shared_region["backing"] == "sram":
+            continue
+        # Image segments stay on one channel so the ELF can be loaded.
+        seg_plan = dict(mem_plan, channels=1) if image else mem_plan
+        mem_ctrls.extend(make_memory_ctrls(seg_plan, base, size, image=image))
 
-    system = RiscvSystem(memories=memories)
-    system.mem_mode = "timing" if args.rv32_cpu_type == "timing" else "atomic"
+    system = RiscvSystem()
+    system.mem_ctrls = mem_ctrls
+    system.mem_mode = mem_mode_for([args.rv32_cpu_type])
     system.mem_ranges = [AddrRange(start=base, size=size) for _, base, size, _ in segments]
     system.cache_line_size = 64
 
@@ -209,17 +371,20 @@ def _build_rv32_system(args: argparse.Namespace):
     system.cpu_voltage_domain = VoltageDomain()
     system.cpu_clk_domain = SrcClockDomain(clock=args.rv32_cpu_clock, voltage_domain=system.cpu_voltage_domain)
 
-    system.iobus = IOXBar()
-    system.membus = SystemXBar()
+    xbars = xbar_plan(args, prefix="rv32-")
+    system.iobus = configure_xbar(IOXBar(), xbars["iobus"])
+    system.membus = configure_xbar(SystemXBar(), xbars["membus"])
     system.system_port = system.membus.cpu_side_ports
 
     system.platform = HiFive()
     system.platform.rtc = RiscvRTC(frequency=Frequency("100MHz"))
     system.platform.clint.int_pin = system.platform.rtc.int_pin
     system.platform.setNumCores(6)
-    system.platform.terminal.port = args.rv32_uart0_port
-    system.platform.terminal1 = Terminal(port=args.rv32_uart1_port, number=1)
-    system.platform.terminal2 = Terminal(port=args.rv32_uart2_port, number=2)
+    if args.tick_terminal == "off":
+        system.platform.terminal.port = args.rv32_uart0_port
+    replace_platform_terminal(system.platform, args.tick_terminal)
+    system.platform.terminal1 = make_terminal(args.tick_terminal, port=args.rv32_uart1_port, number=1)
+    system.platform.terminal2 = make_terminal(args.tick_terminal, port=args.rv32_uart2_port, number=2)
     system.platform.uart.device = system.platform.terminal
     system.platform.uart1 = Uart8250(
         pio_addr=0x10001000,
@@ -257,17 +422,45 @@ def _build_rv32_system(args: argparse.Namespace):
     system.platform.uart2.pio = system.iobus.mem_side_ports
     system.platform.attachPlic()
 
-    system.cluster0_bus = L2XBar()
-    system.cluster1_bus = L2XBar()
+    shared_base, shared_size = _to_int(args.shared_base), _to_int(args.shared_size)
+    if shared_region["backing"] == "sram":
+        system.scratchpad_bus, system.scratchpad = make_scratchpad(shared_region, shared_base, shared_size)
+        system.scratchpad_bus.cpu_side_ports = system.membus.mem_side_ports
+
+    shm = _hybrid_shm_plan(args)
+    if shm["enabled"]:
+        # Backing store of the Linux<->Zephyr window; system64 maps onto it.
+        system.hybrid_shm = SimpleMemory(
+            range=AddrRange(start=shm["rv32_base"], size=shm["size"]),
+            latency=shm["latency"],
+            latency_var="0ns",
+        )
+        system.hybrid_shm.port = system.membus.mem_side_ports
+
+    system.cluster0_bus = configure_xbar(L2XBar(), xbars["l2bus"])
+    system.cluster1_bus = configure_xbar(L2XBar(), xbars["l2bus"])
     system.cluster0_l2 = L2Cache(size=args.rv32_l2_cluster0_size, assoc=args.rv32_l2_assoc)
     system.cluster1_l2 = L2Cache(size=args.rv32_l2_cluster1_size, assoc=args.rv32_l2_assoc)
+    attach_prefetcher(system.cluster0_l2, l2_pf[0])
+    attach_prefetcher(system.cluster1_l2, l2_pf[1])
     system.cluster0_l2.cpu_side = system.cluster0_bus.mem_side_ports
-    system.cluster0_l2.mem_side = system.membus.cpu_side_ports
     system.cluster1_l2.cpu_side = system.cluster1_bus.mem_side_ports
-    system.cluster1_l2.mem_side = system.membus.cpu_side_ports
+    if args.rv32_comm_monitor:
+        system.cluster0_monitor = make_comm_monitor(system.membus.cpu_side_ports)
+        system.cluster1_monitor = make_comm_monitor(system.membus.cpu_side_ports)
+        system.cluster0_l2.mem_side = system.cluster0_monitor.cpu_side_port
+        system.cluster1_l2.mem_side = system.cluster1_monitor.cpu_side_port
+    else:
+        system.cluster0_l2.mem_side = system.membus.cpu_side_ports
+        system.cluster1_l2.mem_side = system.membus.cpu_side_ports
 
-    system.cpu = [cpu_cls(clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(6)]
+    o3 = o3_params(args)
+    system.cpu = [make_cpu(args.rv32_cpu_type, o3, clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(6)]
     uncacheable = [*system.platform._on_chip_ranges(), *system.platform._off_chip_ranges(), *extra_uart_ranges]
+    if not shared_region["cacheable"]:
+        uncacheable.append(AddrRange(start=shared_base, size=shared_size))
+    if shm["enabled"]:
+        uncacheable.append(AddrRange(start=shm["rv32_base"], size=shm["size"]))
     for i, cpu in enumerate(system.cpu):
         cpu.createThreads()
         cpu.createInterruptController()
@@ -277,6 +470,7 @@ def _build_rv32_system(args: argparse.Namespace):
             cpu.ArchISA.riscv_type = "RV32"
         l1i = L1_ICache(size=args.rv32_l1i_size, assoc=args.rv32_l1_assoc)
         l1d = L1_DCache(size=args.rv32_l1d_size, assoc=args.rv32_l1_assoc)
+        attach_prefetcher(l1d, l1d_pf[0 if i < 2 else 1])
         setattr(cpu, "l1i", l1i)
         setattr(cpu, "l1d", l1d)
         l1i.cpu_side = cpu.icache_port
@@ -287,8 +481,8 @@ def _build_rv32_system(args: argparse.Namespace):
         cpu.mmu.connectWalkerPorts(cluster_bus.cpu_side_ports, cluster_bus.cpu_side_ports)
         cpu.mmu.pma_checker = PMAChecker(uncacheable=uncacheable)
 
-    for mem in system.memories:
-        mem.port = system.membus.mem_side_ports
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
 
     system.workload = RiscvBareMetal(
         bootloader=args.boot_elf,
@@ -301,15 +495,13 @@ def _build_rv32_system(args: argparse.Namespace):
 def _build_rv64_system(args):
     from m5.objects import (  # type: ignore
         AddrRange,
-        AtomicSimpleCPU,
         Bridge,
         CowDiskImage,
-        DDR3_1600_8x8,
         Frequency,
         HiFive,
         IOXBar,
-        MemCtrl,
         PMAChecker,
+        RangeAddrMapper,
         RawDiskImage,
         RiscvBootloaderKernelWorkload,
         RiscvLinux,
@@ -318,7 +510,6 @@ def _build_rv64_system(args):
         RiscvSystem,
         SrcClockDomain,
         SystemXBar,
-        TimingSimpleCPU,
         VoltageDomain,
         VirtIOBlock,
     )
@@ -328,10 +519,8 @@ def _build_rv64_system(args):
     if not kernel_path.exists():
         raise FileNotFoundError(f"kernel ELF missing: {kernel_elf}")
 
-    cpu_cls = AtomicSimpleCPU if args.rv64_cpu_type == "atomic" else TimingSimpleCPU
-
     system = RiscvSystem()
-    system.mem_mode = "atomic" if args.rv64_cpu_type == "atomic" else "timing"
+    system.mem_mode = mem_mode_for([args.rv64_cpu_type])
     system.mem_ranges = [AddrRange(start=0x80000000, size=args.rv64_mem_size)]
     system.cache_line_size = 64
 
@@ -340,15 +529,18 @@ def _build_rv64_system(args):
     system.cpu_voltage_domain = VoltageDomain()
     system.cpu_clk_domain = SrcClockDomain(clock=args.rv64_cpu_clock, voltage_domain=system.cpu_voltage_domain)
 
-    system.iobus = IOXBar()
-    system.membus = SystemXBar()
+    xbars = xbar_plan(args, prefix="rv64-")
+    system.iobus = configure_xbar(IOXBar(), xbars["iobus"])
+    system.membus = configure_xbar(SystemXBar(), xbars["membus"])
     system.system_port = system.membus.cpu_side_ports
 
     system.platform = HiFive()
     system.platform.rtc = RiscvRTC(frequency=Frequency("100MHz"))
     system.platform.clint.int_pin = system.platform.rtc.int_pin
     system.platform.setNumCores(args.rv64_num_cpus)
-    system.platform.terminal.port = args.rv64_uart_port
+    if args.tick_terminal == "off":
+        system.platform.terminal.port = args.rv64_uart_port
+    replace_platform_terminal(system.platform, args.tick_terminal)
 
     system.iobus.cpu_side_ports = system.platform.pci_host.up_request_port()
     system.iobus.mem_side_ports = system.platform.pci_host.up_response_port()
@@ -385,8 +577,24 @@ def _build_rv64_system(args):
     system.platform.attachOffChipIO(system.iobus)
     system.platform.attachPlic()
 
-    system.cpu = [cpu_cls(clk_domain=system.cpu_clk_domain, cpu_id=i) for i in range(args.rv64_num_cpus)]
+    shm = _hybrid_shm_plan(args)
+    if shm["enabled"]:
+        # The window lives in system32; _run_gem5_runtime binds mem_side_port
+        # to system32's membus once both systems exist.
+        system.hybrid_shm_mapper = RangeAddrMapper(
+            original_ranges=[AddrRange(start=shm["rv64_base"], size=shm["size"])],
+            remapped_ranges=[AddrRange(start=shm["rv32_base"], size=shm["size"])],
+        )
+        system.hybrid_shm_mapper.cpu_side_port = system.membus.mem_side_ports
+
+    o3 = o3_params(args)
+    system.cpu = [
+        make_cpu(args.rv64_cpu_type, o3, clk_domain=system.cpu_clk_domain, cpu_id=i)
+        for i in range(args.rv64_num_cpus)
+    ]
     uncacheable = [*system.platform._on_chip_ranges(), *system.platform._off_chip_ranges()]
+    if shm["enabled"]:
+        uncacheable.append(AddrRange(start=shm["rv64_base"], size=shm["size"]))
     for cpu in system.cpu:
         cpu.createThreads()
         cpu.createInterruptController()
@@ -397,10 +605,9 @@ def _build_rv64_system(args):
         cpu.mmu.connectWalkerPorts(system.membus.cpu_side_ports, system.membus.cpu_side_ports)
         cpu.mmu.pma_checker = PMAChecker(uncacheable=uncacheable)
 
-    system.mem_ctrl = MemCtrl()
-    system.mem_ctrl.dram = DDR3_1600_8x8()
-    system.mem_ctrl.dram.range = system.mem_ranges[0]
-    system.mem_ctrl.port = system.membus.mem_side_ports
+    system.mem_ctrls = make_memory_ctrls(memory_plan(args, prefix="rv64-"), 0x80000000, args.rv64_mem_size)
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
 
     bootloader = Path(args.bootloader)
     initramfs = Path(args.initramfs)
@@ -416,7 +623,7 @@ def _build_rv64_system(args):
             workload.bootloader_filename = str(bootloader)
         else:
             workload.entry_point = workload.kernel_addr
-        workload.command_line = args.cmdline
+        workload.command_line = _rv64_cmdline(args)
         workload.dtb_addr = int(args.dtb_addr, 0)
         if has_initramfs:
             workload.initrd_filename = str(initramfs)
@@ -425,7 +632,7 @@ def _build_rv64_system(args):
     else:
         workload = RiscvLinux()
         workload.object_file = str(kernel_path)
-        workload.command_line = args.cmdline
+        workload.command_line = _rv64_cmdline(args)
         workload.dtb_addr = int(args.dtb_addr, 0)
         system.workload = workload
 
@@ -433,26 +640,55 @@ def _build_rv64_system(args):
 
 
 def _build_plan(args: argparse.Namespace) -> dict:
+    l1d_pf, l2_pf = _rv32_prefetchers(args)
     return {
         "target": "riscv_hybrid",
         "description": "one gem5 process for rv32_mixed + rv64_linux",
+        "tick_terminal": args.tick_terminal,
+        "hybrid_shm": _hybrid_shm_plan(args),
+        "host_attribution_period": args.host_attribution_period,
+        "stats_period": args.stats_period,
+        "stats": _stats_plan(args),
         "rv32": {
             "topology": {"clusters": 2, "cores": 6},
             "cpu_type": args.rv32_cpu_type,
+            "memory": memory_plan(args, prefix="rv32-"),
+            "shared_region": shared_region_plan(args),
+            "interconnect": {"xbars": xbar_plan(args, prefix="rv32-"), "comm_monitor": args.rv32_comm_monitor},
             "uart": {"cpu0": "UART0", "cpu1": "UART1", "cpu2-5": "UART2"},
+            "prefetchers": {
+                name: {"l1d": l1d_pf[idx], "l2": l2_pf[idx]} for idx, name in enumerate(RV32_CLUSTERS)
+            },
         },
         "rv64": {
             "topology": {"clusters": 1, "cores": args.rv64_num_cpus},
             "cpu_type": args.rv64_cpu_type,
+            "memory": memory_plan(args, prefix="rv64-"),
+            "xbars": xbar_plan(args, prefix="rv64-"),
             "workload": {
                 "kernel": args.kernel,
                 "bootloader": args.bootloader,
                 "initramfs": args.initramfs,
+                "cmdline": _rv64_cmdline(args),
             },
         },
     }
 
 
+def _simulate(args: argparse.Namespace):
+    """Run to --max-ticks, dumping cumulative stats every --stats-period or --host-attribution-period.
+
+    With both set, the shorter period wins: scripts/host_attribution.py and
+    scripts/stats_series.py both diff whatever consecutive dumps exist.
+    """
+    periods = [period for period in (args.stats_period, args.host_attribution_period) if period > 0]
+    return simulate_in_slices(args.max_ticks, min(periods) if periods else 0)
+
+
+def _stats_plan(args: argparse.Namespace) -> dict:
+    return stats_profile_plan(args, HOST_ATTRIBUTION_STATS if args.host_attribution_period else ())
+
+
 def _run_gem5_runtime(args: argparse.Namespace) -> int:
     import m5  # type: ignore
     from m5.objects import Root  # type: ignore
@@ -462,12 +698,15 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
         if not Path(path).exists():
             raise FileNotFoundError(f"missing file: {path}")
 
+    shm = _hybrid_shm_plan(args)
     system32 = _build_rv32_system(args)
     system64 = _build_rv64_system(args)
+    if shm["enabled"]:
+        system64.hybrid_shm_mapper.mem_side_port = system32.membus.cpu_side_ports
 
     dtb_path = Path(m5.options.outdir) / "system64.device.dtb"
     if not dtb_path.exists():
-        _generate_dtb(system64, str(dtb_path), args.cmdline)
+        _generate_dtb(system64, str(dtb_path), _rv64_cmdline(args), shm)
     system64.workload.dtb_filename = str(dtb_path)
 
     root = Root(full_system=True)
@@ -480,15 +719,27 @@ def _run_gem5_runtime(args: argparse.Namespace) -> int:
         "rv32_cores=6",
         f"rv64_cores={args.rv64_num_cpus}",
         f"max_ticks={args.max_ticks}",
+        f"host_attribution_period={args.host_attribution_period}",
+        f"stats_period={args.stats_period}",
+        f"stats={args.stats_profile}/{args.stats_format}",
     )
+    if shm["enabled"]:
+        print(
+            "[INFO] hybrid shm:",
+            f"system32@0x{shm['rv32_base']:x}",
+            f"system64@0x{shm['rv64_base']:x}",
+            f"size=0x{shm['size']:x}",
+            f"responder={shm['responder']}",
+        )
     print(
         "[INFO] uart map:",
         "system32: UART0(cpu0), UART1(cpu1), UART2(cpu2-5)",
         "system64: UART(shared)",
     )
 
+    apply_stats_profile(_stats_plan(args), m5.options.outdir)
     m5.instantiate()
-    exit_event = m5.simulate(args.max_ticks)
+    exit_event = _simulate(args)
     cause = exit_event.getCause()
     tick = m5.curTick()
     print(f"[INFO] gem5 exit cause: {cause}")
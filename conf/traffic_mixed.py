@@ -0,0 +1,370 @@
+#!/usr/bin/env python3
+"""riscv32_mixed memory system driven by synthetic traffic instead of harts.
+
+The cluster crossbars, L2s, optional shared LLC, membus, memory segments and
+memory controllers come from the same options and helpers as
+conf/riscv32_mixed.py (`add_layout_arguments`, `attach_cluster_l2s`), so a
+layout characterised here is the layout the Zephyr images run on. Each hart
+is replaced by a PyTrafficGen (`system.tgen<N>`), behind its hart's private
+L1D unless `--gen-l1d off`:
+
+- `--patterns`: linear, random, dram (DRAM-aware: `--dram-seq-pkts` packets
+  per row, spread over every bank) or idle, one name or one per cluster
+- `--read-pct`: read share in percent, the rest are writes
+- `--period-ticks`: ticks between requests (block size / period is the
+  offered load of one generator)
+- `--targets`: own (the hart's image segment, split between the harts that
+  share it) or shared (the shared IPC segment, split between all its
+  generators)
+
+Every generator runs for `--duration-ticks`, then an exit state ends the run.
+A CommMonitor between each generator and its first hop
+(`system.tgen<N>_monitor`) gives per-generator latency histograms. No ISA,
+platform devices or guest software are simulated.
+
+This script supports:
+- plain Python mode (`--print-json`) for dry-run planning
+- gem5 runtime mode when executed by gem5 binary
+"""
+
+import argparse
+import json
+from pathlib import Path
+from typing import Dict, List
+
+from omx_gem5 import (
+    add_stats_period_arguments,
+    add_stats_profile_arguments,
+    apply_stats_profile,
+    configure_xbar,
+    make_comm_monitor,
+    make_memory_ctrls,
+    make_scratchpad,
+    memory_plan,
+    parse_cluster_spec,
+    shared_region_plan,
+    simulate_in_slices,
+    stats_profile_plan,
+    xbar_plan,
+)
+from omx_topology import hart_clusters
+from riscv32_mixed import (
+    _cluster_l2_size,
+    _cluster_names,
+    _cluster_prefetchers,
+    add_layout_arguments,
+    attach_cluster_l2s,
+    layout_topology,
+)
+
+PATTERNS = ("linear", "random", "dram", "idle")
+TARGETS = ("own", "shared")
+TRAFFIC_SIDECAR = "traffic_mixed.json"
+# Generator byte counters behind run_gem5.py's traffic_ok check, kept under a reduced --stats-profile.
+TRAFFIC_STATS = ("system.tgen*.bytesRead", "system.tgen*.bytesWritten")
+# gem5 DRAM interface address mappings; the dram pattern must use the controller's.
+DRAM_ADDR_MAPS = ("RoRaBaChCo", "RoRaBaCoCh", "RoCoRaBaCh")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="riscv32_mixed cluster/L2/xbar/memory layout driven by PyTrafficGen generators",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    add_layout_arguments(p)
+    p.add_argument(
+        "--patterns",
+        default="linear",
+        help=f"{'|'.join(PATTERNS)}, or one per cluster (e.g. linear,random)",
+    )
+    p.add_argument("--read-pct", default="100", help="read share 0-100, or one per cluster (e.g. 100,70)")
+    p.add_argument("--period-ticks", default="1000", help="ticks between requests, or one per cluster")
+    p.add_argument("--targets", default="own", help=f"{'|'.join(TARGETS)}, or one per cluster")
+    p.add_argument("--block-size", type=int, default=64, help="bytes per request")
+    p.add_argument("--duration-ticks", type=int, default=100_000_000)
+    add_stats_period_arguments(p)
+    add_stats_profile_arguments(p)
+    p.add_argument(
+        "--gen-l1d",
+        choices=["on", "off"],
+        default="on",
+        help="keep each hart's L1D in front of its generator",
+    )
+    p.add_argument("--dram-seq-pkts", type=int, default=1, help="dram pattern: sequential packets per row")
+    p.add_argument("--dram-addr-map", choices=DRAM_ADDR_MAPS, default="RoRaBaCoCh")
+    p.add_argument("--print-json", action="store_true")
+    return p
+
+
+def _cluster_ints(value: str, clusters: List[str], option: str, low: int, high: int) -> List[int]:
+    """parse_cluster_spec for integers in [low, high]."""
+    items = [item.strip() for item in value.split(",") if item.strip()]
+    if len(items) == 1:
+        items = items * len(clusters)
+    if len(items) != len(clusters):
+        raise ValueError(
+            f"{option} expects 1 or {len(clusters)} comma-separated values ({', '.join(clusters)}), got {value!r}"
+        )
+    out = []
+    for item in items:
+        number = int(item, 0)
+        if not low <= number <= high:
+            raise ValueError(f"{option}: {number} outside {low}..{high}")
+        out.append(number)
+    return out
+
+
+def build_plan(args: argparse.Namespace) -> Dict[str, object]:
+    topology = layout_topology(args)
+    names = _cluster_names(topology)
+    patterns = parse_cluster_spec(args.patterns, names, "--patterns", PATTERNS)
+    read_pct = _cluster_ints(args.read_pct, names, "--read-pct", 0, 100)
+    periods = _cluster_ints(args.period_ticks, names, "--period-ticks", 1, 1 << 40)
+    targets = parse_cluster_spec(args.targets, names, "--targets", TARGETS)
+    if args.block_size < 1 or args.block_size & (args.block_size - 1):
+        raise ValueError(f"--block-size must be a power of two, got {args.block_size}")
+    if args.duration_ticks < 1 or args.dram_seq_pkts < 1:
+        raise ValueError("--duration-ticks and --dram-seq-pkts must be positive")
+    mem = memory_plan(args)
+    if "dram" in patterns and mem["type"] == "simple":
+        raise ValueError("--patterns dram needs a DRAM --mem-type (ddr3, ddr4, lpddr5, hbm)")
+    shared_region = shared_region_plan(args)
+    if not shared_region["cacheable"]:
+        raise ValueError("--shared-cacheable off is a hart PMA setting; generators have no PMA checker")
+    _, l2_pf = _cluster_prefetchers(args, topology)
+    l2s = [
+        {"size": _cluster_l2_size(args, cluster), "assoc": args.l2_assoc, "prefetcher": l2_pf[int(cluster["index"])]}
+        for cluster in topology["clusters"]
+    ]
+
+    segments = {str(seg["name"]): seg for seg in topology["memory_segments"]}
+    image_of_hart = {hart: str(image["name"]) for image in topology["images"] for hart in image["harts"]}
+    hart_cluster = hart_clusters(topology)
+    # Generators aimed at one segment each get an equal, 4 KiB-aligned slice of it.
+    owners: Dict[str, List[int]] = {}
+    for hart in range(int(topology["num_harts"])):
+        idx = hart_cluster[hart]
+        if patterns[idx] == "idle":
+            continue
+        segment = image_of_hart[hart] if targets[idx] == "own" else "shared"
+        owners.setdefault(segment, []).append(hart)
+
+    generators: List[Dict[str, object]] = []
+    for hart in range(int(topology["num_harts"])):
+        idx = hart_cluster[hart]
+        gen: Dict[str, object] = {
+            "name": f"tgen{hart}",
+            "hart": hart,
+            "cluster": names[idx],
+            "pattern": patterns[idx],
+            "read_pct": read_pct[idx],
+            "period_ticks": periods[idx],
+            "block_size": args.block_size,
+            # Ticks are picoseconds.
+            "offered_bytes_per_sec": 0.0 if patterns[idx] == "idle" else args.block_size * 1e12 / periods[idx],
+        }
+        for segment, harts in owners.items():
+            if hart in harts:
+                base, size = int(segments[segment]["base"]), int(segments[segment]["size"])
+                slice_size = size // len(harts) // 4096 * 4096
+                if slice_size < args.block_size:
+                    raise ValueError(f"segment {segment} too small for {len(harts)} generators")
+                start = base + harts.index(hart) * slice_size
+                gen.update(segment=segment, min_addr=start, max_addr=start + slice_size)
+        generators.append(gen)
+
+    return {
+        "target": "traffic_mixed",
+        "topology": {
+            "name": topology["name"],
+            "source": topology["source"],
+            "clusters": len(names),
+            "generators": len(generators),
+        },
+        "duration_ticks": args.duration_ticks,
+        "stats_period": args.stats_period,
+        "stats": stats_profile_plan(args, TRAFFIC_STATS),
+        "gen_l1d": args.gen_l1d == "on",
+        "l1d": {"size": args.l1d_size, "assoc": args.l1_assoc},
+        "clusters": [
+            {
+                "name": names[int(cluster["index"])],
+                "index": int(cluster["index"]),
+                "l2": l2s[int(cluster["index"])],
+                "generators": [f"tgen{hart}" for hart in cluster["harts"]],
+            }
+            for cluster in topology["clusters"]
+        ],
+        "generators": generators,
+        "dram": {"seq_pkts": args.dram_seq_pkts, "addr_map": args.dram_addr_map} if "dram" in patterns else None,
+        "memory_segments": [
+            {"name": str(seg["name"]), "base": int(seg["base"]), "size": int(seg["size"]), "image": seg["image"]}
+            for seg in topology["memory_segments"]
+        ],
+        "memory": mem,
+        "shared_region": shared_region,
+        "shared_llc": (
+            {"size": args.llc_size, "assoc": args.llc_assoc, "inclusion": args.llc_inclusion}
+            if args.shared_llc
+            else None
+        ),
+        "interconnect": {"xbars": xbar_plan(args), "comm_monitor": args.comm_monitor},
+    }
+
+
+def _has_gem5_runtime() -> bool:
+    try:
+        import m5  # noqa: F401
+    except Exception:
+        return False
+    return True
+
+
+def _states(gen, spec: Dict[str, object], duration: int, dram: Dict[str, object]):
+    """State sequence for PyTrafficGen.start(): the pattern for `duration`, then exit."""
+    if spec["pattern"] == "idle":
+        yield gen.createIdle(duration)
+    else:
+        common = (
+            spec["min_addr"],
+            spec["max_addr"],
+            spec["block_size"],
+            spec["period_ticks"],
+            spec["period_ticks"],
+            spec["read_pct"],
+            0,
+        )
+        if spec["pattern"] == "linear":
+            yield gen.createLinear(duration, *common)
+        elif spec["pattern"] == "random":
+            yield gen.createRandom(duration, *common)
+        else:
+            yield gen.createDram(
+                duration,
+                *common,
+                dram["seq_pkts"],
+                dram["page_size"],
+                dram["banks"],
+                dram["banks"],
+                dram["addr_map"],
+                dram["ranks"],
+            )
+    yield gen.createExit(0)
+
+
+def _run_gem5_runtime(args: argparse.Namespace) -> int:
+    import m5  # type: ignore
+    from m5.objects import AddrMap, AddrRange, PyTrafficGen, Root, SrcClockDomain, System  # type: ignore
+    from m5.objects import SystemXBar, VoltageDomain  # type: ignore
+    from m5.util import addToPath  # type: ignore
+
+    repo_root = Path(__file__).resolve().parents[1]
+    addToPath(str(repo_root / "sources" / "gem5" / "configs"))
+    from common.Caches import L1_DCache  # type: ignore
+
+    plan = build_plan(args)
+    topology = layout_topology(args)
+    shared_region = plan["shared_region"]
+
+    system = System()
+    system.voltage_domain = VoltageDomain(voltage="1.0V")
+    system.clk_domain = SrcClockDomain(clock="1GHz", voltage_domain=system.voltage_domain)
+    system.mem_mode = "timing"
+    system.cache_line_size = 64
+    system.mem_ranges = [AddrRange(start=seg["base"], size=seg["size"]) for seg in plan["memory_segments"]]
+
+    # Same controllers as riscv32_mixed: image segments stay on one channel.
+    mem_ctrls = []
+    for seg in plan["memory_segments"]:
+        if seg["name"] == "shared" and shared_region["backing"] == "sram":
+            continue
+        seg_plan = dict(plan["memory"], channels=1) if seg["image"] else plan["memory"]
+        mem_ctrls.extend(make_memory_ctrls(seg_plan, seg["base"], seg["size"]))
+    system.mem_ctrls = mem_ctrls
+
+    system.membus = configure_xbar(SystemXBar(), plan["interconnect"]["xbars"]["membus"])
+    system.system_port = system.membus.cpu_side_ports
+    for ctrl in system.mem_ctrls:
+        ctrl.port = system.membus.mem_side_ports
+    if shared_region["backing"] == "sram":
+        shared = next(seg for seg in plan["memory_segments"] if seg["name"] == "shared")
+        system.scratchpad_bus, system.scratchpad = make_scratchpad(shared_region, shared["base"], shared["size"])
+        system.scratchpad_bus.cpu_side_ports = system.membus.mem_side_ports
+
+    cluster_buses = attach_cluster_l2s(args, system, topology)
+    hart_cluster = hart_clusters(topology)
+    gens = []
+    for spec in plan["generators"]:
+        hart = int(spec["hart"])
+        gen = PyTrafficGen()
+        setattr(system, spec["name"], gen)
+        downstream = cluster_buses[hart_cluster[hart]].cpu_side_ports
+        if plan["gen_l1d"]:
+            l1d = L1_DCache(size=plan["l1d"]["size"], assoc=plan["l1d"]["assoc"])
+            setattr(system, f"{spec['name']}_l1d", l1d)
+            l1d.mem_side = downstream
+            downstream = l1d.cpu_side
+        # stats: system.tgen<N>_monitor.{read,write}LatencyHist
+        monitor = make_comm_monitor(downstream)
+        setattr(system, f"{spec['name']}_monitor", monitor)
+        gen.port = monitor.cpu_side_port
+        gens.append(gen)
+
+    dram: Dict[str, object] = {}
+    if plan["dram"]:
+        # One interface stands for all: every DRAM controller has the same geometry.
+        iface = next(ctrl.dram for ctrl in system.mem_ctrls if hasattr(ctrl, "dram"))
+        dram = dict(
+            plan["dram"],
+            page_size=int(iface.devices_per_rank.value * iface.device_rowbuffer_size.value),
+            banks=int(iface.banks_per_rank.value),
+            ranks=int(iface.ranks_per_channel.value),
+        )
+        dram["addr_map"] = AddrMap.map[plan["dram"]["addr_map"]]
+
+    root = Root(full_system=False, system=system)
+    print(
+        "[INFO] traffic launch:",
+        f"topology={plan['topology']['name']}",
+        f"generators={len(gens)}",
+        *(
+            f"{spec['name']}={spec['pattern']}/r{spec['read_pct']}/p{spec['period_ticks']}@{spec.get('segment', '-')}"
+            for spec in plan["generators"]
+        ),
+        f"gen_l1d={'on' if plan['gen_l1d'] else 'off'}",
+        f"mem={plan['memory']['type']}x{plan['memory']['channels']}",
+        f"shared_llc={args.llc_size if args.shared_llc else 'off'}",
+        f"duration_ticks={plan['duration_ticks']}",
+        f"stats_period={args.stats_period}",
+        f"stats={args.stats_profile}/{args.stats_format}",
+    )
+
+    apply_stats_profile(plan["stats"], m5.options.outdir)
+    m5.instantiate()
+    for gen, spec in zip(gens, plan["generators"]):
+        gen.start(_states(gen, spec, plan["duration_ticks"], dram))
+    # The exit states end the run; the limit only guards against a stuck one.
+    exit_event = simulate_in_slices(2 * plan["duration_ticks"], args.stats_period)
+    cause = exit_event.getCause()
+    tick = m5.curTick()
+    print(f"[INFO] gem5 exit cause: {cause}")
+    print(f"[INFO] gem5 exit tick: {tick}")
+    (Path(m5.options.outdir) / TRAFFIC_SIDECAR).write_text(
+        json.dumps(dict(plan, exit_cause=cause, exit_tick=tick), indent=2) + "\n", encoding="utf-8"
+    )
+    return 1 if "simulate() limit reached" in cause else 0
+
+
+def main() -> int:
+    args = parser().parse_args()
+    plan = build_plan(args)
+
+    if args.print_json or not _has_gem5_runtime():
+        print(json.dumps(plan, indent=2))
+        return 0
+
+    return _run_gem5_runtime(args)
+
+
+if __name__ in {"__main__", "__m5_main__"}:
+    raise SystemExit(main())
@@ -0,0 +1,28 @@
+from m5.objects.Device import BasicPioDevice
+from m5.params import *
+from m5.proxy import *
+
+
+class OmxDvfsCtrl(BasicPioDevice):
+    """Guest-visible DVFS register block in front of the system DVFSHandler.
+
+    Register map (32-bit, little endian):
+      0x00 ID               RO  0x4f4d5844 ("OMXD")
+      0x04 NUM_DOMAINS      RO  domains registered with the DVFS handler
+      0x08 DOMAIN_SEL       RW  domain index used by the registers below
+      0x0c NUM_PERF_LEVELS  RO  operating points of the selected domain
+      0x10 PERF_LEVEL       RW  read: current level, write: request level
+      0x14 CUR_FREQ_KHZ     RO  frequency of the current level
+      0x18 LEVEL_SEL        RW  level index for the two table registers
+      0x1c LEVEL_FREQ_KHZ   RO  frequency of LEVEL_SEL
+      0x20 LEVEL_VOLTAGE_MV RO  voltage of LEVEL_SEL
+      0x24 TRANS_LATENCY_NS RO  DVFS handler transition latency
+    Level 0 is the fastest operating point.
+    """
+
+    type = "OmxDvfsCtrl"
+    cxx_header = "omx/dvfs_ctrl.hh"
+    cxx_class = "gem5::OmxDvfsCtrl"
+
+    dvfs_handler = Param.DVFSHandler(Parent.dvfs_handler, "DVFS handler")
+    pio_size = Param.Addr(0x1000, "Size of the register window")
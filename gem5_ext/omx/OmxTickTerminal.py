@@ -0,0 +1,29 @@
+from m5.objects.Serial import SerialDevice
+from m5.params import *
+
+
+class OmxTickTerminal(SerialDevice):
+    """Capture-only console backend that stamps every line with its tick.
+
+    Drop-in for Terminal behind a Uart8250 (no telnet port, no guest input).
+    Outputs, in the gem5 output directory:
+      <name>            plain bytes, like Terminal's capture file
+      <name>.ticks      text_ticks: "<tick>: <name>: <line>" per line (the
+                        layout of the Terminal debug flag), flushed per line
+      <name>.ticks.bin  binary_ticks: header "OMXT", u32 version (1),
+                        u32 name length, name; then one record per line:
+                        u64 tick, u32 length, line bytes (little endian)
+    A line is stamped with the tick of its first byte; CR is dropped from the
+    stamped copies. Without text_ticks the plain file is buffered together
+    with the binary records and written every flush_bytes and at exit, so the
+    capture costs no per-byte file writes.
+    """
+
+    type = "OmxTickTerminal"
+    cxx_header = "omx/tick_terminal.hh"
+    cxx_class = "gem5::OmxTickTerminal"
+
+    text_ticks = Param.Bool(True, "Write <name>.ticks (one stamped text line per console line)")
+    binary_ticks = Param.Bool(False, "Write <name>.ticks.bin (buffered binary records)")
+    flush_bytes = Param.Unsigned(65536, "Buffered bytes that trigger a write (binary-only mode)")
+    max_line = Param.Unsigned(4096, "Stamp and start a new record after this many bytes")
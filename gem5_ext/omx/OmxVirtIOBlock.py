@@ -0,0 +1,24 @@
+from m5.objects.VirtIO import VirtIODeviceBase
+from m5.params import *
+
+
+class OmxVirtIOBlock(VirtIODeviceBase):
+    """virtio-blk device with a backend timing model.
+
+    Same guest interface as VirtIOBlock (read/write, no optional features),
+    but a request completes no earlier than `latency` after the guest
+    submits it, and no earlier than its transfer through one shared
+    `bandwidth` channel: finish = max(now + latency, channel_free + bytes /
+    bandwidth). Latency overlaps across queued requests and bandwidth does
+    not, roughly a device with deep internal parallelism behind one link.
+    Data moves at submission; only the used-ring completion is delayed.
+    """
+
+    type = "OmxVirtIOBlock"
+    cxx_header = "omx/virtio_block.hh"
+    cxx_class = "gem5::OmxVirtIOBlock"
+
+    queueSize = Param.Unsigned(128, "Request queue size (descriptors)")
+    image = Param.DiskImage("Disk image")
+    latency = Param.Latency("0ns", "Per-request access latency")
+    bandwidth = Param.MemoryBandwidth("1TiB/s", "Backend transfer rate (default: effectively unlimited)")
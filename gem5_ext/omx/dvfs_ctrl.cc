@@ -0,0 +1,237 @@
+#include "omx/dvfs_ctrl.hh"
+
+#include <algorithm>
+#include <string>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/OmxDvfsCtrl.hh"
+#include "mem/packet_access.hh"
+#include "sim/core.hh"
+#include "sim/serialize.hh"
+
+namespace gem5
+{
+
+OmxDvfsCtrl::OmxDvfsCtrl(const Params &p)
+    : BasicPioDevice(p, p.pio_size),
+      dvfsHandler(p.dvfs_handler),
+      stats(this)
+{
+    fatal_if(!dvfsHandler, "%s: needs a DVFS handler", name());
+}
+
+bool
+OmxDvfsCtrl::domainValid() const
+{
+    return domainSel < dvfsHandler->numDomains();
+}
+
+DVFSHandler::DomainID
+OmxDvfsCtrl::selectedDomain() const
+{
+    return dvfsHandler->domainID(domainSel);
+}
+
+uint32_t
+OmxDvfsCtrl::freqKHz(DVFSHandler::DomainID domain, uint32_t level) const
+{
+    const Tick period = dvfsHandler->clkPeriodAtPerfLevel(domain, level);
+    return period ? static_cast<uint32_t>(sim_clock::Frequency / period / 1000) : 0;
+}
+
+void
+OmxDvfsCtrl::regStats()
+{
+    BasicPioDevice::regStats();
+
+    const uint32_t domains = dvfsHandler->numDomains();
+    uint32_t max_levels = 1;
+    for (uint32_t i = 0; i < domains; ++i) {
+        max_levels = std::max<uint32_t>(
+            max_levels, dvfsHandler->numPerfLevels(dvfsHandler->domainID(i)));
+    }
+
+    stats.ticksAtLevel.init(std::max<uint32_t>(domains, 1), max_levels);
+    stats.transitions.init(std::max<uint32_t>(domains, 1));
+    for (uint32_t i = 0; i < domains; ++i) {
+        const std::string domain_name =
+            "domain" + std::to_string(dvfsHandler->domainID(i));
+        stats.ticksAtLevel.subname(i, domain_name);
+        stats.transitions.subname(i, domain_name);
+    }
+    for (uint32_t level = 0; level < max_levels; ++level)
+        stats.ticksAtLevel.ysubname(level, "level" + std::to_string(level));
+}
+
+void
+OmxDvfsCtrl::startup()
+{
+    BasicPioDevice::startup();
+
+    const uint32_t domains = dvfsHandler->numDomains();
+    if (!restored || accountedLevel.size() != domains ||
+        levelSince.size() != domains) {
+        accountedLevel.resize(domains);
+        levelSince.assign(domains, curTick());
+        for (uint32_t i = 0; i < domains; ++i)
+            accountedLevel[i] =
+                dvfsHandler->perfLevel(dvfsHandler->domainID(i));
+    }
+
+    // Flush the open intervals so every dump sees up-to-date residency.
+    statistics::registerDumpCallback([this]() { accountAll(); });
+    // A reset zeroes ticksAtLevel; restart the open intervals with it so the
+    // next dump does not credit residency from before the reset.
+    statistics::registerResetCallback([this]() {
+        std::fill(levelSince.begin(), levelSince.end(), curTick());
+    });
+}
+
+void
+OmxDvfsCtrl::account(uint32_t domain_index)
+{
+    const Tick now = curTick();
+    stats.ticksAtLevel[domain_index][accountedLevel[domain_index]] +=
+        now - levelSince[domain_index];
+    levelSince[domain_index] = now;
+}
+
+void
+OmxDvfsCtrl::accountAll()
+{
+    for (uint32_t i = 0; i < accountedLevel.size(); ++i)
+        account(i);
+}
+
+uint32_t
+OmxDvfsCtrl::regRead(Addr offset) const
+{
+    switch (offset) {
+      case ID:
+        return idValue;
+      case NUM_DOMAINS:
+        return dvfsHandler->numDomains();
+      case DOMAIN_SEL:
+        return domainSel;
+      case NUM_PERF_LEVELS:
+        return domainValid() ? dvfsHandler->numPerfLevels(selectedDomain()) : 0;
+      case PERF_LEVEL:
+        return domainValid() ? dvfsHandler->perfLevel(selectedDomain()) : 0;
+      case CUR_FREQ_KHZ:
+        return domainValid()
+            ? freqKHz(selectedDomain(), dvfsHandler->perfLevel(selectedDomain()))
+            : 0;
+      case LEVEL_SEL:
+        return levelSel;
+      case LEVEL_FREQ_KHZ:
+        if (!domainValid() || levelSel >= dvfsHandler->numPerfLevels(selectedDomain()))
+            return 0;
+        return freqKHz(selectedDomain(), levelSel);
+      case LEVEL_VOLTAGE_MV:
+        if (!domainValid() || levelSel >= dvfsHandler->numPerfLevels(selectedDomain()))
+            return 0;
+        return static_cast<uint32_t>(
+            dvfsHandler->voltageAtPerfLevel(selectedDomain(), levelSel) * 1000.0);
+      case TRANS_LATENCY_NS:
+        return static_cast<uint32_t>(dvfsHandler->transLatency() / sim_clock::as_int::ns);
+      default:
+        warn("%s: read from unknown register %#x\n", name(), offset);
+        return 0;
+    }
+}
+
+void
+OmxDvfsCtrl::requestPerfLevel(uint32_t level)
+{
+    if (!domainValid() || level >= dvfsHandler->numPerfLevels(selectedDomain())) {
+        warn("%s: rejected perf level %u for domain index %u\n", name(), level, domainSel);
+        stats.rejected++;
+        return;
+    }
+
+    // The DVFS handler applies the change after its transition latency;
+    // residency switches at request time, which is within that latency.
+    account(domainSel);
+    if (!dvfsHandler->perfLevel(selectedDomain(), level)) {
+        stats.rejected++;
+        return;
+    }
+    accountedLevel[domainSel] = level;
+    stats.transitions[domainSel]++;
+    DPRINTF(OmxDvfsCtrl, "domain %u -> level %u (%u kHz)\n",
+            selectedDomain(), level, freqKHz(selectedDomain(), level));
+}
+
+void
+OmxDvfsCtrl::regWrite(Addr offset, uint32_t value)
+{
+    switch (offset) {
+      case DOMAIN_SEL:
+        domainSel = value;
+        break;
+      case LEVEL_SEL:
+        levelSel = value;
+        break;
+      case PERF_LEVEL:
+        requestPerfLevel(value);
+        break;
+      default:
+        warn("%s: write to read-only/unknown register %#x\n", name(), offset);
+        break;
+    }
+}
+
+Tick
+OmxDvfsCtrl::read(PacketPtr pkt)
+{
+    const Addr offset = pkt->getAddr() - pioAddr;
+    panic_if(pkt->getSize() != 4, "%s: only 32-bit accesses are supported", name());
+
+    pkt->setLE<uint32_t>(regRead(offset));
+    pkt->makeResponse();
+    return pioDelay;
+}
+
+Tick
+OmxDvfsCtrl::write(PacketPtr pkt)
+{
+    const Addr offset = pkt->getAddr() - pioAddr;
+    panic_if(pkt->getSize() != 4, "%s: only 32-bit accesses are supported", name());
+
+    regWrite(offset, pkt->getLE<uint32_t>());
+    pkt->makeResponse();
+    return pioDelay;
+}
+
+void
+OmxDvfsCtrl::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(domainSel);
+    SERIALIZE_SCALAR(levelSel);
+    SERIALIZE_CONTAINER(accountedLevel);
+    SERIALIZE_CONTAINER(levelSince);
+}
+
+void
+OmxDvfsCtrl::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_SCALAR(domainSel);
+    UNSERIALIZE_SCALAR(levelSel);
+    UNSERIALIZE_CONTAINER(accountedLevel);
+    UNSERIALIZE_CONTAINER(levelSince);
+    restored = true;
+}
+
+OmxDvfsCtrl::DvfsCtrlStats::DvfsCtrlStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(ticksAtLevel, statistics::units::Tick::get(),
+               "Ticks spent at each perf level, per clock domain"),
+      ADD_STAT(transitions, statistics::units::Count::get(),
+               "Accepted perf level changes per clock domain"),
+      ADD_STAT(rejected, statistics::units::Count::get(),
+               "Rejected perf level requests")
+{
+}
+
+} // namespace gem5
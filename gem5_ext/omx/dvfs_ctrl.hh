@@ -0,0 +1,93 @@
+/*
+ * Guest-visible DVFS control block for the riscv-gem5 platforms.
+ *
+ * Forwards perf-level requests to the system DVFSHandler and keeps
+ * time-at-level statistics per clock domain. See OmxDvfsCtrl.py for the
+ * register map.
+ */
+
+#ifndef __OMX_DVFS_CTRL_HH__
+#define __OMX_DVFS_CTRL_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "dev/io_device.hh"
+#include "params/OmxDvfsCtrl.hh"
+#include "sim/dvfs_handler.hh"
+
+namespace gem5
+{
+
+class OmxDvfsCtrl : public BasicPioDevice
+{
+  public:
+    enum Register : Addr
+    {
+        ID = 0x00,
+        NUM_DOMAINS = 0x04,
+        DOMAIN_SEL = 0x08,
+        NUM_PERF_LEVELS = 0x0c,
+        PERF_LEVEL = 0x10,
+        CUR_FREQ_KHZ = 0x14,
+        LEVEL_SEL = 0x18,
+        LEVEL_FREQ_KHZ = 0x1c,
+        LEVEL_VOLTAGE_MV = 0x20,
+        TRANS_LATENCY_NS = 0x24,
+    };
+
+    static constexpr uint32_t idValue = 0x4f4d5844; // "OMXD"
+
+    PARAMS(OmxDvfsCtrl);
+    OmxDvfsCtrl(const Params &p);
+
+    Tick read(PacketPtr pkt) override;
+    Tick write(PacketPtr pkt) override;
+
+    void regStats() override;
+    void startup() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+  private:
+    DVFSHandler *dvfsHandler;
+
+    uint32_t domainSel = 0;
+    uint32_t levelSel = 0;
+
+    /** Per domain index: level being accounted and since when. */
+    std::vector<uint32_t> accountedLevel;
+    std::vector<Tick> levelSince;
+    /** Set by unserialize(): startup() keeps the restored intervals. */
+    bool restored = false;
+
+    bool domainValid() const;
+    DVFSHandler::DomainID selectedDomain() const;
+    uint32_t freqKHz(DVFSHandler::DomainID domain, uint32_t level) const;
+
+    /** Close the open time-at-level interval of one domain at curTick(). */
+    void account(uint32_t domain_index);
+    void accountAll();
+
+    uint32_t regRead(Addr offset) const;
+    void regWrite(Addr offset, uint32_t value);
+    void requestPerfLevel(uint32_t level);
+
+    struct DvfsCtrlStats : public statistics::Group
+    {
+        DvfsCtrlStats(statistics::Group *parent);
+
+        /** Ticks spent at [domain index][perf level]. */
+        statistics::Vector2d ticksAtLevel;
+        /** Accepted perf-level changes per domain index. */
+        statistics::Vector transitions;
+        /** Requests with a bad domain/level or while DVFS is disabled. */
+        statistics::Scalar rejected;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __OMX_DVFS_CTRL_HH__
@@ -0,0 +1,130 @@
+#include "omx/tick_terminal.hh"
+
+#include <ostream>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/OmxTickTerminal.hh"
+#include "sim/cur_tick.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+OmxTickTerminal::OmxTickTerminal(const Params &p)
+    : SerialDevice(p),
+      flushBytes(p.flush_bytes),
+      maxLine(p.max_line),
+      buffered(!p.text_ticks)
+{
+    fatal_if(!p.text_ticks && !p.binary_ticks,
+             "%s: enable text_ticks and/or binary_ticks (or use Terminal)", name());
+    fatal_if(maxLine == 0, "%s: max_line must be non-zero", name());
+
+    plainOut = simout.create(name());
+    if (p.text_ticks)
+        textOut = simout.create(name() + ".ticks");
+    if (p.binary_ticks) {
+        binOut = simout.create(name() + ".ticks.bin", true);
+        binPending.insert(binPending.end(), binMagic, binMagic + sizeof(binMagic));
+        appendU32(binVersion);
+        appendU32(static_cast<uint32_t>(name().size()));
+        binPending.insert(binPending.end(), name().begin(), name().end());
+    }
+
+    registerExitCallback([this]() { finish(); });
+}
+
+uint8_t
+OmxTickTerminal::readData()
+{
+    warn_once("%s: capture-only terminal has no input\n", name());
+    return 0;
+}
+
+void
+OmxTickTerminal::appendU32(uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+        binPending.push_back(static_cast<char>((value >> shift) & 0xff));
+}
+
+void
+OmxTickTerminal::appendU64(uint64_t value)
+{
+    for (int shift = 0; shift < 64; shift += 8)
+        binPending.push_back(static_cast<char>((value >> shift) & 0xff));
+}
+
+void
+OmxTickTerminal::writeData(uint8_t c)
+{
+    if (buffered)
+        plainPending.push_back(static_cast<char>(c));
+    else
+        plainOut->stream()->put(static_cast<char>(c));
+
+    if (c == '\n') {
+        endLine();
+        if (!buffered)
+            plainOut->stream()->flush();
+        return;
+    }
+    if (!lineOpen) {
+        lineTick = curTick();
+        lineOpen = true;
+    }
+    if (c != '\r')
+        line.push_back(static_cast<char>(c));
+    if (line.size() >= maxLine)
+        endLine();
+}
+
+void
+OmxTickTerminal::endLine()
+{
+    // A bare "\n" still marks a (blank) line at the tick it arrived.
+    if (!lineOpen)
+        lineTick = curTick();
+    DPRINTF(OmxTickTerminal, "%s\n", line);
+
+    if (textOut) {
+        *textOut->stream() << lineTick << ": " << name() << ": " << line << '\n';
+        textOut->stream()->flush();
+    }
+    if (binOut) {
+        appendU64(lineTick);
+        appendU32(static_cast<uint32_t>(line.size()));
+        binPending.insert(binPending.end(), line.begin(), line.end());
+    }
+    line.clear();
+    lineOpen = false;
+
+    if (plainPending.size() + binPending.size() >= flushBytes)
+        flush();
+}
+
+void
+OmxTickTerminal::flush()
+{
+    if (!plainPending.empty()) {
+        plainOut->stream()->write(plainPending.data(), plainPending.size());
+        plainOut->stream()->flush();
+        plainPending.clear();
+    }
+    if (binOut && !binPending.empty()) {
+        binOut->stream()->write(binPending.data(), binPending.size());
+        binOut->stream()->flush();
+        binPending.clear();
+    }
+}
+
+void
+OmxTickTerminal::finish()
+{
+    if (lineOpen)
+        endLine();
+    flush();
+}
+
+} // namespace gem5
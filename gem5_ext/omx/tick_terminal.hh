@@ -0,0 +1,68 @@
+/*
+ * Capture-only serial backend for the riscv-gem5 platforms.
+ *
+ * Replaces Terminal behind a Uart8250 and records every console line with
+ * the simulated tick of its first byte, as text and/or buffered binary
+ * records. See OmxTickTerminal.py for the file formats.
+ */
+
+#ifndef __OMX_TICK_TERMINAL_HH__
+#define __OMX_TICK_TERMINAL_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/types.hh"
+#include "dev/serial/serial.hh"
+#include "params/OmxTickTerminal.hh"
+
+namespace gem5
+{
+
+class OmxTickTerminal : public SerialDevice
+{
+  public:
+    static constexpr char binMagic[4] = {'O', 'M', 'X', 'T'};
+    static constexpr uint32_t binVersion = 1;
+
+    PARAMS(OmxTickTerminal);
+    OmxTickTerminal(const Params &p);
+
+    /** Capture only: the guest never sees input. */
+    bool dataAvailable() const override { return false; }
+    uint8_t readData() override;
+    void writeData(uint8_t c) override;
+
+  private:
+    const uint64_t flushBytes;
+    const uint64_t maxLine;
+    /** Plain bytes wait for the next flush instead of a per-line write. */
+    const bool buffered;
+
+    OutputStream *plainOut = nullptr;
+    OutputStream *textOut = nullptr;
+    OutputStream *binOut = nullptr;
+
+    /** Line being assembled and the tick of its first byte. */
+    std::string line;
+    Tick lineTick = 0;
+    bool lineOpen = false;
+
+    std::string plainPending;
+    std::vector<char> binPending;
+
+    void appendU32(uint32_t value);
+    void appendU64(uint64_t value);
+
+    /** Stamp the open line into the text/binary streams. */
+    void endLine();
+    void flush();
+    /** Exit callback: stamp a trailing partial line and flush everything. */
+    void finish();
+};
+
+} // namespace gem5
+
+#endif // __OMX_TICK_TERMINAL_HH__
@@ -0,0 +1,194 @@
+#include "omx/virtio_block.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/OmxVirtIOBlock.hh"
+#include "sim/cur_tick.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+OmxVirtIOBlock::OmxVirtIOBlock(const Params &p)
+    : VirtIODeviceBase(p, ID_BLOCK, sizeof(Config), 0),
+      qRequests(p.system->physProxy, byteOrder, p.queueSize, *this),
+      image(*p.image),
+      latency(p.latency),
+      ticksPerByte(p.bandwidth),
+      completeEvent([this]() { complete(); }, name() + ".complete"),
+      stats(this)
+{
+    registerQueue(qRequests);
+    config.capacity = image.size();
+}
+
+void
+OmxVirtIOBlock::readConfig(PacketPtr pkt, Addr cfgOffset)
+{
+    Config cfg_out;
+    cfg_out.capacity = htog(config.capacity, byteOrder);
+    readConfigBlob(pkt, cfgOffset, (uint8_t *)&cfg_out);
+}
+
+void
+OmxVirtIOBlock::reset()
+{
+    // The queues are being reset; completions of the old rings are dropped.
+    if (completeEvent.scheduled())
+        deschedule(completeEvent);
+    pending.clear();
+    channelFree = 0;
+    VirtIODeviceBase::reset();
+}
+
+DrainState
+OmxVirtIOBlock::drain()
+{
+    return pending.empty() ? DrainState::Drained : DrainState::Draining;
+}
+
+OmxVirtIOBlock::Status
+OmxVirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain, size_t off_data, size_t size)
+{
+    std::vector<uint8_t> data(size);
+    uint64_t sector = req.sector;
+
+    panic_if(size % SectorSize != 0, "%s: request size %u is not a sector multiple", name(), size);
+    for (Addr offset = 0; offset < size; offset += SectorSize) {
+        if (image.read(&data[offset], sector) != SectorSize) {
+            warn("%s: failed to read sector %u\n", name(), sector);
+            return S_IOERR;
+        }
+        ++sector;
+    }
+    desc_chain->chainWrite(off_data, data.data(), size);
+    return S_OK;
+}
+
+OmxVirtIOBlock::Status
+OmxVirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain, size_t off_data, size_t size)
+{
+    std::vector<uint8_t> data(size);
+    uint64_t sector = req.sector;
+
+    panic_if(size % SectorSize != 0, "%s: request size %u is not a sector multiple", name(), size);
+    desc_chain->chainRead(off_data, data.data(), size);
+    for (Addr offset = 0; offset < size; offset += SectorSize) {
+        if (image.write(&data[offset], sector) != SectorSize) {
+            warn("%s: failed to write sector %u\n", name(), sector);
+            return S_IOERR;
+        }
+        ++sector;
+    }
+    return S_OK;
+}
+
+OmxVirtIOBlock::RequestQueue::RequestQueue(PortProxy &proxy, ByteOrder bo, uint16_t size,
+                                           OmxVirtIOBlock &_parent)
+    : VirtQueue(proxy, bo, size), parent(_parent)
+{
+}
+
+void
+OmxVirtIOBlock::RequestQueue::onNotifyDescriptor(VirtDescriptor *desc)
+{
+    BlkRequest req;
+    desc->chainRead(0, (uint8_t *)&req, sizeof(req));
+    req.type = gtoh(req.type, byteOrder);
+    req.sector = gtoh(req.sector, byteOrder);
+
+    const size_t data_size = desc->chainSize() - sizeof(BlkRequest) - sizeof(Status);
+    Status status;
+    switch (req.type) {
+      case T_IN:
+        status = parent.read(req, desc, sizeof(BlkRequest), data_size);
+        break;
+      case T_OUT:
+        status = parent.write(req, desc, sizeof(BlkRequest), data_size);
+        break;
+      default:
+        status = S_UNSUPP;
+        break;
+    }
+    desc->chainWrite(sizeof(BlkRequest) + data_size, &status, sizeof(status));
+    parent.submit(desc, sizeof(BlkRequest) + data_size + sizeof(Status),
+                  status == S_OK ? data_size : 0, req.type == T_OUT);
+}
+
+void
+OmxVirtIOBlock::submit(VirtDescriptor *desc, uint32_t len, size_t bytes, bool write)
+{
+    const Tick now = curTick();
+    const Tick transfer = static_cast<Tick>(std::ceil(ticksPerByte * bytes));
+    channelFree = std::max(channelFree, now) + transfer;
+    // Both terms grow with submission order, so pending stays sorted by finish.
+    const Tick finish = std::max(now + latency, channelFree);
+
+    DPRINTF(OmxVirtIOBlock, "%s %u bytes, completes in %llu ticks\n",
+            write ? "write" : "read", bytes, finish - now);
+    pending.push_back({desc, len, now, finish, write});
+    stats.inflight = pending.size();
+    if (write) {
+        ++stats.writeReqs;
+        stats.writeBytes += bytes;
+    } else {
+        ++stats.readReqs;
+        stats.readBytes += bytes;
+    }
+    if (!completeEvent.scheduled())
+        schedule(completeEvent, std::max(finish, now));
+}
+
+void
+OmxVirtIOBlock::complete()
+{
+    const Tick now = curTick();
+    bool produced = false;
+    while (!pending.empty() && pending.front().finish <= now) {
+        const Completion &done = pending.front();
+        const Tick service = now - done.submitted;
+        (done.write ? stats.writeTicks : stats.readTicks) += service;
+        stats.serviceTicks.sample(service);
+        qRequests.produceDescriptor(done.desc, done.len);
+        pending.pop_front();
+        produced = true;
+    }
+    stats.inflight = pending.size();
+    if (produced)
+        kick();
+
+    if (!pending.empty())
+        schedule(completeEvent, pending.front().finish);
+    else if (drainState() == DrainState::Draining)
+        signalDrainDone();
+}
+
+OmxVirtIOBlock::BlockStats::BlockStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(readReqs, statistics::units::Count::get(), "Read requests"),
+      ADD_STAT(writeReqs, statistics::units::Count::get(), "Write requests"),
+      ADD_STAT(readBytes, statistics::units::Byte::get(), "Bytes read"),
+      ADD_STAT(writeBytes, statistics::units::Byte::get(), "Bytes written"),
+      ADD_STAT(readTicks, statistics::units::Tick::get(),
+               "Submission to completion of reads"),
+      ADD_STAT(writeTicks, statistics::units::Tick::get(),
+               "Submission to completion of writes"),
+      ADD_STAT(avgReadLatency, statistics::units::Rate<
+                   statistics::units::Tick, statistics::units::Count>::get(),
+               "Mean read service time", readTicks / readReqs),
+      ADD_STAT(avgWriteLatency, statistics::units::Rate<
+                   statistics::units::Tick, statistics::units::Count>::get(),
+               "Mean write service time", writeTicks / writeReqs),
+      ADD_STAT(serviceTicks, statistics::units::Tick::get(),
+               "Distribution of request service times"),
+      ADD_STAT(inflight, statistics::units::Count::get(),
+               "Requests awaiting completion")
+{
+    serviceTicks.init(16);
+}
+
+} // namespace gem5
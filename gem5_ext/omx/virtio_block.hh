@@ -0,0 +1,121 @@
+/*
+ * virtio-blk device with a latency/bandwidth backend model for the
+ * riscv64_smp block I/O benchmark.
+ *
+ * Request handling follows gem5's VirtIOBlock; completions are held back
+ * until the modelled finish time. See OmxVirtIOBlock.py for the model.
+ */
+
+#ifndef __OMX_VIRTIO_BLOCK_HH__
+#define __OMX_VIRTIO_BLOCK_HH__
+
+#include <cstdint>
+#include <deque>
+
+#include "base/compiler.hh"
+#include "base/statistics.hh"
+#include "dev/storage/disk_image.hh"
+#include "dev/virtio/base.hh"
+#include "params/OmxVirtIOBlock.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+class OmxVirtIOBlock : public VirtIODeviceBase
+{
+  public:
+    PARAMS(OmxVirtIOBlock);
+    OmxVirtIOBlock(const Params &p);
+
+    void readConfig(PacketPtr pkt, Addr cfgOffset) override;
+    void reset() override;
+    DrainState drain() override;
+
+  private:
+    static const DeviceId ID_BLOCK = 0x02;
+
+    typedef uint64_t Sector;
+    struct GEM5_PACKED Config
+    {
+        Sector capacity;
+    };
+    Config config;
+
+    typedef uint8_t Status;
+    static const Status S_OK = 0;
+    static const Status S_IOERR = 1;
+    static const Status S_UNSUPP = 2;
+
+    static const uint32_t T_IN = 0;
+    static const uint32_t T_OUT = 1;
+
+    struct GEM5_PACKED BlkRequest
+    {
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t sector;
+    };
+
+    class RequestQueue : public VirtQueue
+    {
+      public:
+        RequestQueue(PortProxy &proxy, ByteOrder bo, uint16_t size, OmxVirtIOBlock &_parent);
+        void onNotifyDescriptor(VirtDescriptor *desc) override;
+        std::string name() const { return parent.name() + ".qRequests"; }
+
+      private:
+        OmxVirtIOBlock &parent;
+    };
+
+    /** A processed request waiting for its modelled finish time. */
+    struct Completion
+    {
+        VirtDescriptor *desc;
+        uint32_t len;
+        Tick submitted;
+        Tick finish;
+        bool write;
+    };
+
+    RequestQueue qRequests;
+    DiskImage &image;
+
+    const Tick latency;
+    /** Ticks per byte of the backend channel. */
+    const double ticksPerByte;
+    Tick channelFree = 0;
+
+    std::deque<Completion> pending;
+    EventFunctionWrapper completeEvent;
+
+    Status read(const BlkRequest &req, VirtDescriptor *desc_chain, size_t off_data, size_t size);
+    Status write(const BlkRequest &req, VirtDescriptor *desc_chain, size_t off_data, size_t size);
+
+    /** Queue the used-ring update of a finished request. */
+    void submit(VirtDescriptor *desc, uint32_t len, size_t bytes, bool write);
+    /** Hand every request whose finish time has passed back to the guest. */
+    void complete();
+
+    struct BlockStats : public statistics::Group
+    {
+        BlockStats(statistics::Group *parent);
+
+        statistics::Scalar readReqs;
+        statistics::Scalar writeReqs;
+        statistics::Scalar readBytes;
+        statistics::Scalar writeBytes;
+        /** Submission to completion, per direction. */
+        statistics::Scalar readTicks;
+        statistics::Scalar writeTicks;
+        statistics::Formula avgReadLatency;
+        statistics::Formula avgWriteLatency;
+        statistics::Histogram serviceTicks;
+        /** Requests waiting for completion, sampled at each submission. */
+        statistics::Average inflight;
+    } stats;
+};
+
+} // namespace gem5
+
+#endif // __OMX_VIRTIO_BLOCK_HH__
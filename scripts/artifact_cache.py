@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""Content-addressed store for prebuilt Linux, Buildroot and Zephyr outputs.
+
+An entry is keyed by everything that determines the output:
+- the conf/submodules.lock.json entries of the sources it is built from
+- defconfig name (resolved inside the pinned source tree), overlay/conf
+  fragment and application contents, build script contents
+- toolchain version (cross gcc, host gcc or Zephyr SDK)
+
+The key trusts the lock entry. A source checkout that is present but not at
+the locked revision, or has tracked changes, makes the build uncacheable;
+a missing checkout is fine, so a fresh worker can restore without cloning.
+
+Layout: <store>/<kind>/<key>/manifest.json + files/<path relative to out-dir>.
+The store is a plain directory (default build/.artifact-cache, override with
+OMX_ARTIFACT_CACHE_DIR) that can sit on a shared mount or be synced from CI.
+"""
+
+import argparse
+import glob
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+LOCK_FILE = REPO_ROOT / "conf" / "submodules.lock.json"
+# Headers the Zephyr apps include from outside their own tree (omx_shm_ring.h).
+IPC_DIR = REPO_ROOT / "workloads" / "ipc"
+KEY_SCHEMA = 1
+_SKIP_DIRS = {".git", "__pycache__", "build"}
+
+# Per kind: sources (lock paths), build script, and artifacts relative to the
+# build output dir. Required patterns must match at least one file to store.
+KINDS: Dict[str, Dict[str, object]] = {
+    "linux": {
+        "sources": ["sources/linux"],
+        "script": "scripts/build_linux.sh",
+        "required": ["arch/{arch}/boot/Image", "vmlinux"],
+        "optional": [".config", "System.map", "arch/{arch}/boot/dts/**/*.dtb"],
+    },
+    "buildroot": {
+        "sources": ["sources/buildroot"],
+        "script": "scripts/build_buildroot.sh",
+        # fw_jump.elf (OpenSBI) and the rootfs.{ext2,cpio,tar} images.
+        "required": ["images/*"],
+        "optional": [".config"],
+    },
+    "zephyr": {
+        "sources": ["sources/zephyr", "sources/zephyr-modules/libmetal", "sources/zephyr-modules/open-amp"],
+        "script": "scripts/build_zephyr.sh",
+        "required": ["zephyr/zephyr.elf"],
+        "optional": ["zephyr/zephyr.bin", "zephyr/zephyr.map", "zephyr/.config"],
+    },
+}
+
+
+def utc_now() -> str:
+    return datetime.now(timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Restore/store prebuilt Linux, Buildroot and Zephyr outputs by content key",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument(
+        "--store",
+        default=os.environ.get("OMX_ARTIFACT_CACHE_DIR", str(REPO_ROOT / "build" / ".artifact-cache")),
+        help="artifact store directory",
+    )
+    sub = p.add_subparsers(dest="cmd", required=True)
+
+    kind_args = argparse.ArgumentParser(add_help=False)
+    kind_args.add_argument("kind", choices=sorted(KINDS))
+    kind_args.add_argument("--out-dir", default="", help="build output dir (default: build/<kind>[/<target>])")
+    kind_args.add_argument("--defconfig", default="", help="linux/buildroot defconfig name")
+    kind_args.add_argument("--arch", default="riscv", help="linux ARCH")
+    kind_args.add_argument("--cross-compile", default="riscv64-linux-gnu-", help="linux CROSS_COMPILE prefix")
+    kind_args.add_argument("--make-targets", default="Image dtbs", help="linux make targets")
+    kind_args.add_argument("--target", default="", help="zephyr build target name")
+    kind_args.add_argument("--app", default="", help="zephyr application dir")
+    kind_args.add_argument("--board", default="qemu_riscv32", help="zephyr board")
+    kind_args.add_argument("--overlay", default="", help="zephyr DTS overlay")
+    kind_args.add_argument("--extra-conf", default="", help="zephyr Kconfig fragment(s), ';'-separated")
+
+    key = sub.add_parser("key", parents=[kind_args], help="print the key (and its inputs with --json)")
+    key.add_argument("--json", action="store_true")
+    sub.add_parser("restore", parents=[kind_args], help="copy a stored entry into --out-dir; exit 1 on miss")
+    sub.add_parser("store", parents=[kind_args], help="store the artifacts found in --out-dir")
+    sub.add_parser("list", help="list stored entries")
+    return p
+
+
+def _rel(path: Path) -> str:
+    try:
+        return str(path.resolve().relative_to(REPO_ROOT))
+    except ValueError:
+        return path.name
+
+
+def _hash_path(digest, path: Path) -> None:
+    """Content hash of a file or tree; names are repo-relative so keys match across checkouts."""
+    if path.is_file():
+        digest.update(f"F {_rel(path)}\n".encode())
+        digest.update(hashlib.sha256(path.read_bytes()).digest())
+        return
+    if path.is_dir():
+        for root, dirs, files in os.walk(path):
+            dirs[:] = sorted(d for d in dirs if d not in _SKIP_DIRS)
+            for name in sorted(files):
+                _hash_path(digest, Path(root) / name)
+        return
+    digest.update(f"M {_rel(path)}\n".encode())
+
+
+def content_hash(path: str) -> str:
+    digest = hashlib.sha256()
+    _hash_path(digest, Path(path))
+    return digest.hexdigest()
+
+
+def tool_version(cmd: List[str]) -> str:
+    try:
+        proc = subprocess.run(cmd, capture_output=True, text=True, check=False)
+    except OSError:
+        return "missing"
+    lines = proc.stdout.splitlines()
+    return lines[0].strip() if lines else "missing"
+
+
+def lock_entries(paths: List[str]) -> Tuple[List[Dict[str, str]], List[str]]:
+    """Lock entries for `paths` and the reasons their checkouts cannot be keyed by them."""
+    lock = json.loads(LOCK_FILE.read_text(encoding="utf-8"))
+    modules = {module.get("path"): module for module in lock.get("modules", [])}
+    entries: List[Dict[str, str]] = []
+    problems: List[str] = []
+    for path in paths:
+        module = modules.get(path)
+        if module is None:
+            problems.append(f"{path}: not in {_rel(LOCK_FILE)}")
+            continue
+        entries.append({key: str(module.get(key, "")) for key in ("name", "url", "revision")})
+        checkout = REPO_ROOT / path
+        if not checkout.exists() or not any(checkout.iterdir()):
+            continue
+        head = subprocess.run(["git", "-C", str(checkout), "rev-parse", "HEAD"], capture_output=True, text=True)
+        if head.returncode != 0:
+            problems.append(f"{path}: not a git checkout")
+        elif head.stdout.strip() != module.get("revision"):
+            problems.append(f"{path}: HEAD {head.stdout.strip()[:12]} is not the locked {str(module.get('revision'))[:12]}")
+        else:
+            status = subprocess.run(
+                ["git", "-C", str(checkout), "status", "--porcelain", "--untracked-files=no"],
+                capture_output=True,
+                text=True,
+            )
+            if status.stdout.strip():
+                problems.append(f"{path}: has uncommitted changes")
+    return entries, problems
+
+
+def default_out_dir(args: argparse.Namespace) -> str:
+    if args.kind == "zephyr":
+        return str(REPO_ROOT / "build" / "zephyr" / args.target)
+    return str(REPO_ROOT / "build" / args.kind)
+
+
+def key_inputs(args: argparse.Namespace) -> Tuple[Dict[str, object], List[str]]:
+    spec = KINDS[args.kind]
+    entries, problems = lock_entries(list(spec["sources"]))
+    inputs: Dict[str, object] = {
+        "schema": KEY_SCHEMA,
+        "kind": args.kind,
+        "lock": entries,
+        "script": content_hash(str(REPO_ROOT / str(spec["script"]))),
+    }
+    if args.kind == "linux":
+        # In-tree defconfigs are pinned by the lock revision, so the name is enough.
+        inputs.update(
+            defconfig=args.defconfig or "defconfig",
+            arch=args.arch,
+            make_targets=args.make_targets.split(),
+            toolchain=tool_version([f"{args.cross_compile}gcc", "--version"]),
+            hostcc=tool_version([os.environ.get("OMX_CCACHE_C_COMPILER", "gcc"), "--version"]),
+        )
+    elif args.kind == "buildroot":
+        # Buildroot builds its own cross toolchain from pinned sources; only the
+        # host compiler comes from outside the lock.
+        inputs.update(
+            defconfig=args.defconfig or "qemu_riscv64_virt_defconfig",
+            hostcc=tool_version([os.environ.get("OMX_CCACHE_C_COMPILER", "gcc"), "--version"]),
+        )
+    else:
+        if not args.target:
+            raise ValueError("zephyr needs --target")
+        sdk = Path(os.environ.get("ZEPHYR_SDK_INSTALL_DIR", "/opt/zephyr-sdk"))
+        sdk_version = sdk / "sdk_version"
+        inputs.update(
+            target=args.target,
+            board=args.board,
+            app=content_hash(args.app) if args.app else "",
+            overlay=content_hash(args.overlay) if args.overlay else "",
+            extra_conf="+".join(content_hash(conf) for conf in args.extra_conf.split(";") if conf),
+            ipc=content_hash(str(IPC_DIR)),
+            toolchain=sdk_version.read_text(encoding="utf-8").strip() if sdk_version.is_file() else "missing",
+            toolchain_variant=os.environ.get("ZEPHYR_TOOLCHAIN_VARIANT", "zephyr"),
+        )
+    return inputs, problems
+
+
+def cache_key(inputs: Dict[str, object]) -> str:
+    return hashlib.sha256(json.dumps(inputs, sort_keys=True).encode()).hexdigest()
+
+
+def collect_artifacts(kind: str, out_dir: Path, arch: str) -> Tuple[List[str], List[str]]:
+    """Artifact paths relative to out_dir, plus required patterns with no match."""
+    spec = KINDS[kind]
+    found: List[str] = []
+    missing: List[str] = []
+    for group in ("required", "optional"):
+        for pattern in spec[group]:
+            pattern = str(pattern).format(arch=arch)
+            matches = sorted(
+                str(Path(path).relative_to(out_dir))
+                for path in glob.glob(str(out_dir / pattern), recursive=True)
+                if Path(path).is_file()
+            )
+            if not matches and group == "required":
+                missing.append(pattern)
+            found += [match for match in matches if match not in found]
+    return found, missing
+
+
+def _sha256(path: Path) -> str:
+    digest = hashlib.sha256()
+    with path.open("rb") as fh:
+        for chunk in iter(lambda: fh.read(1 << 20), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def entry_dir(store: Path, kind: str, key: str) -> Path:
+    return store / kind / key
+
+
+def restore(store: Path, kind: str, key: str, out_dir: Path) -> Optional[List[str]]:
+    entry = entry_dir(store, kind, key)
+    manifest_path = entry / "manifest.json"
+    if not manifest_path.is_file():
+        return None
+    manifest = json.loads(manifest_path.read_text(encoding="utf-8"))
+    files = manifest.get("files", {})
+    for rel, digest in files.items():
+        if _sha256(entry / "files" / rel) != digest:
+            raise ValueError(f"stored {rel} does not match its manifest digest")
+    for rel in files:
+        dest = out_dir / rel
+        dest.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy2(entry / "files" / rel, dest)
+    return sorted(files)
+
+
+def store_entry(store: Path, kind: str, key: str, inputs: Dict[str, object], out_dir: Path, files: List[str]) -> bool:
+    """Copy `files` into the store; False when the entry already exists."""
+    entry = entry_dir(store, kind, key)
+    if (entry / "manifest.json").is_file():
+        return False
+    tmp = entry.parent / f".tmp-{key}-{os.getpid()}"
+    shutil.rmtree(tmp, ignore_errors=True)
+    digests: Dict[str, str] = {}
+    for rel in files:
+        dest = tmp / "files" / rel
+        dest.parent.mkdir(parents=True, exist_ok=True)
+        shutil.copy2(out_dir / rel, dest)
+        digests[rel] = _sha256(dest)
+    manifest = {
+        "key": key,
+        "kind": kind,
+        "created_at_utc": utc_now(),
+        "inputs": inputs,
+        "files": digests,
+        "bytes": sum((tmp / "files" / rel).stat().st_size for rel in files),
+    }
+    (tmp / "manifest.json").write_text(json.dumps(manifest, indent=2) + "\n", encoding="utf-8")
+    try:
+        # A concurrent writer of the same key may win the rename; its entry is identical.
+        os.rename(tmp, entry)
+    except OSError:
+        shutil.rmtree(tmp, ignore_errors=True)
+        return False
+    return True
+
+
+def list_entries(store: Path) -> int:
+    if not store.is_dir():
+        print(f"[INFO] artifact store is empty: {store}")
+        return 0
+    for manifest_path in sorted(store.glob("*/*/manifest.json")):
+        manifest = json.loads(manifest_path.read_text(encoding="utf-8"))
+        inputs = manifest.get("inputs", {})
+        label = inputs.get("target") or inputs.get("defconfig") or ""
+        print(
+            f"{manifest.get('kind', '?'):<9} {str(manifest.get('key', ''))[:16]} {label:<28} "
+            f"{int(manifest.get('bytes', 0)) / (1 << 20):8.1f} MiB  {manifest.get('created_at_utc', '')}"
+        )
+    return 0
+
+
+def main() -> int:
+    args = parser().parse_args()
+    store = Path(args.store)
+    if args.cmd == "list":
+        return list_entries(store)
+
+    try:
+        inputs, problems = key_inputs(args)
+    except (OSError, ValueError) as exc:
+        print(f"[ERROR] artifact key for {args.kind}: {exc}", file=sys.stderr)
+        return 2
+    key = cache_key(inputs)
+    out_dir = Path(args.out_dir or default_out_dir(args))
+
+    if args.cmd == "key":
+        if args.json:
+            print(json.dumps({"key": key, "cacheable": not problems, "problems": problems, "inputs": inputs}, indent=2))
+        else:
+            print(key)
+        return 0
+    if problems:
+        for problem in problems:
+            print(f"[INFO] artifact cache skipped for {args.kind}: {problem}")
+        return 1
+
+    if args.cmd == "restore":
+        try:
+            files = restore(store, args.kind, key, out_dir)
+        except (OSError, ValueError) as exc:
+            print(f"[WARN] artifact cache entry {key[:16]} unusable: {exc}", file=sys.stderr)
+            return 1
+        if files is None:
+            print(f"[INFO] artifact cache miss: {args.kind} {key[:16]}")
+            return 1
+        print(f"[OK] restored {len(files)} {args.kind} artifacts ({key[:16]}) into {out_dir}")
+        return 0
+
+    files, missing = collect_artifacts(args.kind, out_dir, args.arch)
+    if missing:
+        print(f"[WARN] not storing {args.kind}: no match for {', '.join(missing)} in {out_dir}", file=sys.stderr)
+        return 1
+    if store_entry(store, args.kind, key, inputs, out_dir, files):
+        print(f"[OK] stored {len(files)} {args.kind} artifacts as {key[:16]} in {store}")
+    else:
+        print(f"[INFO] artifact cache already holds {args.kind} {key[:16]}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
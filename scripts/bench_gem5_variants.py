@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""Host-speed benchmark of gem5 binary variants on short target slices.
+
+Each slice is a run_gem5.py invocation cut off after --max-ticks; the same
+slices train the PGO build in scripts/build_gem5.sh. KIPS per slice comes from
+the run manifest's host_metrics (simInsts / hostSeconds of the last stats
+dump); the report compares every variant against opt.
+
+Outputs:
+- <out-root>/<variant>/<slice>/{results,logs}: the individual runs
+- <results-root>/<ts>/gem5_variants.json, summary_gem5_variants.md
+"""
+
+import argparse
+import json
+import math
+import subprocess
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List, Optional
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+sys.path.insert(0, str(REPO_ROOT / "scripts"))
+
+from run_gem5 import GEM5_VARIANTS  # noqa: E402
+
+# Boot slices covering the three CPU/memory paths the farm runs most.
+SLICES: Dict[str, List[str]] = {
+    "riscv32_simple": ["--target", "riscv32_simple", "--mode", "simple"],
+    "riscv32_mixed-atomic": ["--target", "riscv32_mixed", "--mode", "simple", "--cpu-type", "AtomicSimpleCPU"],
+    "riscv32_mixed-timing": ["--target", "riscv32_mixed", "--mode", "simple", "--cpu-type", "TimingSimpleCPU"],
+    "riscv64_smp": ["--target", "riscv64_smp", "--mode", "simple"],
+}
+
+
+def utc_ts() -> str:
+    return datetime.now(timezone.utc).strftime("%Y%m%dT%H%M%SZ")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Report host KIPS of gem5 opt/fast/pgo binaries on short target slices",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--variants", default="opt,fast,pgo", help="comma-separated run_gem5.py --gem5-variant names")
+    p.add_argument("--gem5-bin", default="", help="benchmark this binary only (as --label) instead of --variants")
+    p.add_argument("--label", default="custom", help="name of the --gem5-bin binary in the report")
+    p.add_argument("--slices", default=",".join(SLICES), help="comma-separated slice names")
+    p.add_argument("--max-ticks", type=int, default=20_000_000_000, help="tick budget per slice")
+    p.add_argument("--timeout-sec", type=int, default=1800)
+    p.add_argument("--timestamp", default="")
+    p.add_argument("--out-root", default="", help="per-run results/logs (default: build/gem5-bench/<ts>)")
+    p.add_argument("--results-root", default="workloads/results")
+    p.add_argument("--dry-run", action="store_true")
+    return p
+
+
+def run_slice(
+    binary: Dict[str, str], slice_name: str, args: argparse.Namespace, out_root: Path, ts: str
+) -> Dict[str, object]:
+    run_dir = out_root / binary["label"] / slice_name
+    cmd = [
+        sys.executable,
+        str(REPO_ROOT / "scripts" / "run_gem5.py"),
+        *SLICES[slice_name],
+        *binary["select"],
+        "--max-ticks-simple",
+        str(args.max_ticks),
+        "--max-ticks-complex",
+        str(args.max_ticks),
+        "--timeout-sec",
+        str(args.timeout_sec),
+        "--results-root",
+        str(run_dir / "results"),
+        "--log-root",
+        str(run_dir / "logs"),
+        "--timestamp",
+        ts,
+    ]
+    if args.dry_run:
+        cmd.append("--dry-run")
+    print(f"[INFO] {binary['label']} {slice_name}: {' '.join(cmd)}")
+    proc = subprocess.run(cmd, cwd=REPO_ROOT, capture_output=True, text=True)
+    target, mode = SLICES[slice_name][1], SLICES[slice_name][3]
+    manifest_path = run_dir / "results" / ts / f"run_gem5_{target}_{mode}.json"
+    manifest: Dict[str, object] = {}
+    if manifest_path.exists():
+        manifest = json.loads(manifest_path.read_text(encoding="utf-8"))
+    host = manifest.get("host_metrics") or {}
+    output = (proc.stderr or proc.stdout).strip().splitlines()
+    return {
+        "returncode": proc.returncode,
+        "manifest": str(manifest_path),
+        "error": output[-1] if proc.returncode != 0 and output else "",
+        "host_seconds": host.get("host_seconds"),
+        "sim_insts": host.get("sim_insts"),
+        "kips": host.get("kips"),
+    }
+
+
+def geomean(values: List[float]) -> Optional[float]:
+    values = [value for value in values if value and value > 0]
+    if not values:
+        return None
+    return math.exp(sum(math.log(value) for value in values) / len(values))
+
+
+def summarize(report: Dict[str, object]) -> str:
+    variants = list(report["variants"])
+    lines = [
+        f"# gem5 variant host speed ({report['timestamp']})",
+        "",
+        f"max ticks per slice: {report['max_ticks']}",
+        "",
+        "| slice | " + " | ".join(f"{label} KIPS" for label in variants) + " |",
+        "|---|" + "---:|" * len(variants),
+    ]
+    for slice_name in report["slices"]:
+        cells = []
+        for label in variants:
+            kips = report["variants"][label]["slices"][slice_name]["kips"]
+            cells.append(f"{kips:.1f}" if kips else "-")
+        lines.append(f"| {slice_name} | " + " | ".join(cells) + " |")
+    speedups = [
+        f"{label} {item['speedup_vs_opt']:.2f}x"
+        for label, item in report["variants"].items()
+        if item.get("speedup_vs_opt")
+    ]
+    if speedups:
+        lines += ["", "Geomean speedup vs opt: " + ", ".join(speedups)]
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    args = parser().parse_args()
+    ts = args.timestamp or utc_ts()
+    out_root = Path(args.out_root or REPO_ROOT / "build" / "gem5-bench" / ts)
+    slices = [name.strip() for name in args.slices.split(",") if name.strip()]
+    unknown = [name for name in slices if name not in SLICES]
+    if unknown:
+        print(f"[ERROR] unknown slices: {', '.join(unknown)} (known: {', '.join(SLICES)})", file=sys.stderr)
+        return 1
+
+    binaries: List[Dict[str, str]] = []
+    if args.gem5_bin:
+        binaries.append({"label": args.label, "path": args.gem5_bin, "select": ["--gem5-bin", args.gem5_bin]})
+    else:
+        for variant in (name.strip() for name in args.variants.split(",") if name.strip()):
+            if variant not in GEM5_VARIANTS:
+                print(f"[ERROR] unknown variant {variant!r}", file=sys.stderr)
+                return 1
+            path = REPO_ROOT / GEM5_VARIANTS[variant]
+            if not path.exists() and not args.dry_run:
+                print(f"[WARN] skipping {variant}: {path} not built (scripts/build_gem5.sh --variant {variant})")
+                continue
+            binaries.append({"label": variant, "path": str(path), "select": ["--gem5-variant", variant]})
+    if not binaries:
+        print("[ERROR] no gem5 binary to benchmark", file=sys.stderr)
+        return 1
+
+    report: Dict[str, object] = {
+        "timestamp": ts,
+        "dry_run": args.dry_run,
+        "max_ticks": args.max_ticks,
+        "slices": slices,
+        "out_root": str(out_root),
+        "variants": {},
+    }
+    for binary in binaries:
+        runs = {name: run_slice(binary, name, args, out_root, ts) for name in slices}
+        report["variants"][binary["label"]] = {
+            "gem5_bin": binary["path"],
+            "slices": runs,
+            "geomean_kips": geomean([run["kips"] for run in runs.values() if run["kips"]]),
+        }
+
+    baseline = report["variants"].get("opt", {}).get("slices", {})
+    for label, item in report["variants"].items():
+        ratios = [
+            run["kips"] / baseline[name]["kips"]
+            for name, run in item["slices"].items()
+            if run["kips"] and baseline.get(name, {}).get("kips")
+        ]
+        item["speedup_vs_opt"] = geomean(ratios)
+
+    if args.gem5_bin:
+        result_dir = out_root
+    else:
+        result_dir = Path(args.results_root) / ts
+    result_dir.mkdir(parents=True, exist_ok=True)
+    json_path = result_dir / "gem5_variants.json"
+    md_path = result_dir / "summary_gem5_variants.md"
+    json_path.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    md_path.write_text(summarize(report), encoding="utf-8")
+    print(summarize(report))
+    print(f"[OK] Report: {json_path}")
+
+    measured = [run for item in report["variants"].values() for run in item["slices"].values() if run["kips"]]
+    if not args.dry_run and not measured:
+        print("[ERROR] no slice produced host stats (missing images? see the run manifests)", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
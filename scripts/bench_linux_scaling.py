@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""SMP scaling of the riscv64_smp Linux benchmark suite across cache/memory configs.
+
+Runs `run_gem5.py --target riscv64_smp --mode complex` with the scaling
+initramfs (scripts/build_bench_initramfs.py --config
+conf/initramfs/bench_scaling.json) once per cache hierarchy x memory type and
+collects each manifest's bench_scaling curves side by side.
+
+Outputs:
+- <out-root>/<config>/{results,logs}: the individual runs
+- <results-root>/<ts>/linux_scaling.json, summary_linux_scaling.md
+"""
+
+import argparse
+import itertools
+import json
+import subprocess
+import sys
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+
+
+def utc_ts() -> str:
+    return datetime.now(timezone.utc).strftime("%Y%m%dT%H%M%SZ")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Sweep the riscv64_smp SMP scaling suite over cache hierarchies and memory types",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--initramfs", default="build/initramfs/bench_scaling.cpio")
+    p.add_argument("--num-cpus", type=int, default=4)
+    p.add_argument(
+        "--cache-hierarchies",
+        default="shared-l2,private-l2-llc",
+        help="comma-separated run_gem5.py --cache-hierarchy values ('default': config default)",
+    )
+    p.add_argument(
+        "--mem-types",
+        default="default",
+        help="comma-separated run_gem5.py --mem-type values ('default': config default)",
+    )
+    p.add_argument("--cpu-type", default="TimingSimpleCPU")
+    p.add_argument("--timeout-sec", type=int, default=7200)
+    p.add_argument("--timestamp", default="")
+    p.add_argument("--out-root", default="", help="per-run results/logs (default: build/linux-scaling/<ts>)")
+    p.add_argument("--results-root", default="workloads/results")
+    p.add_argument("--dry-run", action="store_true")
+    return p
+
+
+def _split(value: str) -> List[str]:
+    return [item.strip() for item in value.split(",") if item.strip()]
+
+
+def configs(args: argparse.Namespace) -> Dict[str, List[str]]:
+    """Config name -> extra run_gem5.py options, one per cache x memory pair."""
+    out: Dict[str, List[str]] = {}
+    for cache, mem in itertools.product(_split(args.cache_hierarchies), _split(args.mem_types)):
+        opts: List[str] = []
+        if cache != "default":
+            opts += ["--cache-hierarchy", cache]
+        if mem != "default":
+            opts += ["--mem-type", mem]
+        out[f"{cache}+{mem}"] = opts
+    return out
+
+
+def run_config(name: str, opts: List[str], args: argparse.Namespace, out_root: Path, ts: str) -> Dict[str, object]:
+    run_dir = out_root / name
+    cmd = [
+        sys.executable,
+        str(REPO_ROOT / "scripts" / "run_gem5.py"),
+        "--target",
+        "riscv64_smp",
+        "--mode",
+        "complex",
+        "--num-cpus",
+        str(args.num_cpus),
+        "--cpu-type",
+        args.cpu_type,
+        "--initramfs",
+        args.initramfs,
+        *opts,
+        "--timeout-sec",
+        str(args.timeout_sec),
+        "--results-root",
+        str(run_dir / "results"),
+        "--log-root",
+        str(run_dir / "logs"),
+        "--timestamp",
+        ts,
+    ]
+    if args.dry_run:
+        cmd.append("--dry-run")
+    print(f"[INFO] {name}: {' '.join(cmd)}")
+    proc = subprocess.run(cmd, cwd=REPO_ROOT, capture_output=True, text=True)
+    manifest_path = run_dir / "results" / ts / "run_gem5_riscv64_smp_complex.json"
+    manifest: Dict[str, object] = {}
+    if manifest_path.exists():
+        manifest = json.loads(manifest_path.read_text(encoding="utf-8"))
+    output = (proc.stderr or proc.stdout).strip().splitlines()
+    return {
+        "options": opts,
+        "returncode": proc.returncode,
+        "manifest": str(manifest_path),
+        "error": output[-1] if proc.returncode != 0 and output else "",
+        "bench_status_ok": (manifest.get("checks") or {}).get("bench_status_ok"),
+        "curves": manifest.get("bench_scaling") or {},
+    }
+
+
+def summarize(report: Dict[str, object]) -> str:
+    names = list(report["configs"])
+    curves = sorted({curve for item in report["configs"].values() for curve in item["curves"]})
+    lines = [
+        f"# riscv64_smp SMP scaling ({report['timestamp']})",
+        "",
+        f"harts: {report['num_cpus']}, initramfs: {report['initramfs']}",
+        "",
+        "Cells: value at the most threads (x vs the fewest threads).",
+        "",
+        "| curve | unit | " + " | ".join(names) + " |",
+        "|---|---|" + "---:|" * len(names),
+    ]
+    for curve in curves:
+        unit = ""
+        cells = []
+        for name in names:
+            item = report["configs"][name]["curves"].get(curve)
+            if not item:
+                cells.append("-")
+                continue
+            unit = item["unit"]
+            last = item["points"][-1]
+            rel = f" ({last['relative']:.2f}x)" if last.get("relative") is not None else ""
+            cells.append(f"{last['value']:.1f} @{last['threads']}{rel}")
+        lines.append(f"| {curve} | {unit} | " + " | ".join(cells) + " |")
+    if not curves:
+        lines.append("| (no results) | | " + " | ".join("-" for _ in names) + " |")
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    args = parser().parse_args()
+    ts = args.timestamp or utc_ts()
+    out_root = Path(args.out_root or REPO_ROOT / "build" / "linux-scaling" / ts)
+    if not Path(args.initramfs).exists() and not args.dry_run:
+        print(
+            f"[ERROR] {args.initramfs} not built "
+            "(python3 scripts/build_bench_initramfs.py --config conf/initramfs/bench_scaling.json)",
+            file=sys.stderr,
+        )
+        return 1
+
+    report: Dict[str, object] = {
+        "timestamp": ts,
+        "dry_run": args.dry_run,
+        "num_cpus": args.num_cpus,
+        "cpu_type": args.cpu_type,
+        "initramfs": args.initramfs,
+        "out_root": str(out_root),
+        "configs": {name: run_config(name, opts, args, out_root, ts) for name, opts in configs(args).items()},
+    }
+
+    result_dir = Path(args.results_root) / ts
+    result_dir.mkdir(parents=True, exist_ok=True)
+    json_path = result_dir / "linux_scaling.json"
+    md_path = result_dir / "summary_linux_scaling.md"
+    json_path.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    md_path.write_text(summarize(report), encoding="utf-8")
+    print(summarize(report))
+    print(f"[OK] Report: {json_path}")
+
+    failed = [name for name, item in report["configs"].items() if item["returncode"] != 0]
+    if failed:
+        print(f"[ERROR] runs failed: {', '.join(failed)} (see the run manifests)", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
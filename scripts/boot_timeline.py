@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Boot-time phase breakdown of a riscv64_smp Linux run.
+
+Line sources, best first:
+- ticks: gem5 `--debug-flags=Terminal --debug-file=terminal_ticks.log`
+  (run_gem5.py --boot-timing), one "<tick>: <terminal>: <line>" per console
+  line; needs a gem5 binary with tracing (gem5.opt)
+- ticks: the OmxTickTerminal sidecar of the terminal log (<terminal>.ticks or
+  .ticks.bin, run_gem5.py --tick-terminal); works with any gem5 build
+- printk: "[    1.234567]" kernel timestamps in the terminal log (guest
+  time, so nothing before the kernel; firmware milestones stay unknown)
+
+Milestones: OpenSBI banner, Linux version, first/last initcall
+(initcall_debug), Run /init, userspace ready. Phases are the gaps between
+consecutive milestones; initcalls are ranked by duration.
+
+Outputs boot_timeline.json, boot_timeline.md (phase table) and
+boot_timeline.svg (waterfall) next to the logs; run_gem5.py copies the JSON
+summary into the manifest as boot_timeline.
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Tuple
+
+from terminal_ticks import TICKS_PER_SEC, read_terminal, read_tick_lines
+
+PRINTK_RE = re.compile(r"^\[\s*(\d+\.\d+)\] ?(.*)$")
+INITCALL_CALL_RE = re.compile(r"calling\s+(\S+?)(?:\+0x[0-9a-f]+/0x[0-9a-f]+)?\s+@\s+\d+")
+INITCALL_RET_RE = re.compile(
+    r"initcall\s+(\S+?)(?:\+0x[0-9a-f]+/0x[0-9a-f]+)?\s+returned\s+(-?\d+)\s+after\s+(\d+)\s+usecs"
+)
+
+# (name, pattern); the first match of each pattern is the milestone.
+MILESTONES: List[Tuple[str, re.Pattern]] = [
+    ("opensbi", re.compile(r"OpenSBI v")),
+    ("linux_version", re.compile(r"Linux version")),
+    ("run_init", re.compile(r"Run /init as init process")),
+    ("userspace_ready", re.compile(r"INITRAMFS_SHELL_READY|initramfs#|OMX_BENCH_BEGIN")),
+]
+PHASES = [
+    ("firmware", None, "opensbi"),
+    ("opensbi", "opensbi", "linux_version"),
+    ("kernel_early", "linux_version", "initcalls_start"),
+    ("initcalls", "initcalls_start", "initcalls_end"),
+    ("kernel_late", "initcalls_end", "run_init"),
+    ("userspace", "run_init", "userspace_ready"),
+]
+
+
+def read_printk_lines(path: Path) -> List[Tuple[int, str]]:
+    """(tick, line) pairs from printk timestamps; untimed lines inherit the last stamp."""
+    lines: List[Tuple[int, str]] = []
+    if not path.exists():
+        return lines
+    last: Optional[int] = None
+    for raw in path.read_text(encoding="utf-8", errors="ignore").splitlines():
+        match = PRINTK_RE.match(raw.strip())
+        if match:
+            last = int(round(float(match.group(1)) * TICKS_PER_SEC))
+            lines.append((last, match.group(2)))
+        elif last is not None:
+            lines.append((last, raw))
+    return lines
+
+
+def timeline(lines: List[Tuple[int, str]], source: str, top: int = 10) -> Dict[str, object]:
+    milestones: Dict[str, Optional[int]] = {name: None for name, _ in MILESTONES}
+    milestones.update(initcalls_start=None, initcalls_end=None)
+    calls: Dict[str, int] = {}
+    initcalls: List[Dict[str, object]] = []
+    for tick, text in lines:
+        for name, pattern in MILESTONES:
+            if milestones[name] is None and pattern.search(text):
+                milestones[name] = tick
+        call = INITCALL_CALL_RE.search(text)
+        if call:
+            calls[call.group(1)] = tick
+            if milestones["initcalls_start"] is None:
+                milestones["initcalls_start"] = tick
+            continue
+        ret = INITCALL_RET_RE.search(text)
+        if ret:
+            fn = ret.group(1)
+            start = calls.pop(fn, None)
+            # Tick sources time the call themselves; printk falls back to the kernel's usecs.
+            if source == "ticks" and start is not None:
+                ticks = tick - start
+            else:
+                ticks = int(ret.group(3)) * TICKS_PER_SEC // 10**6
+            initcalls.append({"fn": fn, "ret": int(ret.group(2)), "ticks": ticks, "end_tick": tick})
+            milestones["initcalls_end"] = tick
+
+    # printk time starts at the kernel; firmware has no guest timestamps.
+    if source == "printk":
+        milestones["opensbi"] = None
+
+    phases: List[Dict[str, object]] = []
+    for name, begin, end in PHASES:
+        start_tick = 0 if begin is None else milestones.get(begin)
+        end_tick = milestones.get(end)
+        if start_tick is None or end_tick is None or end_tick < start_tick:
+            phases.append({"phase": name, "start_tick": start_tick, "end_tick": end_tick, "ticks": None})
+            continue
+        phases.append({"phase": name, "start_tick": start_tick, "end_tick": end_tick, "ticks": end_tick - start_tick})
+
+    ready = milestones["userspace_ready"]
+    slowest = sorted(initcalls, key=lambda item: int(item["ticks"]), reverse=True)[:top]
+    return {
+        "source": source,
+        "ticks_per_sec": TICKS_PER_SEC,
+        "milestones": milestones,
+        "milestones_sec": {k: (v / TICKS_PER_SEC if v is not None else None) for k, v in milestones.items()},
+        "phases": phases,
+        "initcall_count": len(initcalls),
+        "initcall_ticks_total": sum(int(item["ticks"]) for item in initcalls),
+        "slowest_initcalls": slowest,
+        "boot_time_sec": ready / TICKS_PER_SEC if ready is not None and source == "ticks" else None,
+        "kernel_boot_sec": (
+            (ready - milestones["linux_version"]) / TICKS_PER_SEC
+            if ready is not None and milestones["linux_version"] is not None
+            else None
+        ),
+    }
+
+
+def _ms(ticks: Optional[int]) -> str:
+    return f"{ticks / TICKS_PER_SEC * 1e3:.3f}" if ticks is not None else "-"
+
+
+def summary_markdown(data: Dict[str, object]) -> str:
+    lines = [
+        "# Boot timeline",
+        "",
+        f"source: {data['source']}, boot_time_sec: {data['boot_time_sec']}, "
+        f"kernel_boot_sec: {data['kernel_boot_sec']}",
+        "",
+        "| phase | start ms | end ms | duration ms |",
+        "|---|---:|---:|---:|",
+    ]
+    for phase in data["phases"]:
+        lines.append(
+            f"| {phase['phase']} | {_ms(phase['start_tick'])} | {_ms(phase['end_tick'])} | {_ms(phase['ticks'])} |"
+        )
+    if data["slowest_initcalls"]:
+        lines += [
+            "",
+            f"Slowest initcalls ({data['initcall_count']} total, {_ms(data['initcall_ticks_total'])} ms):",
+            "",
+            "| initcall | ms | ret |",
+            "|---|---:|---:|",
+        ]
+        lines += [f"| {item['fn']} | {_ms(item['ticks'])} | {item['ret']} |" for item in data["slowest_initcalls"]]
+    return "\n".join(lines) + "\n"
+
+
+def waterfall_svg(data: Dict[str, object]) -> str:
+    """Phases (and the slowest initcalls under initcalls) as bars on one time axis."""
+    rows: List[Tuple[str, int, int, str]] = []
+    for phase in data["phases"]:
+        if phase["ticks"] is not None:
+            rows.append((phase["phase"], int(phase["start_tick"]), int(phase["ticks"]), "#4878a8"))
+    for item in data["slowest_initcalls"]:
+        rows.append((f"  {item['fn']}", int(item["end_tick"]) - int(item["ticks"]), int(item["ticks"]), "#d08040"))
+    end = max((start + length for _, start, length, _ in rows), default=0) or 1
+    label_w, bar_w, row_h = 220, 640, 18
+    height = row_h * (len(rows) + 2)
+    out = [
+        f'<svg xmlns="http://www.w3.org/2000/svg" width="{label_w + bar_w + 80}" height="{height}" '
+        'font-family="monospace" font-size="11">',
+        f'<text x="4" y="12">boot timeline ({data["source"]}), end {_ms(end)} ms</text>',
+    ]
+    for idx, (name, start, length, color) in enumerate(rows):
+        y = row_h * (idx + 1)
+        x = label_w + bar_w * start / end
+        w = max(1.0, bar_w * length / end)
+        out += [
+            f'<text x="4" y="{y + 12}">{name}</text>',
+            f'<rect x="{x:.1f}" y="{y + 2}" width="{w:.1f}" height="{row_h - 4}" fill="{color}"/>',
+            f'<text x="{x + w + 4:.1f}" y="{y + 12}">{_ms(length)} ms</text>',
+        ]
+    out.append("</svg>")
+    return "\n".join(out) + "\n"
+
+
+def analyze(logs_dir: Path, terminal_log: Path, terminal: str = "system.platform.terminal") -> Dict[str, object]:
+    """Write boot_timeline.{json,md,svg} into logs_dir and return the summary."""
+    lines = read_tick_lines(logs_dir / "terminal_ticks.log", terminal) or read_terminal(terminal_log)
+    source = "ticks"
+    if not lines:
+        lines, source = read_printk_lines(terminal_log), "printk"
+    data = timeline(lines, source) if lines else {"source": "none", "boot_time_sec": None}
+    json_path = logs_dir / "boot_timeline.json"
+    json_path.write_text(json.dumps(data, indent=2) + "\n", encoding="utf-8")
+    data = dict(data, json=str(json_path))
+    if lines:
+        md_path = logs_dir / "boot_timeline.md"
+        svg_path = logs_dir / "boot_timeline.svg"
+        md_path.write_text(summary_markdown(data), encoding="utf-8")
+        svg_path.write_text(waterfall_svg(data), encoding="utf-8")
+        data.update(markdown=str(md_path), chart=str(svg_path))
+    return data
+
+
+def main() -> int:
+    p = argparse.ArgumentParser(description="Boot-time phase breakdown from a run's logs directory")
+    p.add_argument("logs_dir", help="run_gem5.py logs dir (terminal_ticks.log, system.platform.terminal[.ticks*])")
+    p.add_argument("--terminal", default="system.platform.terminal", help="terminal object name in the trace")
+    args = p.parse_args()
+    logs_dir = Path(args.logs_dir)
+    data = analyze(logs_dir, logs_dir / args.terminal, args.terminal)
+    if data["source"] == "none":
+        print(f"[ERROR] no timed console lines in {logs_dir}", file=sys.stderr)
+        return 1
+    print(summary_markdown(data), end="")
+    print(f"[OK] {data['json']}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
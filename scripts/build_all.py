@@ -0,0 +1,522 @@
+#!/usr/bin/env python3
+"""Build every guest image as one dependency graph.
+
+Nodes wrap the existing build scripts:
+- zephyr:<image>: scripts/build_zephyr.sh per Zephyr image
+- boot:riscv32_mixed: boot table from the mixed images' entry PCs, then
+  scripts/build_riscv32_mixed_boot.sh
+- linux, buildroot: scripts/build_linux.sh, scripts/build_buildroot.sh
+
+A node starts once its dependencies are done and a job token is free. It is
+skipped when the hash of its inputs (files, source revisions, toolchain,
+parameters and dependency hashes) matches the stamp of its last successful
+build and its outputs still exist.
+
+All nodes share one GNU make jobserver holding --jobs tokens. Children see it
+through MAKEFLAGS (--jobserver-auth) plus OMX_JOBSERVER=<style>, which makes the
+build scripts drop their own -jN so make and ninja (>= 1.13) draw from the
+shared pool instead of each running -j$(nproc). make 4.3 only understands
+the pipe form of the jobserver, which ninja ignores (Zephyr builds then run
+-j1 within their token); --jobserver-style auto
+picks the fifo form when make >= 4.4 is installed.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import select
+import shlex
+import subprocess
+import sys
+import time
+from dataclasses import dataclass, field
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List, Optional
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+SCRIPTS = REPO_ROOT / "scripts"
+sys.path.insert(0, str(REPO_ROOT / "conf"))
+
+from omx_topology import derive_topology, load_topology  # noqa: E402
+
+DEFAULT_TOPOLOGY = "conf/topology/riscv32_mixed.json"
+STAMP_DIR = REPO_ROOT / "build" / ".build_all"
+_SKIP_DIRS = {".git", "__pycache__", "build"}
+
+
+@dataclass
+class Node:
+    name: str
+    commands: List[List[str]]
+    deps: List[str] = field(default_factory=list)
+    inputs: List[str] = field(default_factory=list)  # files/dirs hashed by content
+    sources: List[str] = field(default_factory=list)  # git checkouts hashed by revision + diff
+    outputs: List[str] = field(default_factory=list)
+    params: Dict[str, str] = field(default_factory=dict)
+
+
+def utc_ts() -> str:
+    return datetime.now(timezone.utc).strftime("%Y%m%dT%H%M%SZ")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Build Zephyr images, mixed boot trampoline, Linux and Buildroot as one DAG",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--jobs", type=int, default=os.cpu_count() or 1, help="job tokens shared by all nodes")
+    p.add_argument(
+        "--targets",
+        default="all",
+        help="comma-separated node names or groups (zephyr, boot, linux, buildroot); dependencies are added",
+    )
+    p.add_argument(
+        "--topology",
+        default="",
+        help="build the Zephyr images of this conf/topology/*.json instead of the checked-in mixed overlays",
+    )
+    p.add_argument("--linux-defconfig", default="defconfig")
+    p.add_argument("--buildroot-defconfig", default="qemu_riscv64_virt_defconfig")
+    p.add_argument("--cross-compile", default="riscv64-linux-gnu-")
+    p.add_argument(
+        "--jobserver-style",
+        choices=["auto", "fifo", "pipe"],
+        default="auto",
+        help="fifo: make >= 4.4 and ninja >= 1.13; pipe: older make (ninja then ignores the jobserver); "
+        "auto: fifo when the host make supports it",
+    )
+    p.add_argument("--force", action="store_true", help="rebuild selected nodes even when up to date")
+    p.add_argument("--dry-run", action="store_true", help="print the schedule and up-to-date state only")
+    return p
+
+
+def _rel(path: Path) -> str:
+    try:
+        return str(path.relative_to(REPO_ROOT))
+    except ValueError:
+        return str(path)
+
+
+def zephyr_node(target: str, app: str, overlay: Path, conf: Optional[Path], jobs: int, topology_dir: str = "") -> Node:
+    cmd = [str(SCRIPTS / "build_zephyr.sh"), "--target", target, "--jobs", str(jobs)]
+    if topology_dir:
+        cmd += ["--topology-dir", topology_dir]
+    sdk = os.environ.get("ZEPHYR_SDK_INSTALL_DIR", "/opt/zephyr-sdk")
+    return Node(
+        name=f"zephyr:{target}",
+        commands=[cmd],
+        inputs=[
+            f"workloads/zephyr/{app}",
+            _rel(overlay),
+            *([_rel(conf)] if conf else []),
+            "scripts/build_zephyr.sh",
+            "scripts/env.sh",
+        ],
+        sources=["sources/zephyr", "sources/zephyr-modules/libmetal", "sources/zephyr-modules/open-amp"],
+        outputs=[f"build/zephyr/{target}/zephyr/zephyr.elf"],
+        params={"board": "qemu_riscv32", "toolchain": _file_text(Path(sdk) / "sdk_version") or sdk},
+    )
+
+
+def build_graph(args: argparse.Namespace) -> Dict[str, Node]:
+    nodes: Dict[str, Node] = {}
+    topology_path = args.topology or DEFAULT_TOPOLOGY
+    topology = derive_topology(load_topology(str(REPO_ROOT / topology_path)))
+    topology_dir = f"build/topology/{Path(topology_path).stem}"
+    topology_inputs = [topology_path, "conf/omx_topology.py", "scripts/gen_topology.py"]
+    gen_cmd = [
+        sys.executable,
+        str(SCRIPTS / "gen_topology.py"),
+        "--topology",
+        str(REPO_ROOT / topology_path),
+        "--out-dir",
+        str(REPO_ROOT / topology_dir),
+        "--image-dir",
+        str(REPO_ROOT / "build" / "zephyr"),
+    ]
+
+    image_deps: List[str] = []
+    if args.topology:
+        # Generated overlays/confs feed every image of a custom topology.
+        nodes["topology"] = Node(
+            name="topology",
+            commands=[gen_cmd],
+            inputs=topology_inputs,
+            outputs=[f"{topology_dir}/zephyr/{image['name']}.overlay" for image in topology["images"]],
+        )
+        image_deps = ["topology"]
+    for image in topology["images"]:
+        name = str(image["name"])
+        if args.topology:
+            node = zephyr_node(
+                name,
+                "riscv32_mixed",
+                REPO_ROOT / topology_dir / "zephyr" / f"{name}.overlay",
+                REPO_ROOT / topology_dir / "zephyr" / f"{name}.conf",
+                args.jobs,
+                topology_dir=str(REPO_ROOT / topology_dir),
+            )
+        else:
+            node = zephyr_node(
+                name,
+                "riscv32_mixed",
+                REPO_ROOT / "conf" / "zephyr" / f"{name}.overlay",
+                REPO_ROOT / "conf" / "zephyr" / f"{name}.conf",
+                args.jobs,
+            )
+        node.deps = list(image_deps)
+        nodes[node.name] = node
+    simple = zephyr_node(
+        "riscv32_simple", "riscv32_simple", REPO_ROOT / "conf" / "zephyr" / "riscv32_simple.overlay", None, args.jobs
+    )
+    nodes[simple.name] = simple
+
+    # The boot table carries each image's ELF entry PC, so it is regenerated
+    # after the images; their hashes reach this node through deps.
+    nodes["boot:riscv32_mixed"] = Node(
+        name="boot:riscv32_mixed",
+        commands=[
+            gen_cmd,
+            [
+                str(SCRIPTS / "build_riscv32_mixed_boot.sh"),
+                "--boot-table",
+                str(REPO_ROOT / topology_dir / "riscv32_mixed_boot_table.h"),
+            ],
+        ],
+        deps=[f"zephyr:{image['name']}" for image in topology["images"]],
+        inputs=[
+            *topology_inputs,
+            "scripts/riscv32_mixed_boot.S",
+            "scripts/riscv32_mixed_boot.ld",
+            "scripts/build_riscv32_mixed_boot.sh",
+        ],
+        outputs=["build/boot/riscv32_mixed_boot.elf"],
+    )
+
+    nodes["linux"] = Node(
+        name="linux",
+        commands=[
+            [
+                str(SCRIPTS / "build_linux.sh"),
+                "--defconfig",
+                args.linux_defconfig,
+                "--cross-compile",
+                args.cross_compile,
+                "--jobs",
+                str(args.jobs),
+            ]
+        ],
+        inputs=["scripts/build_linux.sh", "scripts/env.sh"],
+        sources=["sources/linux"],
+        outputs=["build/linux/arch/riscv/boot/Image", "build/linux/vmlinux"],
+        params={"defconfig": args.linux_defconfig, "toolchain": tool_version([f"{args.cross_compile}gcc", "--version"])},
+    )
+    nodes["buildroot"] = Node(
+        name="buildroot",
+        commands=[
+            [str(SCRIPTS / "build_buildroot.sh"), "--defconfig", args.buildroot_defconfig, "--jobs", str(args.jobs)]
+        ],
+        inputs=["scripts/build_buildroot.sh", "scripts/env.sh"],
+        sources=["sources/buildroot"],
+        outputs=["build/buildroot/images/rootfs.ext2"],
+        params={"defconfig": args.buildroot_defconfig},
+    )
+    return nodes
+
+
+def select_nodes(nodes: Dict[str, Node], targets: str) -> List[str]:
+    """Selected nodes plus their dependencies, in dependency order."""
+    wanted: List[str] = []
+    for item in (t.strip() for t in targets.split(",") if t.strip()):
+        matches = [n for n in nodes if item == "all" or n == item or n.split(":", 1)[0] == item]
+        if not matches:
+            raise ValueError(f"unknown target {item!r} (nodes: {', '.join(nodes)})")
+        wanted.extend(matches)
+
+    order: List[str] = []
+    visiting: set = set()
+
+    def visit(name: str) -> None:
+        if name in order:
+            return
+        if name in visiting:
+            raise ValueError(f"dependency cycle at {name}")
+        visiting.add(name)
+        for dep in nodes[name].deps:
+            visit(dep)
+        visiting.discard(name)
+        order.append(name)
+
+    for name in wanted:
+        visit(name)
+    return order
+
+
+def _file_text(path: Path) -> str:
+    try:
+        return path.read_text(encoding="utf-8").strip()
+    except OSError:
+        return ""
+
+
+def tool_version(cmd: List[str]) -> str:
+    try:
+        proc = subprocess.run(cmd, capture_output=True, text=True, check=False)
+    except OSError:
+        return "missing"
+    lines = proc.stdout.splitlines()
+    return lines[0].strip() if lines else "missing"
+
+
+def jobserver_style(requested: str) -> str:
+    if requested != "auto":
+        return requested
+    version = tool_version(["make", "--version"]).split()[-1:]
+    try:
+        major, minor = (int(part) for part in version[0].split(".")[:2])
+    except (IndexError, ValueError):
+        return "pipe"
+    return "fifo" if (major, minor) >= (4, 4) else "pipe"
+
+
+def _hash_path(digest, path: Path) -> None:
+    if path.is_file():
+        digest.update(f"F {_rel(path)}\n".encode())
+        digest.update(hashlib.sha256(path.read_bytes()).digest())
+        return
+    if path.is_dir():
+        for root, dirs, files in os.walk(path):
+            dirs[:] = sorted(d for d in dirs if d not in _SKIP_DIRS)
+            for name in sorted(files):
+                _hash_path(digest, Path(root) / name)
+        return
+    digest.update(f"M {_rel(path)}\n".encode())
+
+
+def source_revision(path: str) -> str:
+    """HEAD plus a hash of uncommitted changes, or the lock revision when not a checkout."""
+    checkout = REPO_ROOT / path
+    if (checkout / ".git").exists():
+        head = subprocess.run(["git", "-C", str(checkout), "rev-parse", "HEAD"], capture_output=True, text=True)
+        diff = subprocess.run(["git", "-C", str(checkout), "diff", "HEAD", "--no-ext-diff"], capture_output=True)
+        if head.returncode == 0:
+            dirty = hashlib.sha256(diff.stdout).hexdigest()[:16] if diff.stdout else "clean"
+            return f"{head.stdout.strip()}+{dirty}"
+    lock = json.loads((REPO_ROOT / "conf" / "submodules.lock.json").read_text(encoding="utf-8"))
+    for module in lock.get("modules", []):
+        if module.get("path") == path:
+            return f"lock:{module.get('revision')}"
+    return "missing"
+
+
+def node_hashes(nodes: Dict[str, Node], order: List[str]) -> Dict[str, str]:
+    hashes: Dict[str, str] = {}
+    for name in order:
+        node = nodes[name]
+        digest = hashlib.sha256()
+        digest.update(json.dumps({"commands": node.commands, "params": node.params}, sort_keys=True).encode())
+        for item in node.inputs:
+            _hash_path(digest, REPO_ROOT / item)
+        for source in node.sources:
+            digest.update(f"S {source} {source_revision(source)}\n".encode())
+        for dep in node.deps:
+            digest.update(f"D {dep} {hashes[dep]}\n".encode())
+        hashes[name] = digest.hexdigest()
+    return hashes
+
+
+def _stamp_path(name: str) -> Path:
+    return STAMP_DIR / f"{name.replace(':', '_')}.json"
+
+
+def up_to_date(node: Node, node_hash: str) -> bool:
+    stamp = _stamp_path(node.name)
+    if not stamp.exists():
+        return False
+    try:
+        recorded = json.loads(stamp.read_text(encoding="utf-8")).get("hash")
+    except (OSError, ValueError):
+        return False
+    return recorded == node_hash and all((REPO_ROOT / out).exists() for out in node.outputs)
+
+
+class JobServer:
+    """GNU make jobserver with `jobs` tokens: one implicit, jobs-1 in a fifo or pipe."""
+
+    def __init__(self, jobs: int, style: str, fifo_path: Path):
+        self.jobs = jobs
+        self.style = style
+        self.implicit_free = True
+        self.pass_fds: tuple = ()
+        if style == "fifo":
+            fifo_path.parent.mkdir(parents=True, exist_ok=True)
+            if fifo_path.exists():
+                fifo_path.unlink()
+            os.mkfifo(fifo_path)
+            self.fifo_path: Optional[Path] = fifo_path
+            self.read_fd = self.write_fd = os.open(fifo_path, os.O_RDWR | os.O_NONBLOCK)
+            self.auth = f"fifo:{fifo_path}"
+        else:
+            self.fifo_path = None
+            read_fd, self.write_fd = os.pipe()
+            # Children inherit the blocking descriptors; this process polls a
+            # separate non-blocking open file description of the same pipe.
+            self.read_fd = os.open(f"/proc/self/fd/{read_fd}", os.O_RDONLY | os.O_NONBLOCK)
+            self.pass_fds = (read_fd, self.write_fd)
+            self.auth = f"{read_fd},{self.write_fd}"
+        os.write(self.write_fd, b"+" * (jobs - 1))
+
+    def acquire(self) -> Optional[bytes]:
+        if self.implicit_free:
+            self.implicit_free = False
+            return b""
+        readable, _, _ = select.select([self.read_fd], [], [], 0)
+        if not readable:
+            return None
+        try:
+            return os.read(self.read_fd, 1) or None
+        except BlockingIOError:
+            return None
+
+    def release(self, token: bytes) -> None:
+        if token == b"":
+            self.implicit_free = True
+        else:
+            os.write(self.write_fd, token)
+
+    def env(self) -> Dict[str, str]:
+        env = dict(os.environ)
+        env.pop("CMAKE_BUILD_PARALLEL_LEVEL", None)
+        env["MAKEFLAGS"] = f"-j{self.jobs} --jobserver-auth={self.auth}"
+        env["OMX_JOBSERVER"] = self.style
+        return env
+
+    def close(self) -> None:
+        if self.fifo_path is not None:
+            os.close(self.read_fd)
+            self.fifo_path.unlink(missing_ok=True)
+
+
+def shell_line(node: Node) -> str:
+    return " && ".join(shlex.join(cmd) for cmd in node.commands)
+
+
+def run_graph(
+    nodes: Dict[str, Node], order: List[str], hashes: Dict[str, str], args: argparse.Namespace, log_dir: Path
+) -> Dict[str, Dict[str, object]]:
+    results: Dict[str, Dict[str, object]] = {name: {"status": "pending"} for name in order}
+    jobserver = JobServer(args.jobs, jobserver_style(args.jobserver_style), STAMP_DIR / "jobserver.fifo")
+    env = jobserver.env()
+    running: Dict[str, Dict[str, object]] = {}
+    failed = False
+    try:
+        while True:
+            for name in order:
+                if failed or results[name]["status"] != "pending":
+                    continue
+                dep_states = [results[dep]["status"] for dep in nodes[name].deps]
+                if any(state in ("failed", "blocked") for state in dep_states):
+                    results[name] = {"status": "blocked"}
+                    continue
+                if any(state not in ("built", "up-to-date") for state in dep_states):
+                    continue
+                if not args.force and up_to_date(nodes[name], hashes[name]):
+                    results[name] = {"status": "up-to-date"}
+                    print(f"[INFO] {name}: up to date")
+                    continue
+                token = jobserver.acquire()
+                if token is None:
+                    break
+                log_path = log_dir / f"{name.replace(':', '_')}.log"
+                log = open(log_path, "w", encoding="utf-8")
+                print(f"[INFO] {name}: start (log={_rel(log_path)})")
+                proc = subprocess.Popen(
+                    ["bash", "-c", shell_line(nodes[name])],
+                    cwd=REPO_ROOT,
+                    env=env,
+                    stdout=log,
+                    stderr=subprocess.STDOUT,
+                    pass_fds=jobserver.pass_fds,
+                )
+                running[name] = {"proc": proc, "token": token, "start": time.monotonic(), "log": log}
+                results[name] = {"status": "running", "log": _rel(log_path)}
+
+            if not running:
+                break
+            time.sleep(0.2)
+            for name in list(running):
+                item = running[name]
+                returncode = item["proc"].poll()
+                if returncode is None:
+                    continue
+                del running[name]
+                item["log"].close()
+                jobserver.release(item["token"])
+                duration = round(time.monotonic() - item["start"], 2)
+                results[name].update(returncode=returncode, duration_sec=duration)
+                if returncode == 0:
+                    results[name]["status"] = "built"
+                    STAMP_DIR.mkdir(parents=True, exist_ok=True)
+                    _stamp_path(name).write_text(
+                        json.dumps({"hash": hashes[name], "finished_utc": utc_ts(), "duration_sec": duration}, indent=2)
+                        + "\n",
+                        encoding="utf-8",
+                    )
+                    print(f"[OK] {name}: built in {duration}s")
+                else:
+                    results[name]["status"] = "failed"
+                    failed = True
+                    print(f"[ERROR] {name}: failed rc={returncode} (log={results[name]['log']})", file=sys.stderr)
+    finally:
+        jobserver.close()
+
+    for name in order:
+        if results[name]["status"] == "pending":
+            results[name] = {"status": "not-run"}
+    return results
+
+
+def main() -> int:
+    args = parser().parse_args()
+    if args.jobs < 1:
+        print("[ERROR] --jobs must be >= 1", file=sys.stderr)
+        return 1
+    try:
+        nodes = build_graph(args)
+        order = select_nodes(nodes, args.targets)
+    except (OSError, ValueError, KeyError) as exc:
+        print(f"[ERROR] {exc}", file=sys.stderr)
+        return 1
+    hashes = node_hashes(nodes, order)
+
+    if args.dry_run:
+        for name in order:
+            node = nodes[name]
+            state = "up-to-date" if (not args.force and up_to_date(node, hashes[name])) else "build"
+            deps = ",".join(node.deps) or "-"
+            print(f"[DRY-RUN] {name} state={state} deps={deps} hash={hashes[name][:12]}")
+            print(f"[DRY-RUN]   {shell_line(node)}")
+        return 0
+
+    log_dir = REPO_ROOT / "build" / "logs" / "build_all" / utc_ts()
+    log_dir.mkdir(parents=True, exist_ok=True)
+    start = time.monotonic()
+    results = run_graph(nodes, order, hashes, args, log_dir)
+    summary = {
+        "jobs": args.jobs,
+        "jobserver_style": jobserver_style(args.jobserver_style),
+        "targets": args.targets,
+        "topology": args.topology or DEFAULT_TOPOLOGY,
+        "wall_sec": round(time.monotonic() - start, 2),
+        "nodes": {name: dict(results[name], deps=nodes[name].deps, hash=hashes[name]) for name in order},
+    }
+    summary_path = log_dir / "build_all.json"
+    summary_path.write_text(json.dumps(summary, indent=2) + "\n", encoding="utf-8")
+    print(f"[OK] Summary: {_rel(summary_path)}")
+    return 0 if all(item["status"] in ("built", "up-to-date") for item in results.values()) else 1
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
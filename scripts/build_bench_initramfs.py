@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""Build a minimal static benchmark initramfs for riscv64_smp (and the riscv_hybrid rv64 side).
+
+Reads a benchmark list (conf/initramfs/*.json), cross-compiles the static
+init and benchmark binaries from workloads/linux/bench_initramfs/src and
+packs them into a newc cpio archive (no busybox, no shell):
+
+  /init                   runs /etc/omx_bench.list, then m5 exit
+  /bin/<benchmark>        membw, ptrchase, futex, ctxsw, spin, pipe, forkexec, blkio, hshm
+  /etc/omx_bench.list     benchmark command lines + @directives
+  /dev/console, /proc, /sys
+
+Outputs build/initramfs/<name>.cpio and <name>.json. The sidecar JSON
+(benchmark list, file hashes, toolchain) is copied into the run manifest by
+scripts/run_gem5.py --initramfs <name>.cpio. Archive entries have fixed
+owners, inode numbers and mtime (SOURCE_DATE_EPOCH, default 0), so the same
+list and toolchain give a byte-identical image.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shlex
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List, Tuple
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+SRC_DIR = REPO_ROOT / "workloads" / "linux" / "bench_initramfs" / "src"
+# Headers shared with the Zephyr side (omx_shm_ring.h).
+IPC_DIR = REPO_ROOT / "workloads" / "ipc"
+BENCHMARKS = ("membw", "ptrchase", "futex", "ctxsw", "spin", "pipe", "forkexec", "blkio", "hshm")
+SIDECAR_KIND = "omx-bench-initramfs"
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Build a static benchmark initramfs (init + benchmarks, m5 exit at the end)",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--config", default="conf/initramfs/bench_default.json")
+    p.add_argument("--cross-compile", default="riscv64-linux-gnu-", help="toolchain prefix ('' for a host build)")
+    p.add_argument("--cflags", default="-O2 -Wall -Wextra")
+    p.add_argument("--out-dir", default="build/initramfs")
+    p.add_argument("--dry-run", action="store_true", help="print the compile commands and list only")
+    return p
+
+
+def load_config(path: Path) -> Dict[str, object]:
+    config = json.loads(path.read_text(encoding="utf-8"))
+    config.setdefault("name", path.stem)
+    benchmarks = config.get("benchmarks", [])
+    if not benchmarks:
+        raise ValueError("needs at least one benchmark")
+    for bench in benchmarks:
+        if bench.get("name") not in BENCHMARKS:
+            raise ValueError(f"unknown benchmark {bench.get('name')!r} (known: {', '.join(BENCHMARKS)})")
+        bench["args"] = [str(arg) for arg in bench.get("args", [])]
+    return config
+
+
+def bench_list(config: Dict[str, object]) -> str:
+    lines = [
+        f"# {config['name']}: generated by scripts/build_bench_initramfs.py",
+        f"@m5_exit {1 if config.get('m5_exit', True) else 0}",
+        f"@stats_per_bench {1 if config.get('stats_per_bench', True) else 0}",
+    ]
+    lines += [shlex.join([bench["name"], *bench["args"]]) for bench in config["benchmarks"]]
+    return "\n".join(lines) + "\n"
+
+
+def compile_commands(config: Dict[str, object], args: argparse.Namespace, bin_dir: Path) -> List[List[str]]:
+    cc = f"{args.cross_compile}gcc"
+    names = ["init", *sorted({str(bench["name"]) for bench in config["benchmarks"]})]
+    return [
+        [
+            cc,
+            "-static",
+            *shlex.split(args.cflags),
+            "-pthread",
+            f"-I{IPC_DIR}",
+            "-o",
+            str(bin_dir / name),
+            str(SRC_DIR / f"{name}.c"),
+        ]
+        for name in names
+    ]
+
+
+def _newc_entry(ino: int, name: str, mode: int, data: bytes, mtime: int, rdev: Tuple[int, int] = (0, 0)) -> bytes:
+    encoded = name.encode() + b"\0"
+    fields = [ino, mode, 0, 0, 1, mtime, len(data), 0, 0, rdev[0], rdev[1], len(encoded), 0]
+    header = b"070701" + b"".join(f"{field:08x}".encode() for field in fields)
+    out = header + encoded
+    out += b"\0" * (-len(out) % 4)
+    out += data
+    out += b"\0" * (-len(out) % 4)
+    return out
+
+
+def write_cpio(path: Path, entries: List[Tuple[str, int, bytes, Tuple[int, int]]], mtime: int) -> None:
+    """newc archive of (name, mode, data, (rdev major, minor)) entries."""
+    blob = b"".join(
+        _newc_entry(ino, name, mode, data, mtime, rdev) for ino, (name, mode, data, rdev) in enumerate(entries, 1)
+    )
+    blob += _newc_entry(0, "TRAILER!!!", 0, b"", 0)
+    blob += b"\0" * (-len(blob) % 512)
+    path.write_bytes(blob)
+
+
+def toolchain_version(cc: str) -> str:
+    try:
+        proc = subprocess.run([cc, "--version"], capture_output=True, text=True, check=False)
+    except OSError:
+        return "missing"
+    lines = proc.stdout.splitlines()
+    return lines[0].strip() if lines else "missing"
+
+
+def main() -> int:
+    args = parser().parse_args()
+    try:
+        config = load_config(Path(args.config))
+    except (OSError, ValueError) as exc:
+        print(f"[ERROR] invalid benchmark list {args.config}: {exc}", file=sys.stderr)
+        return 1
+
+    out_dir = Path(args.out_dir)
+    bin_dir = out_dir / str(config["name"]) / "bin"
+    commands = compile_commands(config, args, bin_dir)
+    listing = bench_list(config)
+    if args.dry_run:
+        for cmd in commands:
+            print(f"[DRY-RUN] {shlex.join(cmd)}")
+        print(f"[DRY-RUN] /etc/omx_bench.list:\n{listing}", end="")
+        return 0
+
+    bin_dir.mkdir(parents=True, exist_ok=True)
+    for cmd in commands:
+        print(f"+ {shlex.join(cmd)}")
+        if subprocess.run(cmd).returncode != 0:
+            print(f"[ERROR] compile failed: {Path(cmd[-1]).name}", file=sys.stderr)
+            return 1
+
+    dirs, exe, ro = 0o040755, 0o100755, 0o100644
+    entries: List[Tuple[str, int, bytes, Tuple[int, int]]] = [
+        (name, dirs, b"", (0, 0)) for name in ("bin", "dev", "etc", "proc", "sys")
+    ]
+    entries.append(("dev/console", 0o020600, b"", (5, 1)))
+    entries.append(("init", exe, (bin_dir / "init").read_bytes(), (0, 0)))
+    for cmd in commands[1:]:
+        name = Path(cmd[cmd.index("-o") + 1]).name
+        entries.append((f"bin/{name}", exe, (bin_dir / name).read_bytes(), (0, 0)))
+    entries.append(("etc/omx_bench.list", ro, listing.encode(), (0, 0)))
+
+    cpio_path = out_dir / f"{config['name']}.cpio"
+    write_cpio(cpio_path, entries, int(os.environ.get("SOURCE_DATE_EPOCH", "0")))
+    sidecar = {
+        "kind": SIDECAR_KIND,
+        "name": config["name"],
+        "config": args.config,
+        "benchmarks": config["benchmarks"],
+        "m5_exit": bool(config.get("m5_exit", True)),
+        "stats_per_bench": bool(config.get("stats_per_bench", True)),
+        "cpio": str(cpio_path),
+        "sha256": hashlib.sha256(cpio_path.read_bytes()).hexdigest(),
+        "bytes": cpio_path.stat().st_size,
+        "files": {name: hashlib.sha256(data).hexdigest() for name, mode, data, _ in entries if mode in (exe, ro)},
+        "toolchain": toolchain_version(f"{args.cross_compile}gcc"),
+        "cflags": args.cflags,
+    }
+    cpio_path.with_suffix(".json").write_text(json.dumps(sidecar, indent=2) + "\n", encoding="utf-8")
+    print(f"[OK] {cpio_path} ({sidecar['bytes']} bytes, {len(config['benchmarks'])} benchmarks)")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Build the raw test disk for the riscv64_smp block I/O benchmark.
+
+Every 4 KiB block starts with "OMXB" and its little-endian u32 block index;
+the rest is zero. The blkio benchmark (workloads/linux/bench_initramfs)
+writes the same stamp, so reads can be verified no matter which pass wrote
+the block last. gem5 mounts the image behind a copy-on-write layer, so the
+file itself is never modified by a run.
+
+Outputs <out> and <out>.json (size, stamp layout, sha256); the image is
+byte-identical for the same --size-mb.
+"""
+
+import argparse
+import hashlib
+import json
+import struct
+import sys
+from pathlib import Path
+
+BLOCK = 4096
+STAMP = b"OMXB"
+SIDECAR_KIND = "omx-blk-image"
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Build a stamped raw disk image for the virtio-block benchmark",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--size-mb", type=int, default=64)
+    p.add_argument("--out", default="build/disk/blkbench.img")
+    return p
+
+
+def block(index: int) -> bytes:
+    return STAMP + struct.pack("<I", index) + bytes(BLOCK - len(STAMP) - 4)
+
+
+def main() -> int:
+    args = parser().parse_args()
+    if args.size_mb < 1:
+        print("[ERROR] --size-mb must be >= 1", file=sys.stderr)
+        return 1
+    out = Path(args.out)
+    out.parent.mkdir(parents=True, exist_ok=True)
+    blocks = args.size_mb * (1 << 20) // BLOCK
+    digest = hashlib.sha256()
+    with out.open("wb") as f:
+        for index in range(blocks):
+            data = block(index)
+            f.write(data)
+            digest.update(data)
+    sidecar = {
+        "kind": SIDECAR_KIND,
+        "image": str(out),
+        "bytes": blocks * BLOCK,
+        "block_bytes": BLOCK,
+        "stamp": "OMXB + u32le block index at every 4 KiB boundary",
+        "sha256": digest.hexdigest(),
+    }
+    out.with_name(out.name + ".json").write_text(json.dumps(sidecar, indent=2) + "\n", encoding="utf-8")
+    print(f"[OK] {out} ({sidecar['bytes']} bytes, {blocks} blocks)")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -9,6 +9,7 @@ BUILDROOT_SRC="${REPO_ROOT}/sources/buildroot"
 OUT_DIR="${REPO_ROOT}/build/buildroot"
 DEFCONFIG="qemu_riscv64_virt_defconfig"
 JOBS="$(nproc)"
+USE_CACHE="${OMX_ARTIFACT_CACHE}"
 DRY_RUN=0
 
 usage() {
@@ -21,6 +22,7 @@ Options:
   --out-dir <path>           Output dir (default: build/buildroot)
   --defconfig <name>         Buildroot defconfig (default: qemu_riscv64_virt_defconfig)
   --jobs <n>                 Parallel jobs (default: nproc)
+  --no-cache                 Ignore the prebuilt artifact cache (scripts/artifact_cache.py)
   --dry-run                  Print commands only
   -h, --help                 Show help
 USAGE
@@ -41,6 +43,7 @@ while [[ $# -gt 0 ]]; do
     --out-dir) OUT_DIR="$2"; shift 2 ;;
     --defconfig) DEFCONFIG="$2"; shift 2 ;;
     --jobs) JOBS="$2"; shift 2 ;;
+    --no-cache) USE_CACHE=0; shift ;;
     --dry-run) DRY_RUN=1; shift ;;
     -h|--help) usage; exit 0 ;;
     *) echo "[ERROR] Unknown arg: $1" >&2; usage; exit 1 ;;
@@ -57,6 +60,21 @@ if [[ "${DRY_RUN}" -eq 0 ]]; then
   exec > >(tee -a "${LOG_FILE}") 2>&1
 fi
 
+# The cache key trusts conf/submodules.lock.json, so a hit needs no checkout.
+cache_args=(buildroot --out-dir "${OUT_DIR}" --defconfig "${DEFCONFIG}")
+if [[ "${USE_CACHE}" != "0" && "${BUILDROOT_SRC}" != "${REPO_ROOT}/sources/buildroot" ]]; then
+  echo "[INFO] --buildroot-src is not the locked checkout; artifact cache disabled"
+  USE_CACHE=0
+fi
+if [[ "${USE_CACHE}" != "0" ]]; then
+  if [[ "${DRY_RUN}" -eq 1 ]]; then
+    echo "[DRY-RUN] python3 ${SCRIPT_DIR}/artifact_cache.py restore ${cache_args[*]}"
+  elif python3 "${SCRIPT_DIR}/artifact_cache.py" restore "${cache_args[@]}"; then
+    echo "[OK] Buildroot restored from artifact cache"
+    exit 0
+  fi
+fi
+
 if [[ ! -d "${BUILDROOT_SRC}" ]]; then
   if [[ "${DRY_RUN}" -eq 1 ]]; then
     echo "[WARN] Buildroot source path not found (dry-run only): ${BUILDROOT_SRC}" >&2
@@ -99,6 +117,10 @@ fi
 
 # 3) rootfs build with ccache
 run_cmd env BR2_CCACHE=y BR2_CCACHE_DIR="${CCACHE_DIR}" \
-  make -C "${BUILDROOT_SRC}" O="${OUT_DIR}" -j"${JOBS}"
+  make -C "${BUILDROOT_SRC}" O="${OUT_DIR}" $(omx_jobs_flag "${JOBS}")
+
+if [[ "${USE_CACHE}" != "0" ]]; then
+  run_cmd python3 "${SCRIPT_DIR}/artifact_cache.py" store "${cache_args[@]}" || echo "[WARN] artifact cache store failed"
+fi
 
 echo "[OK] Buildroot build flow completed (kernel disabled policy enforced)"
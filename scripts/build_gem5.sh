@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+SCRIPT_DIR="$(cd -- "$(dirname -- "${BASH_SOURCE[0]}")" && pwd)"
+REPO_ROOT="$(cd -- "${SCRIPT_DIR}/.." && pwd)"
+source "${SCRIPT_DIR}/env.sh"
+
+GEM5_SRC="${REPO_ROOT}/sources/gem5"
+VARIANT="fast"
+JOBS="$(nproc)"
+EXTRAS="${REPO_ROOT}/gem5_ext"
+PGO_DIR="${REPO_ROOT}/build/gem5-pgo"
+TRAIN_TICKS="20000000000"
+DRY_RUN=0
+
+usage() {
+  cat <<'USAGE'
+Usage:
+  scripts/build_gem5.sh [options]
+
+Variants (run_gem5.py --gem5-variant picks the binary):
+  opt    build/RISCV/gem5.opt       plain scons build (debuggable baseline)
+  fast   build/RISCV/gem5.fast      -O3, no asserts/tracing, --with-lto
+  pgo    build/RISCV_PGO/gem5.fast  fast + GCC profile-guided optimisation;
+                                    trained on scripts/bench_gem5_variants.py
+                                    slices (riscv32_simple, riscv32_mixed
+                                    atomic+timing, riscv64_smp boot)
+
+Options:
+  --variant <opt|fast|pgo|all>  Variant to build (default: fast)
+  --gem5-src <path>             gem5 source path (default: sources/gem5)
+  --jobs <n>                    Parallel jobs (default: nproc)
+  --no-extras                   Build without gem5_ext/ (drops --dvfs etc.)
+  --pgo-dir <path>              Profile data + training outputs (default: build/gem5-pgo)
+  --train-ticks <n>             Tick budget per training slice (default: 20000000000)
+  --dry-run                     Print commands only
+  -h, --help                    Show help
+USAGE
+}
+
+run_cmd() {
+  if [[ "${DRY_RUN}" -eq 1 ]]; then
+    echo "[DRY-RUN] $*"
+  else
+    echo "+ $*"
+    "$@"
+  fi
+}
+
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    --variant) VARIANT="$2"; shift 2 ;;
+    --gem5-src) GEM5_SRC="$2"; shift 2 ;;
+    --jobs) JOBS="$2"; shift 2 ;;
+    --no-extras) EXTRAS=""; shift ;;
+    --pgo-dir) PGO_DIR="$2"; shift 2 ;;
+    --train-ticks) TRAIN_TICKS="$2"; shift 2 ;;
+    --dry-run) DRY_RUN=1; shift ;;
+    -h|--help) usage; exit 0 ;;
+    *) echo "[ERROR] Unknown arg: $1" >&2; usage; exit 1 ;;
+  esac
+done
+
+case "${VARIANT}" in
+  opt|fast|pgo) VARIANTS=("${VARIANT}") ;;
+  all) VARIANTS=(opt fast pgo) ;;
+  *) echo "[ERROR] Invalid variant: ${VARIANT}" >&2; exit 1 ;;
+esac
+
+omx_ensure_build_layout
+LOG_DIR="$(omx_log_dir gem5)"
+LOG_FILE="${LOG_DIR}/build_gem5.log"
+
+if [[ "${DRY_RUN}" -eq 0 ]]; then
+  exec > >(tee -a "${LOG_FILE}") 2>&1
+fi
+
+if [[ ! -d "${GEM5_SRC}" ]]; then
+  if [[ "${DRY_RUN}" -eq 1 ]]; then
+    echo "[WARN] gem5 source path not found (dry-run only): ${GEM5_SRC}" >&2
+  else
+    echo "[ERROR] gem5 source path not found: ${GEM5_SRC}" >&2
+    echo "[HINT] Bootstrap first: scripts/bootstrap_sources.sh apply" >&2
+    exit 1
+  fi
+fi
+
+# scons has no jobserver client, so it always takes its own -j.
+scons_common=(-j"${JOBS}")
+if [[ -n "${EXTRAS}" ]]; then
+  scons_common+=(EXTRAS="${EXTRAS}")
+fi
+
+# CCFLAGS_EXTRA/LINKFLAGS_EXTRA are sticky scons variables; pass them on every
+# PGO build so the generate and use phases each rebuild with their own flags.
+build_pgo() {
+  local build_dir="build/RISCV_PGO"
+  local profile_dir="${PGO_DIR}/profile"
+  local gen_flags="-fprofile-generate=${profile_dir} -fprofile-update=prefer-atomic"
+  local use_flags="-fprofile-use=${profile_dir} -fprofile-partial-training -Wno-missing-profile"
+
+  if [[ "${DRY_RUN}" -eq 1 || ! -f "${GEM5_SRC}/${build_dir}/gem5.config" ]]; then
+    run_cmd scons -C "${GEM5_SRC}" defconfig "${build_dir}" build_opts/RISCV
+  fi
+
+  echo "[INFO] PGO 1/3: instrumented build"
+  run_cmd rm -rf "${profile_dir}"
+  run_cmd scons -C "${GEM5_SRC}" "${build_dir}/gem5.fast" --with-lto "${scons_common[@]}" \
+    CCFLAGS_EXTRA="${gen_flags}" LINKFLAGS_EXTRA="${gen_flags}"
+
+  echo "[INFO] PGO 2/3: training slices"
+  run_cmd python3 "${SCRIPT_DIR}/bench_gem5_variants.py" \
+    --gem5-bin "${GEM5_SRC}/${build_dir}/gem5.fast" --label pgo-train \
+    --max-ticks "${TRAIN_TICKS}" --out-root "${PGO_DIR}/train" \
+    || echo "[WARN] some training slices failed; continuing with the profile they wrote"
+  if [[ "${DRY_RUN}" -eq 0 ]] && ! find "${profile_dir}" -name '*.gcda' -print -quit 2>/dev/null | grep -q .; then
+    echo "[ERROR] training produced no profile data under ${profile_dir}" >&2
+    exit 1
+  fi
+
+  echo "[INFO] PGO 3/3: optimised build"
+  run_cmd scons -C "${GEM5_SRC}" "${build_dir}/gem5.fast" --with-lto "${scons_common[@]}" \
+    CCFLAGS_EXTRA="${use_flags}" LINKFLAGS_EXTRA="${use_flags}"
+}
+
+echo "[INFO] gem5 build variants=${VARIANTS[*]}"
+echo "[INFO] GEM5_SRC=${GEM5_SRC}"
+echo "[INFO] EXTRAS=${EXTRAS:-<none>}"
+echo "[INFO] LOG_FILE=${LOG_FILE}"
+
+for variant in "${VARIANTS[@]}"; do
+  case "${variant}" in
+    opt) run_cmd scons -C "${GEM5_SRC}" build/RISCV/gem5.opt "${scons_common[@]}" ;;
+    fast) run_cmd scons -C "${GEM5_SRC}" build/RISCV/gem5.fast --with-lto "${scons_common[@]}" ;;
+    pgo) build_pgo ;;
+  esac
+done
+
+echo "[OK] gem5 build flow completed (${VARIANTS[*]})"
@@ -12,6 +12,7 @@ CROSS_COMPILE="riscv64-linux-gnu-"
 DEFCONFIG="defconfig"
 JOBS="$(nproc)"
 MAKE_TARGETS="Image dtbs"
+USE_CACHE="${OMX_ARTIFACT_CACHE}"
 DRY_RUN=0
 
 usage() {
@@ -27,6 +28,7 @@ Options:
   --defconfig <name>         Defconfig target (default: defconfig)
   --make-targets "<targets>" Make targets to build (default: "Image dtbs")
   --jobs <n>                 Parallel jobs (default: nproc)
+  --no-cache                 Ignore the prebuilt artifact cache (scripts/artifact_cache.py)
   --dry-run                  Print commands only
   -h, --help                 Show help
 USAGE
@@ -50,6 +52,7 @@ while [[ $# -gt 0 ]]; do
     --defconfig) DEFCONFIG="$2"; shift 2 ;;
     --make-targets) MAKE_TARGETS="$2"; shift 2 ;;
     --jobs) JOBS="$2"; shift 2 ;;
+    --no-cache) USE_CACHE=0; shift ;;
     --dry-run) DRY_RUN=1; shift ;;
     -h|--help) usage; exit 0 ;;
     *) echo "[ERROR] Unknown arg: $1" >&2; usage; exit 1 ;;
@@ -66,6 +69,22 @@ if [[ "${DRY_RUN}" -eq 0 ]]; then
   exec > >(tee -a "${LOG_FILE}") 2>&1
 fi
 
+# The cache key trusts conf/submodules.lock.json, so a hit needs no checkout.
+cache_args=(linux --out-dir "${OUT_DIR}" --defconfig "${DEFCONFIG}" --arch "${ARCH}"
+  --cross-compile "${CROSS_COMPILE}" --make-targets "${MAKE_TARGETS}")
+if [[ "${USE_CACHE}" != "0" && "${LINUX_SRC}" != "${REPO_ROOT}/sources/linux" ]]; then
+  echo "[INFO] --linux-src is not the locked checkout; artifact cache disabled"
+  USE_CACHE=0
+fi
+if [[ "${USE_CACHE}" != "0" ]]; then
+  if [[ "${DRY_RUN}" -eq 1 ]]; then
+    echo "[DRY-RUN] python3 ${SCRIPT_DIR}/artifact_cache.py restore ${cache_args[*]}"
+  elif python3 "${SCRIPT_DIR}/artifact_cache.py" restore "${cache_args[@]}"; then
+    echo "[OK] Linux restored from artifact cache"
+    exit 0
+  fi
+fi
+
 if [[ ! -d "${LINUX_SRC}" ]]; then
   if [[ "${DRY_RUN}" -eq 1 ]]; then
     echo "[WARN] Linux source path not found (dry-run only): ${LINUX_SRC}" >&2
@@ -89,6 +108,10 @@ run_cmd env ARCH="${ARCH}" CROSS_COMPILE="${CROSS_COMPILE}" CC="${CC}" HOSTCC="$
   make -C "${LINUX_SRC}" O="${OUT_DIR}" olddefconfig
 
 run_cmd env ARCH="${ARCH}" CROSS_COMPILE="${CROSS_COMPILE}" CC="${CC}" HOSTCC="${CC}" \
-  make -C "${LINUX_SRC}" O="${OUT_DIR}" -j"${JOBS}" ${MAKE_TARGETS}
+  make -C "${LINUX_SRC}" O="${OUT_DIR}" $(omx_jobs_flag "${JOBS}") ${MAKE_TARGETS}
+
+if [[ "${USE_CACHE}" != "0" ]]; then
+  run_cmd python3 "${SCRIPT_DIR}/artifact_cache.py" store "${cache_args[@]}" || echo "[WARN] artifact cache store failed"
+fi
 
 echo "[OK] Linux build flow completed"
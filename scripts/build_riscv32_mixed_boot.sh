@@ -6,9 +6,9 @@ REPO_ROOT="$(cd -- "${SCRIPT_DIR}/.." && pwd)"
 source "${SCRIPT_DIR}/env.sh"
 
 BOOT_START="0x80000000"
-AMP_CPU0_ENTRY="0x81000000"
-AMP_CPU1_ENTRY="0x84000000"
-CLUSTER1_SMP_ENTRY="0x88000000"
+BOOT_TABLE=""
+PLAN_JSON=""
+PLAN_ARGS=()
 OUTPUT="${REPO_ROOT}/build/boot/riscv32_mixed_boot.elf"
 DRY_RUN=0
 
@@ -19,10 +19,14 @@ Usage:
 
 Options:
   --boot-start <addr>
-  --amp-cpu0-entry <addr>
-  --amp-cpu1-entry <addr>
-  --cluster1-smp-entry <addr>
+  --boot-table <path>    per-hart boot table from scripts/gen_topology.py
+  --plan-json <path>     platform plan from conf/riscv32_mixed.py --print-json
+  --plan-arg <arg>       extra conf/riscv32_mixed.py option for the default
+                         plan (repeatable, e.g. --plan-arg=--topology=...)
   --output <path>
+
+Without --boot-table or --plan-json the table comes from the default
+conf/riscv32_mixed.py --print-json plan (entry PCs from the built images).
   --dry-run
   -h, --help
 USAGE
@@ -40,9 +44,10 @@ run_cmd() {
 while [[ $# -gt 0 ]]; do
   case "$1" in
     --boot-start) BOOT_START="$2"; shift 2 ;;
-    --amp-cpu0-entry) AMP_CPU0_ENTRY="$2"; shift 2 ;;
-    --amp-cpu1-entry) AMP_CPU1_ENTRY="$2"; shift 2 ;;
-    --cluster1-smp-entry) CLUSTER1_SMP_ENTRY="$2"; shift 2 ;;
+    --boot-table) BOOT_TABLE="$2"; shift 2 ;;
+    --plan-json) PLAN_JSON="$2"; shift 2 ;;
+    --plan-arg) PLAN_ARGS+=("$2"); shift 2 ;;
+    --plan-arg=*) PLAN_ARGS+=("${1#--plan-arg=}"); shift ;;
     --output) OUTPUT="$2"; shift 2 ;;
     --dry-run) DRY_RUN=1; shift ;;
     -h|--help) usage; exit 0 ;;
@@ -61,13 +66,25 @@ OUT_DIR="$(dirname -- "${OUTPUT}")"
 mkdir -p "${OUT_DIR}"
 TMP_DIR="${OUT_DIR}/.riscv32_mixed_boot_tmp"
 mkdir -p "${TMP_DIR}"
-ADDR_HEADER="${TMP_DIR}/riscv32_mixed_boot_addr.h"
+TABLE_HEADER="${TMP_DIR}/riscv32_mixed_boot_table.h"
 
-cat > "${ADDR_HEADER}" <<EOF2
-#define AMP_CPU0_ENTRY ${AMP_CPU0_ENTRY}
-#define AMP_CPU1_ENTRY ${AMP_CPU1_ENTRY}
-#define CLUSTER1_SMP_ENTRY ${CLUSTER1_SMP_ENTRY}
-EOF2
+if [[ -n "${BOOT_TABLE}" ]]; then
+  if [[ ! -f "${BOOT_TABLE}" ]]; then
+    echo "[ERROR] boot table not found: ${BOOT_TABLE}" >&2
+    exit 1
+  fi
+  cp "${BOOT_TABLE}" "${TABLE_HEADER}"
+else
+  if [[ -z "${PLAN_JSON}" ]]; then
+    PLAN_JSON="${TMP_DIR}/plan.json"
+    (cd "${REPO_ROOT}" && python3 conf/riscv32_mixed.py --print-json --boot-base "${BOOT_START}" \
+      "${PLAN_ARGS[@]+"${PLAN_ARGS[@]}"}") > "${PLAN_JSON}"
+  elif [[ ! -f "${PLAN_JSON}" ]]; then
+    echo "[ERROR] platform plan not found: ${PLAN_JSON}" >&2
+    exit 1
+  fi
+  python3 "${SCRIPT_DIR}/gen_topology.py" --plan-json "${PLAN_JSON}" --out-dir "${TMP_DIR}"
+fi
 
 run_cmd "${CC}" \
   -march=rv32imac_zicsr_zifencei -mabi=ilp32 \
@@ -80,4 +97,4 @@ run_cmd "${CC}" \
   -o "${OUTPUT}"
 
 echo "[OK] mixed boot trampoline: ${OUTPUT}"
-echo "[INFO] boot_start=${BOOT_START} amp_cpu0=${AMP_CPU0_ENTRY} amp_cpu1=${AMP_CPU1_ENTRY} cluster1_smp=${CLUSTER1_SMP_ENTRY}"
+echo "[INFO] boot_start=${BOOT_START} boot_table=${BOOT_TABLE:-${PLAN_JSON}}"
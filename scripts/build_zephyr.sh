@@ -12,7 +12,9 @@ BOARD="qemu_riscv32"
 BUILD_ROOT="${REPO_ROOT}/build/zephyr"
 OVERLAY=""
 EXTRA_CONF=""
+TOPOLOGY_DIR=""
 JOBS="$(nproc)"
+USE_CACHE="${OMX_ARTIFACT_CACHE}"
 DRY_RUN=0
 CMAKE_ONLY=0
 
@@ -27,9 +29,13 @@ Options:
   --board <board>            Zephyr board name
   --build-root <path>        Zephyr build root (default: build/zephyr)
   --overlay <path>           Override overlay file path
-  --extra-conf <path>        Additional Zephyr config fragment
+  --extra-conf <path>        Additional Zephyr config fragment(s), ';'-separated
+  --topology-dir <path>      scripts/gen_topology.py output dir; --target may then
+                             name any image it generated (mixed app, generated
+                             overlay/conf)
   --jobs <n>                 Build jobs (default: nproc)
   --cmake-only               Configure only; skip build step
+  --no-cache                 Ignore the prebuilt artifact cache (scripts/artifact_cache.py)
   --dry-run                  Print commands only
   -h, --help                 Show help
 USAGE
@@ -52,24 +58,35 @@ while [[ $# -gt 0 ]]; do
     --build-root) BUILD_ROOT="$2"; shift 2 ;;
     --overlay) OVERLAY="$2"; shift 2 ;;
     --extra-conf) EXTRA_CONF="$2"; shift 2 ;;
+    --topology-dir) TOPOLOGY_DIR="$2"; shift 2 ;;
     --jobs) JOBS="$2"; shift 2 ;;
     --cmake-only) CMAKE_ONLY=1; shift ;;
+    --no-cache) USE_CACHE=0; shift ;;
     --dry-run) DRY_RUN=1; shift ;;
     -h|--help) usage; exit 0 ;;
     *) echo "[ERROR] Unknown arg: $1" >&2; usage; exit 1 ;;
   esac
 done
 
+TOPOLOGY_IMAGE=0
+if [[ -n "${TOPOLOGY_DIR}" && -f "${TOPOLOGY_DIR}/zephyr/${TARGET}.overlay" ]]; then
+  TOPOLOGY_IMAGE=1
+fi
+
 case "${TARGET}" in
   cluster0_amp_cpu0|cluster0_amp_cpu1|cluster1_smp|riscv32_simple) ;;
   *)
-    echo "[ERROR] Invalid target: ${TARGET}" >&2
-    usage
-    exit 1
+    if [[ "${TOPOLOGY_IMAGE}" -eq 0 ]]; then
+      echo "[ERROR] Invalid target: ${TARGET}" >&2
+      usage
+      exit 1
+    fi
     ;;
 esac
 
-if [[ "${APP_EXPLICIT}" -eq 0 ]]; then
+if [[ "${APP_EXPLICIT}" -eq 0 && "${TOPOLOGY_IMAGE}" -eq 1 ]]; then
+  APP_DIR="${REPO_ROOT}/workloads/zephyr/riscv32_mixed"
+elif [[ "${APP_EXPLICIT}" -eq 0 ]]; then
   case "${TARGET}" in
     riscv32_simple)
       APP_DIR="${REPO_ROOT}/workloads/zephyr/riscv32_simple"
@@ -83,11 +100,15 @@ if [[ "${APP_EXPLICIT}" -eq 0 ]]; then
   esac
 fi
 
-if [[ -z "${OVERLAY}" ]]; then
+if [[ -z "${OVERLAY}" && "${TOPOLOGY_IMAGE}" -eq 1 ]]; then
+  OVERLAY="${TOPOLOGY_DIR}/zephyr/${TARGET}.overlay"
+elif [[ -z "${OVERLAY}" ]]; then
   OVERLAY="${REPO_ROOT}/conf/zephyr/${TARGET}.overlay"
 fi
 
-if [[ -z "${EXTRA_CONF}" ]]; then
+if [[ -z "${EXTRA_CONF}" && "${TOPOLOGY_IMAGE}" -eq 1 ]]; then
+  EXTRA_CONF="${TOPOLOGY_DIR}/zephyr/${TARGET}.conf"
+elif [[ -z "${EXTRA_CONF}" ]]; then
   case "${TARGET}" in
     cluster0_amp_cpu0|cluster0_amp_cpu1|cluster1_smp)
       EXTRA_CONF="${REPO_ROOT}/conf/zephyr/${TARGET}.conf"
@@ -124,9 +145,28 @@ if [[ ! -f "${OVERLAY}" ]]; then
   exit 1
 fi
 
-if [[ -n "${EXTRA_CONF}" && ! -f "${EXTRA_CONF}" ]]; then
-  echo "[ERROR] extra conf not found: ${EXTRA_CONF}" >&2
-  exit 1
+if [[ -n "${EXTRA_CONF}" ]]; then
+  IFS=';' read -r -a extra_confs <<<"${EXTRA_CONF}"
+  for conf in "${extra_confs[@]}"; do
+    if [[ ! -f "${conf}" ]]; then
+      echo "[ERROR] extra conf not found: ${conf}" >&2
+      exit 1
+    fi
+  done
+fi
+
+cache_args=(zephyr --out-dir "${BUILD_DIR}" --target "${TARGET}" --app "${APP_DIR}" --board "${BOARD}"
+  --overlay "${OVERLAY}" --extra-conf "${EXTRA_CONF}")
+if [[ "${CMAKE_ONLY}" -eq 1 ]]; then
+  USE_CACHE=0
+fi
+if [[ "${USE_CACHE}" != "0" ]]; then
+  if [[ "${DRY_RUN}" -eq 1 ]]; then
+    echo "[DRY-RUN] python3 ${SCRIPT_DIR}/artifact_cache.py restore ${cache_args[*]}"
+  elif python3 "${SCRIPT_DIR}/artifact_cache.py" restore "${cache_args[@]}"; then
+    echo "[OK] Zephyr ${TARGET} restored from artifact cache"
+    exit 0
+  fi
 fi
 
 if [[ -f "${BUILD_DIR}/CMakeCache.txt" ]]; then
@@ -169,9 +209,9 @@ run_cmd cmake "${cmake_args[@]}"
 
 if [[ "${CMAKE_ONLY}" -eq 0 ]]; then
   if [[ "${DRY_RUN}" -eq 1 ]]; then
-    run_cmd cmake --build "${BUILD_DIR}" -j"${JOBS}"
+    run_cmd cmake --build "${BUILD_DIR}" $(omx_jobs_flag "${JOBS}" ninja)
   else
-    if ! cmake --build "${BUILD_DIR}" -j"${JOBS}"; then
+    if ! cmake --build "${BUILD_DIR}" $(omx_jobs_flag "${JOBS}" ninja); then
       if [[ "${TARGET}" == "cluster1_smp" && "${JOBS}" != "1" ]]; then
         echo "[WARN] initial parallel build failed for ${TARGET}; retrying with -j1"
         cmake --build "${BUILD_DIR}" -j1
@@ -185,4 +225,8 @@ else
   echo "[INFO] --cmake-only set; skipping build step"
 fi
 
+if [[ "${USE_CACHE}" != "0" ]]; then
+  run_cmd python3 "${SCRIPT_DIR}/artifact_cache.py" store "${cache_args[@]}" || echo "[WARN] artifact cache store failed"
+fi
+
 echo "[OK] Zephyr build flow completed"
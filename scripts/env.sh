@@ -38,6 +38,11 @@ fi
 export BUILD_ROOT="${BUILD_ROOT:-${REPO_ROOT}/build}"
 export BUILD_LOG_ROOT="${BUILD_LOG_ROOT:-${BUILD_ROOT}/logs}"
 
+# Prebuilt artifact store (scripts/artifact_cache.py); OMX_ARTIFACT_CACHE=0
+# makes the build scripts ignore it.
+export OMX_ARTIFACT_CACHE="${OMX_ARTIFACT_CACHE:-1}"
+export OMX_ARTIFACT_CACHE_DIR="${OMX_ARTIFACT_CACHE_DIR:-${REPO_ROOT}/build/.artifact-cache}"
+
 omx_ts_utc() {
   date -u +%Y%m%dT%H%M%SZ
 }
@@ -60,6 +65,18 @@ omx_log_dir() {
   echo "${log_dir}"
 }
 
+# -j flag for make/ninja. Under scripts/build_all.py (OMX_JOBSERVER=fifo|pipe)
+# it is empty so the tools join the shared jobserver advertised in MAKEFLAGS;
+# ninja cannot read the pipe form and stays within its node's token (-j1).
+omx_jobs_flag() {
+  local jobs="$1" tool="${2:-make}"
+  if [[ -z "${OMX_JOBSERVER:-}" ]]; then
+    echo "-j${jobs}"
+  elif [[ "${OMX_JOBSERVER}" == "pipe" && "${tool}" == "ninja" ]]; then
+    echo "-j1"
+  fi
+}
+
 omx_print_env_contract() {
   cat <<EOF2
 REPO_ROOT=${REPO_ROOT}
@@ -71,6 +88,8 @@ ZEPHYR_BASE=${ZEPHYR_BASE}
 ZEPHYR_SDK_INSTALL_DIR=${ZEPHYR_SDK_INSTALL_DIR}
 BUILD_ROOT=${BUILD_ROOT}
 BUILD_LOG_ROOT=${BUILD_LOG_ROOT}
+OMX_ARTIFACT_CACHE=${OMX_ARTIFACT_CACHE}
+OMX_ARTIFACT_CACHE_DIR=${OMX_ARTIFACT_CACHE_DIR}
 EOF2
 }
 
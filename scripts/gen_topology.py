@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+"""Generate boot table, memory map and Zephyr overlays from a topology.
+
+Reads a cluster/hart description (conf/topology/*.json) and writes:
+- riscv32_mixed_boot_table.h: per-hart boot table for scripts/riscv32_mixed_boot.S
+- memory_map.json: derived clusters, images, segments and boot table
+- zephyr/<image>.overlay, zephyr/<image>.conf: one pair per Zephyr image
+
+conf/zephyr/cluster0_amp_cpu*.{overlay,conf} and cluster1_smp.{overlay,conf}
+are this script's output for conf/topology/riscv32_mixed.json.
+
+With --plan-json only the boot table is written, from the platform plan of
+`conf/riscv32_mixed.py --print-json` (scripts/build_riscv32_mixed_boot.sh).
+"""
+
+import argparse
+import json
+import sys
+from pathlib import Path
+from typing import Dict, List
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+sys.path.insert(0, str(REPO_ROOT / "conf"))
+
+from omx_topology import (  # noqa: E402
+    _int,
+    apply_elf_entries,
+    boot_flags,
+    derive_topology,
+    load_topology,
+)
+
+# cpu@0..7 exist in the qemu_riscv32 board DT; images on higher harts get
+# their cpu nodes from the overlay.
+BOARD_CPUS = 8
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Derive boot table, memory map and Zephyr overlays from a topology description",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--topology", default="conf/topology/riscv32_mixed.json")
+    p.add_argument("--out-dir", default="", help="output dir (default: build/topology/<name>)")
+    p.add_argument(
+        "--image-dir",
+        default="build/zephyr",
+        help="Zephyr build root; <image-dir>/<image>/zephyr/zephyr.elf supplies the entry PC when present",
+    )
+    p.add_argument("--print-json", action="store_true", help="print memory_map.json to stdout as well")
+    p.add_argument(
+        "--plan-json",
+        default="",
+        help="write only riscv32_mixed_boot_table.h from a conf/riscv32_mixed.py --print-json plan ('-': stdin)",
+    )
+    return p
+
+
+def _source_label(topology: Dict[str, object]) -> str:
+    source = Path(str(topology["source"])).resolve()
+    try:
+        return str(source.relative_to(REPO_ROOT))
+    except ValueError:
+        return str(source)
+
+
+def boot_table_header(boot: Dict[str, object], rows: List[Dict[str, object]], source: str) -> str:
+    """Rows of scripts/riscv32_mixed_boot.S: entry, stack, a0, a1, flags, release mtime."""
+    lines = [
+        f"/* Generated by scripts/gen_topology.py from {source}; do not edit. */",
+        f"#define OMX_BOOT_CLINT_BASE 0x{_int(boot['clint_base']):08x}",
+        f"#define OMX_BOOT_RELEASE_BASE 0x{_int(boot['release_base']):08x}",
+        "/* One row per hart, indexed by mhartid; entry 0 parks the hart.",
+        " * flags: 1 hold until released, 2 wait for the release mtime. */",
+    ]
+    for row in rows:
+        words = [row["entry"], row["stack"], row["a0"], row["a1"], boot_flags(row), row["release_mtime"]]
+        lines.append(
+            "    .word " + ", ".join(f"0x{_int(word):08x}" for word in words) + f" /* hart {row['hart']}: {row['image']} */"
+        )
+    return "\n".join(lines) + "\n"
+
+
+def _uart_node(index: int, base: int, okay: bool) -> List[str]:
+    return [
+        f"  uart{index}: uart@{base:x} {{",
+        '    compatible = "ns16550";',
+        f"    reg = <0x{base:08x} 0x100>;",
+        "    interrupt-parent = <&plic>;",
+        "    interrupts = <0x0a 1>;",
+        "    clock-frequency = <0x384000>;",
+        "    reg-shift = <0>;",
+        f'    status = "{"okay" if okay else "disabled"}";',
+        "  };",
+        "",
+    ]
+
+
+def _cpu_node(hart: int) -> List[str]:
+    return [
+        f"  cpu@{hart} {{",
+        '    device_type = "cpu";',
+        '    compatible = "riscv";',
+        f"    reg = <{hart}>;",
+        '    riscv,isa = "rv32imac_zicsr_zifencei";',
+        '    status = "okay";',
+        "",
+        f"    hlic{hart}: interrupt-controller {{",
+        '      compatible = "riscv,cpu-intc";',
+        "      #address-cells = <0>;",
+        "      #interrupt-cells = <1>;",
+        "      interrupt-controller;",
+        "    };",
+        "  };",
+    ]
+
+
+def zephyr_overlay(topology: Dict[str, object], image: Dict[str, object]) -> str:
+    images = topology["images"]
+    own = int(image["index"])
+    lines = [
+        f"/* {image['name']} overlay: generated by scripts/gen_topology.py from "
+        f"{_source_label(topology)} (no-west flow) */",
+        "/ {",
+        "  chosen {",
+        f"    zephyr,console = &uart{own};",
+        f"    zephyr,shell-uart = &uart{own};",
+        "  };",
+        "",
+    ]
+    for other in images[1:]:
+        lines += _uart_node(int(other["index"]), int(other["uart_base"]), other is image)
+
+    lines += [
+        "  zephyr,user {",
+        f'    omx-role = "{image["role"]}";',
+        f'    omx-marker-role = "{image["marker_role"]}";',
+        f'    omx-uart-policy = "{image["uart_policy"]}";',
+        '    omx-mailbox = "placeholder";',
+        '    omx-hwsem = "placeholder";',
+        "    /* ROLE_SYNC: slot <index> of the shared segment, ready mask over all images. */",
+        f"    omx-sync-base = <0x{int(topology['sync']['base']):08x}>;",
+        f"    omx-image-index = <{own}>;",
+        f"    omx-image-count = <{len(images)}>;",
+    ]
+    if topology["sync"]["master"] == image["name"]:
+        lines.append("    omx-sync-master;")
+    if image["dvfs_domain"] is not None:
+        lines += [
+            f"    /* OmxDvfsCtrl block (gem5 --dvfs); this image owns clock domain {image['dvfs_domain']}. */",
+            f"    omx-dvfs-base = <0x{int(topology['dvfs_ctrl']['base']):08x}>;",
+            f"    omx-dvfs-domain = <{image['dvfs_domain']}>;",
+        ]
+    if topology["hybrid_shm"]["responder"] == image["name"]:
+        shm = topology["hybrid_shm"]
+        lines += [
+            "    /* Linux<->Zephyr window (conf/riscv_hybrid.py --hybrid-shm), served with",
+            "     * CONFIG_RISCV32_MIXED_HYBRID_SHM=y. */",
+            f"    omx-hybrid-shm-base = <0x{int(shm['base']):08x}>;",
+            f"    omx-hybrid-shm-size = <0x{int(shm['size']):08x}>;",
+        ]
+    lines += ["  };", "};", ""]
+
+    for other in images:
+        status = "okay" if other is image else "disabled"
+        lines.append(f"&uart{other['index']} {{ status = \"{status}\"; }};")
+    lines += [
+        "",
+        "&ram0 {",
+        f"  reg = <0x{int(image['base']):08x} 0x{int(image['size']):08x}>;",
+        "};",
+        "",
+    ]
+    for hart in range(BOARD_CPUS):
+        if hart not in image["harts"]:
+            lines.append(f"&{{/cpus/cpu@{hart}}} {{ status = \"disabled\"; }};")
+
+    extra = [hart for hart in image["harts"] if hart >= BOARD_CPUS]
+    if extra:
+        lines += [
+            "",
+            "/* Harts beyond the board DT. The CLINT timer/IPI registers are indexed by",
+            " * mhartid, so these harts need no interrupts-extended entries. */",
+            "&{/cpus} {",
+        ]
+        for pos, hart in enumerate(extra):
+            if pos:
+                lines.append("")
+            lines += _cpu_node(hart)
+        lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def zephyr_conf(image: Dict[str, object]) -> str:
+    harts = image["harts"]
+    if image["mode"] == "smp":
+        lines = [
+            f"CONFIG_RV_BOOT_HART={image['boot_hart']}",
+            "CONFIG_SMP=y",
+            f"CONFIG_MP_MAX_NUM_CPUS={len(harts)}",
+            "CONFIG_RISCV_SMP_IPI_CLINT=y",
+        ]
+    else:
+        # Zephyr expects the boot hart id below MP_MAX_NUM_CPUS even with SMP off.
+        lines = [
+            f"CONFIG_RV_BOOT_HART={image['boot_hart']}",
+            "CONFIG_SMP=n",
+            f"CONFIG_MP_MAX_NUM_CPUS={int(image['boot_hart']) + 1}",
+        ]
+    return "\n".join(lines) + "\n"
+
+
+def generate(topology: Dict[str, object], out_dir: Path, image_dir: Path) -> Dict[str, object]:
+    for image in topology["images"]:
+        image["elf"] = str(image_dir / str(image["name"]) / "zephyr" / "zephyr.elf")
+    apply_elf_entries(topology)
+
+    zephyr_dir = out_dir / "zephyr"
+    zephyr_dir.mkdir(parents=True, exist_ok=True)
+    boot_table = out_dir / "riscv32_mixed_boot_table.h"
+    boot_table.write_text(
+        boot_table_header(topology["boot"], topology["boot_table"], _source_label(topology)), encoding="utf-8"
+    )
+    generated = [str(boot_table)]
+    for image in topology["images"]:
+        overlay = zephyr_dir / f"{image['name']}.overlay"
+        conf = zephyr_dir / f"{image['name']}.conf"
+        overlay.write_text(zephyr_overlay(topology, image), encoding="utf-8")
+        conf.write_text(zephyr_conf(image), encoding="utf-8")
+        generated += [str(overlay), str(conf)]
+
+    memory_map = dict(topology, generated=generated, zephyr_dir=str(zephyr_dir))
+    memory_map_path = out_dir / "memory_map.json"
+    memory_map_path.write_text(json.dumps(memory_map, indent=2) + "\n", encoding="utf-8")
+    return memory_map
+
+
+def generate_from_plan(plan_json: str, out_dir: str) -> int:
+    try:
+        text = sys.stdin.read() if plan_json == "-" else Path(plan_json).read_text(encoding="utf-8")
+        plan = json.loads(text)
+        boot, rows = plan["boot"], plan["boot_table"]
+    except (OSError, ValueError, KeyError) as exc:
+        print(f"[ERROR] invalid platform plan {plan_json}: {exc}", file=sys.stderr)
+        return 1
+    name = str(plan["topology"]["name"])
+    path = Path(out_dir or f"build/topology/{name}") / "riscv32_mixed_boot_table.h"
+    path.parent.mkdir(parents=True, exist_ok=True)
+    source = "stdin" if plan_json == "-" else plan_json
+    path.write_text(boot_table_header(boot, rows, f"the {name} platform plan ({source})"), encoding="utf-8")
+    print(f"[OK] boot table {name}: {len(rows)} harts -> {path}")
+    return 0
+
+
+def main() -> int:
+    args = parser().parse_args()
+    if args.plan_json:
+        return generate_from_plan(args.plan_json, args.out_dir)
+    try:
+        topology = derive_topology(load_topology(args.topology))
+    except (OSError, ValueError, KeyError) as exc:
+        print(f"[ERROR] invalid topology {args.topology}: {exc}", file=sys.stderr)
+        return 1
+
+    out_dir = Path(args.out_dir or f"build/topology/{topology['name']}")
+    memory_map = generate(topology, out_dir, Path(args.image_dir))
+    if args.print_json:
+        print(json.dumps(memory_map, indent=2))
+    print(
+        f"[OK] topology {topology['name']}: {topology['num_harts']} harts, "
+        f"{len(topology['clusters'])} clusters, {len(topology['images'])} images -> {out_dir}",
+        file=sys.stderr if args.print_json else sys.stdout,
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
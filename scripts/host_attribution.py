@@ -0,0 +1,242 @@
+#!/usr/bin/env python3
+"""Per-system host-time attribution of a riscv_hybrid run.
+
+gem5 has a single event queue and no per-SimObject host timers, so host time
+is attributed from periodic cumulative stats dumps instead
+(conf/riscv_hybrid.py --host-attribution-period). Every pair of consecutive
+dumps is one slice with its host seconds and, per system (system32,
+system64), the committed instructions, active CPU cycles and crossbar
+packets of that slice. A non-negative least-squares fit of
+
+    host_seconds = overhead + c32 * insts32 + c64 * insts64
+
+over the slices gives each system's host cost per simulated instruction;
+the slices differ in how busy each side is (Zephyr finishing early, Linux
+booting and idling), which is what separates the two costs. overhead is
+the per-slice cost of everything else, the stats dump included.
+
+run_gem5.py adds the summary to the hybrid stage_report and the manifest as
+host_attribution. CLI: print the JSON summary for a stats.txt.
+"""
+
+import argparse
+import itertools
+import json
+import re
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence
+
+SYSTEMS = ("system32", "system64")
+BEGIN_MARK = "---------- Begin Simulation Statistics"
+END_MARK = "---------- End Simulation Statistics"
+# conf/ --stats-format json: one {"tick", "stats"} line per dump instead of stats.txt blocks.
+STATS_JSON = "stats.jsonl"
+CPU_STAT_RE = re.compile(
+    r"^(?P<system>system\d+)\.(?P<cpu>(?:\S+\.)?cpu\d*)\."
+    r"(?P<stat>numCycles|commitStats0\.numInsts|exec_context\.thread_0\.numInsts|committedInsts)$"
+)
+XBAR_PKT_RE = re.compile(r"^(?P<system>system\d+)\.\S+\.pktCount::total$")
+# Per CPU, the first instruction counter present wins (names differ across CPU models and gem5 releases).
+INST_STATS = ("commitStats0.numInsts", "exec_context.thread_0.numInsts", "committedInsts")
+# Fewer slices than this cannot separate two costs and an overhead.
+MIN_SLICES = 3
+
+
+def stats_blocks(stats_path: Path) -> List[List[str]]:
+    """Lines of every stats dump in order; an unterminated tail (killed run) counts as a dump.
+
+    Without text dumps, the dumps of a sibling stats.jsonl are returned as the
+    same "name value" lines.
+    """
+    blocks: List[List[str]] = []
+    json_path = stats_path.with_name(STATS_JSON)
+    if (not stats_path.exists() or stats_path.stat().st_size == 0) and json_path.exists():
+        for line in json_path.read_text(encoding="utf-8", errors="ignore").splitlines():
+            try:
+                dump = json.loads(line)
+            except ValueError:
+                continue
+            blocks.append([f"{name} {value}" for name, value in dump["stats"].items() if value is not None])
+        return blocks
+    if not stats_path.exists():
+        return blocks
+    current: Optional[List[str]] = []
+    for line in stats_path.read_text(encoding="utf-8", errors="ignore").splitlines():
+        if line.startswith(BEGIN_MARK):
+            current = []
+        elif line.startswith(END_MARK):
+            if current is not None:
+                blocks.append(current)
+            current = None
+        elif current is not None:
+            current.append(line)
+    if current and any(line.strip() for line in current):
+        blocks.append(current)
+    return blocks
+
+
+def last_stats_block(stats_path: Path) -> List[str]:
+    """The last dump: the whole run, since periodic dumps never reset the stats."""
+    blocks = stats_blocks(stats_path)
+    return blocks[-1] if blocks else []
+
+
+def block_counters(lines: Sequence[str]) -> Dict[str, object]:
+    """hostSeconds, simTicks and per-system insts/cycles/packets of one cumulative dump."""
+    host_seconds = sim_ticks = 0.0
+    cpus: Dict[str, Dict[str, Dict[str, float]]] = {name: {} for name in SYSTEMS}
+    packets: Dict[str, float] = {name: 0.0 for name in SYSTEMS}
+    for line in lines:
+        columns = line.split()
+        if len(columns) < 2:
+            continue
+        try:
+            value = float(columns[1])
+        except ValueError:
+            continue
+        if columns[0] == "hostSeconds":
+            host_seconds = value
+            continue
+        if columns[0] == "simTicks":
+            sim_ticks = value
+            continue
+        match = CPU_STAT_RE.match(columns[0])
+        if match and match.group("system") in cpus:
+            cpus[match.group("system")].setdefault(match.group("cpu"), {})[match.group("stat")] = value
+            continue
+        match = XBAR_PKT_RE.match(columns[0])
+        if match and match.group("system") in packets:
+            packets[match.group("system")] += value
+
+    systems: Dict[str, Dict[str, float]] = {}
+    for name in SYSTEMS:
+        insts = cycles = 0.0
+        for stats in cpus[name].values():
+            insts += next((stats[key] for key in INST_STATS if key in stats), 0.0)
+            cycles += stats.get("numCycles", 0.0)
+        systems[name] = {"insts": insts, "cycles": cycles, "packets": packets[name]}
+    return {"host_seconds": host_seconds, "sim_ticks": sim_ticks, "systems": systems}
+
+
+def _solve(rows: List[List[float]], ys: List[float], cols: Sequence[int]) -> Optional[List[float]]:
+    """Least squares on the chosen columns via the normal equations; None if singular."""
+    n = len(cols)
+    a = [[sum(r[i] * r[j] for r in rows) for j in cols] + [sum(r[i] * y for r, y in zip(rows, ys))] for i in cols]
+    for k in range(n):
+        pivot = max(range(k, n), key=lambda i: abs(a[i][k]))
+        if abs(a[pivot][k]) < 1e-30:
+            return None
+        a[k], a[pivot] = a[pivot], a[k]
+        for i in range(n):
+            if i != k:
+                f = a[i][k] / a[k][k]
+                a[i] = [x - f * y for x, y in zip(a[i], a[k])]
+    return [a[i][n] / a[i][i] for i in range(n)]
+
+
+def nnls_fit(rows: List[List[float]], ys: List[float]) -> Optional[Dict[str, object]]:
+    """Best non-negative fit over every subset of columns (three columns, so exhaustive is cheap)."""
+    best: Optional[Dict[str, object]] = None
+    width = len(rows[0])
+    # Instruction counts are ~1e8 per slice next to a 1.0 intercept column; solve on unit-scaled columns.
+    scale = [max(abs(r[col]) for r in rows) or 1.0 for col in range(width)]
+    scaled = [[x / k for x, k in zip(r, scale)] for r in rows]
+    for size in range(width, 0, -1):
+        for cols in itertools.combinations(range(width), size):
+            coef = _solve(scaled, ys, cols)
+            if coef is None or min(coef) < 0:
+                continue
+            full = [0.0] * width
+            for col, value in zip(cols, coef):
+                full[col] = value / scale[col]
+            residual = sum((y - sum(c * x for c, x in zip(full, r))) ** 2 for r, y in zip(rows, ys))
+            if best is None or residual < best["residual"] - 1e-18:
+                best = {"coef": full, "residual": residual}
+    return best
+
+
+def attribute(blocks: List[List[str]]) -> Dict[str, object]:
+    dumps = [block_counters(block) for block in blocks]
+    if not dumps:
+        return {"method": "none", "slices": 0}
+    total = dumps[-1]
+    slices: List[Dict[str, object]] = []
+    previous: Dict[str, object] = {"host_seconds": 0.0, "sim_ticks": 0.0, "systems": {name: {} for name in SYSTEMS}}
+    for dump in dumps:
+        slices.append(
+            {
+                "host_seconds": dump["host_seconds"] - previous["host_seconds"],
+                "sim_ticks": dump["sim_ticks"] - previous["sim_ticks"],
+                "systems": {
+                    name: {
+                        key: value - previous["systems"][name].get(key, 0.0)
+                        for key, value in dump["systems"][name].items()
+                    }
+                    for name in SYSTEMS
+                },
+            }
+        )
+        previous = dump
+
+    result: Dict[str, object] = {
+        "method": "none",
+        "slices": len(slices),
+        "host_seconds": total["host_seconds"],
+        "sim_ticks": total["sim_ticks"],
+        "systems": {name: dict(total["systems"][name]) for name in SYSTEMS},
+        "slice_table": slices,
+    }
+    if len(slices) < MIN_SLICES:
+        return result
+    rows = [[1.0] + [item["systems"][name]["insts"] for name in SYSTEMS] for item in slices]
+    ys = [float(item["host_seconds"]) for item in slices]
+    fit = nnls_fit(rows, ys)
+    if fit is None:
+        return result
+
+    overhead, *costs = fit["coef"]
+    mean = sum(ys) / len(ys)
+    spread = sum((y - mean) ** 2 for y in ys)
+    host_total = float(total["host_seconds"]) or 1.0
+    for name, cost in zip(SYSTEMS, costs):
+        system = result["systems"][name]
+        seconds = cost * system["insts"]
+        system.update(
+            host_seconds=seconds,
+            host_share=seconds / host_total,
+            host_ns_per_inst=cost * 1e9,
+            kips=round(system["insts"] / seconds / 1e3, 3) if seconds > 0 else None,
+        )
+    result.update(
+        method="nnls",
+        overhead_seconds=overhead * len(slices),
+        overhead_share=overhead * len(slices) / host_total,
+        r2=1.0 - fit["residual"] / spread if spread > 0 else None,
+    )
+    return result
+
+
+def analyze(stats_path: Path) -> Dict[str, object]:
+    """Attribution summary of a stats.txt, without the per-slice table."""
+    data = attribute(stats_blocks(stats_path))
+    data.pop("slice_table", None)
+    return data
+
+
+def main() -> int:
+    p = argparse.ArgumentParser(description="Per-system host-time attribution from periodic stats dumps")
+    p.add_argument("stats", help="stats.txt of a riscv_hybrid run with --host-attribution-period")
+    p.add_argument("--slices", action="store_true", help="include the per-slice table")
+    args = p.parse_args()
+    data = attribute(stats_blocks(Path(args.stats)))
+    if not args.slices:
+        data.pop("slice_table", None)
+    print(json.dumps(data, indent=2))
+    if data["method"] == "none":
+        print(f"[WARN] {data['slices']} stats dump(s); need {MIN_SLICES}+ for an attribution", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -161,6 +161,16 @@ elif [[ "${TARGET}" == "riscv_hybrid" ]]; then
     "hybrid-rv32-mixed-check"
     "hybrid-rv64-linux-boot-check"
   )
+elif [[ "${TARGET}" == "riscv64_smp" && "${MODE}" == "complex" ]]; then
+  WORKLOAD_DESC="Linux userspace SMP scaling suite (build/initramfs/bench_scaling.cpio)"
+  BENCH_STEPS=(
+    "spin-scaling"
+    "futex-scaling"
+    "pipe-latency"
+    "ctxsw-latency"
+    "forkexec-scaling"
+    "membw-scaling"
+  )
 elif [[ "${MODE}" == "simple" ]]; then
   WORKLOAD_DESC="smoke + memory micro-benchmark"
   BENCH_STEPS=(
@@ -221,5 +231,36 @@ EOF2
   done
 } > "${SUMMARY_MD}"
 
+if [[ -f "${RUN_MANIFEST}" ]]; then
+  python3 - "${RUN_MANIFEST}" >> "${SUMMARY_MD}" <<'PY'
+import json, sys
+run = json.load(open(sys.argv[1], encoding="utf-8"))
+boot = run.get("boot_timeline") or {}
+if boot.get("source", "none") != "none":
+    print()
+    print("## Boot timeline")
+    print()
+    print(f"- source: {boot['source']}")
+    print(f"- boot_time_sec: {boot.get('boot_time_sec')}")
+    print(f"- kernel_boot_sec: {boot.get('kernel_boot_sec')}")
+    if boot.get("chart"):
+        print(f"- waterfall: {boot['chart']}")
+curves = run.get("bench_scaling") or {}
+if curves:
+    print()
+    print("## Scaling")
+    print()
+    print("| curve | unit | threads: value (x vs fewest threads) |")
+    print("|---|---|---|")
+    for name, curve in curves.items():
+        points = ", ".join(
+            f"{p['threads']}: {p['value']:.1f} ({p['relative']:.2f}x)" if p.get("relative") is not None
+            else f"{p['threads']}: {p['value']:.1f}"
+            for p in curve["points"]
+        )
+        print(f"| {name} | {curve['unit']} | {points} |")
+PY
+fi
+
 echo "[OK] Benchmark scaffold manifest: ${MANIFEST_JSON}"
 echo "[OK] Benchmark scaffold summary: ${SUMMARY_MD}"
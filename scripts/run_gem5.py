@@ -1,11 +1,14 @@
 #!/usr/bin/env python3
-"""Run gem5 simulations for riscv64_smp, riscv32_mixed, riscv32_simple targets.
+"""Run gem5 simulations for riscv64_smp, riscv32_mixed, riscv32_simple, riscv_hybrid, traffic_mixed targets.
 
 - riscv64_smp: Full-system Linux boot flow (conf/riscv64_smp.py backend).
 - riscv32_mixed: one gem5 launch with 6-core mixed topology and three Zephyr
-  images (CPU0 AMP, CPU1 AMP, CPU2-5 SMP) in a single run.
+  images (CPU0 AMP, CPU1 AMP, CPU2-5 SMP) in a single run; --topology swaps in
+  an N-cluster x M-hart description from conf/topology/.
 - riscv32_simple: single-core bare-metal Zephyr run (CPU0 only).
 - riscv_hybrid: one gem5 launch containing both riscv32_mixed + riscv64.
+- traffic_mixed: the riscv32_mixed caches/crossbars/memory with one synthetic
+  traffic generator per hart instead of the Zephyr images.
 """
 
 from __future__ import annotations
@@ -20,7 +23,25 @@ import sys
 import time
 from datetime import datetime, timezone
 from pathlib import Path
-from typing import Dict, List, Tuple
+from typing import Dict, List, Optional, Tuple
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[1] / "conf"))
+
+from boot_timeline import analyze as boot_timeline
+from host_attribution import MIN_SLICES as MIN_ATTRIBUTION_SLICES
+from host_attribution import analyze as host_attribution, last_stats_block, stats_blocks
+from omx_gem5 import MEM_TYPES, PERIODIC_DUMPS, PREFETCHER_CLASSES, PREFETCHERS, XBAR_BUSES, XBAR_LATENCIES
+from stats_series import write_series as stats_series
+from terminal_ticks import is_sidecar, summarize as terminal_ticks
+
+
+# gem5 binaries by --gem5-variant; scripts/build_gem5.sh builds fast (LTO) and
+# pgo (LTO + profile from scripts/bench_gem5_variants.py slices).
+GEM5_VARIANTS = {
+    "opt": "sources/gem5/build/RISCV/gem5.opt",
+    "fast": "sources/gem5/build/RISCV/gem5.fast",
+    "pgo": "sources/gem5/build/RISCV_PGO/gem5.fast",
+}
 
 
 def utc_ts() -> str:
@@ -69,9 +90,12 @@ def auto_bootloader() -> str:
     )
 
 
-def auto_initramfs() -> str:
+def auto_initramfs(mode: str = "simple") -> str:
+    # riscv64_smp complex mode runs the SMP scaling suite when it is built.
+    preferred = ["build/initramfs/bench_scaling.cpio"] if mode == "complex" else []
     return find_first_existing(
         [
+            *preferred,
             "build/initramfs/rootfs-shell.cpio",
             "build/initramfs/rootfs.cpio",
             "sources/buildroot/output/images/rootfs.cpio",
@@ -80,6 +104,138 @@ def auto_initramfs() -> str:
     )
 
 
+BENCH_INITRAMFS_KIND = "omx-bench-initramfs"
+BENCH_RESULT_PREFIX = "OMX_BENCH "
+
+
+def bench_initramfs_info(initramfs: str) -> Optional[Dict[str, object]]:
+    """Sidecar of a scripts/build_bench_initramfs.py image, None for other initramfs."""
+    if not initramfs:
+        return None
+    sidecar = Path(initramfs).with_suffix(".json")
+    try:
+        info = json.loads(sidecar.read_text(encoding="utf-8"))
+    except (OSError, ValueError):
+        return None
+    return info if info.get("kind") == BENCH_INITRAMFS_KIND else None
+
+
+def bench_results(terminal_log: Path) -> Dict[str, object]:
+    """OMX_BENCH result lines of the benchmark initramfs, split into results and per-binary status."""
+    results: List[Dict[str, object]] = []
+    status: Dict[str, object] = {}
+    if terminal_log.exists():
+        for line in terminal_log.read_text(encoding="utf-8", errors="ignore").splitlines():
+            pos = line.find(BENCH_RESULT_PREFIX)
+            if pos < 0:
+                continue
+            try:
+                item = json.loads(line[pos + len(BENCH_RESULT_PREFIX):])
+            except ValueError:
+                continue
+            if item.get("case") == "status":
+                status[str(item.get("bench"))] = {"exit": item.get("exit"), "ms": item.get("value")}
+            else:
+                results.append(item)
+    return {"results": results, "status": status}
+
+
+HYBRID_SHM_INITRAMFS = "build/initramfs/bench_hybrid_shm.cpio"
+HYBRID_SHM_RESPONDER_MARKER = "RISCV32 MIXED HSHM AMP CPU1 status=ATTACHED"
+BLK_BENCH_INITRAMFS = "build/initramfs/bench_blkio.cpio"
+BLK_BENCH_IMAGE = "build/disk/blkbench.img"
+BLK_STAT_RE = re.compile(r"^system\.platform\.disk\.vio\.(?P<stat>\w+)$")
+BLK_COUNTERS = ("readReqs", "writeReqs", "readBytes", "writeBytes", "readTicks", "writeTicks")
+
+
+def blk_metrics(stats_path: Path) -> Dict[str, object]:
+    """OmxVirtIOBlock counters summed over every stats dump (init resets stats per benchmark).
+
+    Periodic dumps (--stats-period), whose ticks simulate_in_slices logs next
+    to stats.txt, are skipped: only the guest's dumps and the exit dump count.
+    """
+    periodic_log = stats_path.with_name(PERIODIC_DUMPS)
+    periodic = set(periodic_log.read_text(encoding="utf-8").split()) if periodic_log.exists() else set()
+    totals: Dict[str, float] = {}
+    for block in stats_blocks(stats_path):
+        values: Dict[str, float] = {}
+        tick = ""
+        for line in block:
+            columns = line.split()
+            if len(columns) < 2:
+                continue
+            if columns[0] == "finalTick":
+                tick = columns[1]
+                continue
+            match = BLK_STAT_RE.match(columns[0])
+            if not match or match.group("stat") not in BLK_COUNTERS:
+                continue
+            try:
+                values[match.group("stat")] = float(columns[1])
+            except ValueError:
+                continue
+        if tick in periodic:
+            continue
+        for stat, value in values.items():
+            totals[stat] = totals.get(stat, 0.0) + value
+    if not totals:
+        return {"device": "VirtIOBlock"}
+
+    def mean_ns(ticks: str, reqs: str) -> Optional[float]:
+        return round(totals.get(ticks, 0.0) / totals[reqs] / 1000.0, 3) if totals.get(reqs) else None
+
+    return {
+        "device": "OmxVirtIOBlock",
+        **{key: int(totals.get(key, 0)) for key in BLK_COUNTERS[:4]},
+        "avg_read_latency_ns": mean_ns("readTicks", "readReqs"),
+        "avg_write_latency_ns": mean_ns("writeTicks", "writeReqs"),
+    }
+
+
+def bench_scaling(results: List[Dict[str, object]]) -> Dict[str, Dict[str, object]]:
+    """Scaling curves of the bench results that carry a thread count.
+
+    One curve per bench/case and remaining parameters (e.g. size_kb), points
+    sorted by threads. `relative` is value / value at the smallest thread
+    count; for throughput units (".../s") `efficiency` divides that by the
+    thread ratio (1.0 = linear scaling).
+    """
+    curves: Dict[str, Dict[str, object]] = {}
+    for item in results:
+        if "threads" not in item:
+            continue
+        params = {
+            key: value
+            for key, value in item.items()
+            if key not in {"bench", "case", "value", "unit", "threads", "pairs"}
+        }
+        name = "/".join(
+            [str(item.get("bench")), str(item.get("case"))] + [f"{k}={v}" for k, v in sorted(params.items())]
+        )
+        curve = curves.setdefault(
+            name,
+            {
+                "bench": item.get("bench"),
+                "case": item.get("case"),
+                "params": params,
+                "unit": item.get("unit"),
+                "higher_is_better": str(item.get("unit", "")).endswith("/s"),
+                "points": [],
+            },
+        )
+        curve["points"].append({"threads": int(item["threads"]), "value": float(item["value"])})
+    for curve in curves.values():
+        points = sorted(curve["points"], key=lambda point: point["threads"])
+        base = points[0]
+        for point in points:
+            point["relative"] = point["value"] / base["value"] if base["value"] else None
+            if curve["higher_is_better"] and point["relative"] is not None:
+                point["efficiency"] = point["relative"] * base["threads"] / point["threads"]
+        curve["points"] = points
+        curve["max_threads"] = points[-1]["threads"]
+    return curves
+
+
 def default_riscv_config() -> str:
     return "sources/gem5/configs/deprecated/example/riscv/fs_linux.py"
 
@@ -91,56 +247,100 @@ def default_config_for_target(target: str) -> str:
         return "conf/riscv32_mixed.py"
     if target == "riscv_hybrid":
         return "conf/riscv_hybrid.py"
+    if target == "traffic_mixed":
+        return "conf/traffic_mixed.py"
     return default_riscv_config()
 
 
 def mixed_cpu_type(cpu_type: str) -> str:
+    """Map gem5 fs.py CPU class names onto the conf/ --cpu-type models."""
     lowered = cpu_type.lower()
     if "atomic" in lowered:
         return "atomic"
+    if "minor" in lowered:
+        return "minor"
+    if "o3" in lowered:
+        return "o3"
     return "timing"
 
 
-def read_elf_entry(path: str) -> int:
-    proc = subprocess.run(
-        ["readelf", "-h", path],
-        check=True,
-        capture_output=True,
-        text=True,
-    )
-    for line in proc.stdout.splitlines():
-        if "Entry point address:" not in line:
-            continue
-        value = line.split(":", maxsplit=1)[1].strip()
-        return int(value, 0)
-    raise RuntimeError(f"failed to parse ELF entry point: {path}")
+def hybrid_cpu_types(spec: str) -> Tuple[str, str]:
+    """--hybrid-cpu-types "rv32,rv64" -> conf/ CPU models for each side."""
+    parts = [part.strip() for part in spec.split(",")]
+    if len(parts) != 2 or not all(parts):
+        raise SystemExit(f"[ERROR] --hybrid-cpu-types expects rv32,rv64 (e.g. timing,atomic): {spec}")
+    return mixed_cpu_type(parts[0]), mixed_cpu_type(parts[1])
 
 
-def maybe_build_mixed_boot(args: argparse.Namespace) -> None:
-    amp0 = Path(args.amp_cpu0_elf)
-    amp1 = Path(args.amp_cpu1_elf)
-    smp = Path(args.smp_elf)
-    if not (amp0.exists() and amp1.exists() and smp.exists()):
-        return
+def generate_topology(args: argparse.Namespace) -> Dict[str, object]:
+    """Run scripts/gen_topology.py for --topology and load its memory map."""
+    out_dir = Path("build/topology") / Path(args.topology).stem
+    cmd = [
+        sys.executable,
+        str(Path(__file__).resolve().with_name("gen_topology.py")),
+        "--topology",
+        args.topology,
+        "--out-dir",
+        str(out_dir),
+        "--image-dir",
+        args.image_dir,
+    ]
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
+    topology = json.loads((out_dir / "memory_map.json").read_text(encoding="utf-8"))
+    topology["out_dir"] = str(out_dir)
+    return topology
 
-    entry0 = read_elf_entry(str(amp0))
-    entry1 = read_elf_entry(str(amp1))
-    entry_smp = read_elf_entry(str(smp))
 
+def maybe_build_mixed_boot(args: argparse.Namespace, topology: Optional[Dict[str, object]] = None) -> None:
     boot_elf = Path(args.mixed_boot_elf)
     boot_script = Path(__file__).resolve().with_name("build_riscv32_mixed_boot.sh")
+    if topology:
+        # gen_topology already read each image's entry PC into the table.
+        if not all(Path(str(image["elf"])).exists() for image in topology["images"]):
+            return
+        boot_elf.parent.mkdir(parents=True, exist_ok=True)
+        cmd = [
+            str(boot_script),
+            "--output",
+            str(boot_elf),
+            "--boot-table",
+            str(Path(str(topology["out_dir"])) / "riscv32_mixed_boot_table.h"),
+        ]
+        print(f"[INFO] Building mixed boot trampoline: {quoted(cmd)}")
+        subprocess.run(cmd, check=True)
+        return
+
+    elfs = [args.amp_cpu0_elf, args.amp_cpu1_elf, args.smp_elf]
+    if not all(Path(elf).exists() for elf in elfs):
+        return
+
+    # The platform plan reads each image's entry PC into its boot table rows.
     boot_elf.parent.mkdir(parents=True, exist_ok=True)
+    plan_json = boot_elf.parent / "riscv32_mixed_plan.json"
+    plan = subprocess.run(
+        [
+            sys.executable,
+            default_config_for_target("riscv32_mixed"),
+            "--print-json",
+            "--amp-cpu0-elf",
+            elfs[0],
+            "--amp-cpu1-elf",
+            elfs[1],
+            "--smp-elf",
+            elfs[2],
+        ],
+        check=True,
+        capture_output=True,
+        text=True,
+    )
+    plan_json.write_text(plan.stdout, encoding="utf-8")
 
     cmd = [
         str(boot_script),
         "--output",
         str(boot_elf),
-        "--amp-cpu0-entry",
-        hex(entry0),
-        "--amp-cpu1-entry",
-        hex(entry1),
-        "--cluster1-smp-entry",
-        hex(entry_smp),
+        "--plan-json",
+        str(plan_json),
     ]
     print(f"[INFO] Building mixed boot trampoline: {quoted(cmd)}")
     subprocess.run(cmd, check=True)
@@ -148,16 +348,22 @@ def maybe_build_mixed_boot(args: argparse.Namespace) -> None:
 
 def parser() -> argparse.ArgumentParser:
     p = argparse.ArgumentParser(
-        description="Run gem5 for riscv64_smp/riscv32_mixed/riscv32_simple/riscv_hybrid",
+        description="Run gem5 for riscv64_smp/riscv32_mixed/riscv32_simple/riscv_hybrid/traffic_mixed",
         formatter_class=argparse.ArgumentDefaultsHelpFormatter,
     )
     p.add_argument(
         "--target",
-        choices=["riscv64_smp", "riscv32_mixed", "riscv32_simple", "riscv_hybrid"],
+        choices=["riscv64_smp", "riscv32_mixed", "riscv32_simple", "riscv_hybrid", "traffic_mixed"],
         required=True,
     )
     p.add_argument("--mode", choices=["simple", "complex"], default="simple")
-    p.add_argument("--gem5-bin", default="sources/gem5/build/RISCV/gem5.opt")
+    p.add_argument(
+        "--gem5-variant",
+        choices=sorted(GEM5_VARIANTS),
+        default="opt",
+        help="gem5 binary build: opt, fast (LTO) or pgo (LTO + PGO), see scripts/build_gem5.sh",
+    )
+    p.add_argument("--gem5-bin", default="", help="explicit gem5 binary (overrides --gem5-variant)")
     p.add_argument("--config", default="")
 
     # RV64 Linux inputs
@@ -166,6 +372,20 @@ def parser() -> argparse.ArgumentParser:
     p.add_argument("--initramfs", default="")
     p.add_argument("--disk-image", default="")
     p.add_argument("--allow-no-disk", action="store_true")
+    p.add_argument(
+        "--blk-bench",
+        action="store_true",
+        help="riscv64_smp: virtio-block I/O benchmark (bench_blkio initramfs + stamped raw disk, "
+        "see scripts/build_blk_image.py)",
+    )
+    p.add_argument(
+        "--hybrid-shm",
+        action="store_true",
+        help="riscv_hybrid: Linux<->Zephyr shared window + bench_hybrid_shm initramfs (round-trip benchmark; "
+        "the AMP CPU1 image needs CONFIG_RISCV32_MIXED_HYBRID_SHM=y)",
+    )
+    p.add_argument("--blk-latency", default="", help="riscv64_smp: virtio-block access latency, e.g. 80us")
+    p.add_argument("--blk-bandwidth", default="", help="riscv64_smp: virtio-block backend bandwidth, e.g. 500MB/s")
     p.add_argument(
         "--command-line",
         default=(
@@ -173,19 +393,164 @@ def parser() -> argparse.ArgumentParser:
             "rdinit=/init loglevel=8 ignore_loglevel"
         ),
     )
+    p.add_argument(
+        "--boot-timing",
+        action="store_true",
+        help="riscv64_smp: tick-stamped console trace (gem5 Terminal debug flag, needs gem5.opt, "
+        "or --tick-terminal) + initcall_debug for the boot_timeline phase breakdown",
+    )
+    p.add_argument(
+        "--tick-terminal",
+        choices=["off", "text", "binary", "both"],
+        default="off",
+        help="conf targets: OmxTickTerminal console capture with per-line ticks "
+        "(<terminal>.ticks / .ticks.bin; gem5 built with gem5_ext)",
+    )
     p.add_argument("--sys-clock", default="1GHz")
     p.add_argument("--cpu-clock", default="3GHz")
     p.add_argument("--num-cpus", type=int, default=1)
+    p.add_argument(
+        "--cache-hierarchy",
+        choices=["", "shared-l2", "private-l2-llc", "none"],
+        default="",
+        help="riscv64_smp conf runtime cache hierarchy (empty: config default)",
+    )
+    p.add_argument("--ptw-cache", action="store_true", help="riscv64_smp: add page-walker caches")
+    p.add_argument(
+        "--mem-type",
+        choices=["", *MEM_TYPES],
+        default="",
+        help="memory technology for every target (empty: config default)",
+    )
+    p.add_argument("--mem-channels", type=int, default=0, help="interleaved memory channels (0: config default)")
+    p.add_argument("--mem-intlv-size", type=int, default=0, help="channel interleave bytes (0: config default)")
+    p.add_argument(
+        "--dvfs",
+        action="store_true",
+        help="riscv32_mixed: per-cluster DVFS via the OmxDvfsCtrl MMIO block (gem5 built with gem5_ext)",
+    )
+    p.add_argument(
+        "--l1d-prefetcher",
+        default="",
+        help=f"L1D prefetcher: {'|'.join(PREFETCHERS)}, or one per cluster (riscv32_mixed/riscv_hybrid rv32)",
+    )
+    p.add_argument(
+        "--l2-prefetcher",
+        default="",
+        help=f"L2 prefetcher: {'|'.join(PREFETCHERS)}, or one per cluster (riscv32_mixed/riscv_hybrid rv32)",
+    )
+    p.add_argument(
+        "--memory-system",
+        choices=["classic", "ruby-mesi", "ruby-chi"],
+        default="classic",
+        help="riscv32_mixed memory system (ruby-* needs a gem5 binary built with that protocol)",
+    )
+    p.add_argument(
+        "--shared-llc",
+        action="store_true",
+        help="riscv32_mixed: add a snoop-filtered LLC shared by both cluster L2s",
+    )
+    p.add_argument(
+        "--shared-mem",
+        choices=["", "dram", "sram"],
+        default="",
+        help="rv32 shared IPC segment backing: DRAM or an SRAM scratchpad (empty: config default)",
+    )
+    p.add_argument(
+        "--shared-cacheable",
+        choices=["", "on", "off"],
+        default="",
+        help="rv32 shared IPC segment cacheability via PMAChecker (empty: config default)",
+    )
+    p.add_argument("--sram-latency", default="", help="scratchpad latency per bank, e.g. 2ns")
+    p.add_argument("--sram-bandwidth", default="", help="scratchpad bandwidth per bank, e.g. 32GiB/s")
+    p.add_argument("--sram-banks", type=int, default=0, help="scratchpad banks (0: config default)")
+    for bus, coherent in XBAR_BUSES.items():
+        p.add_argument(f"--{bus}-width", type=int, default=None, help=f"{bus} width in bytes (conf targets)")
+        for latency in XBAR_LATENCIES:
+            if latency == "snoop-response" and not coherent:
+                continue
+            p.add_argument(f"--{bus}-{latency}-latency", type=int, default=None, help="cycles (conf targets)")
+    p.add_argument(
+        "--comm-monitor",
+        action="store_true",
+        help="riscv32_mixed/riscv_hybrid: CommMonitor between each cluster L2 and the next level",
+    )
+    p.add_argument(
+        "--mem-trace",
+        choices=["off", "packet", "elastic"],
+        default="off",
+        help="riscv32_mixed: record L1->L2 packet traces per cluster or elastic traces per O3 hart "
+        "for conf/mem_replay.py (scripts/sweep_mem_replay.py)",
+    )
+
+    # traffic_mixed generators (conf/traffic_mixed.py); each takes one value or one per cluster
+    p.add_argument("--traffic-patterns", default="linear", help="linear|random|dram|idle")
+    p.add_argument("--traffic-read-pct", default="100", help="read share in percent")
+    p.add_argument("--traffic-period-ticks", default="1000", help="ticks between requests of one generator")
+    p.add_argument("--traffic-targets", default="own", help="own (hart image segment) or shared (IPC segment)")
+    p.add_argument("--traffic-duration-ticks", type=int, default=100_000_000)
 
     # RV32 Zephyr inputs
     p.add_argument("--amp-cpu0-elf", default="build/zephyr/cluster0_amp_cpu0/zephyr/zephyr.elf")
     p.add_argument("--amp-cpu1-elf", default="build/zephyr/cluster0_amp_cpu1/zephyr/zephyr.elf")
     p.add_argument("--smp-elf", default="build/zephyr/cluster1_smp/zephyr/zephyr.elf")
     p.add_argument("--mixed-boot-elf", default="build/boot/riscv32_mixed_boot.elf")
+    p.add_argument(
+        "--topology",
+        default="",
+        help="riscv32_mixed cluster/hart description (conf/topology/*.json); replaces the three ELF options",
+    )
+    p.add_argument(
+        "--image-dir",
+        default="build/zephyr",
+        help="with --topology: Zephyr build root holding <image>/zephyr/zephyr.elf",
+    )
     p.add_argument("--simple-elf", default="build/zephyr/riscv32_simple/zephyr/zephyr.elf")
 
     # Runtime knobs
     p.add_argument("--cpu-type", default="TimingSimpleCPU")
+    p.add_argument(
+        "--cluster-cpu-types",
+        default="",
+        help="riscv32_mixed per-cluster CPU models, e.g. minor,o3 (overrides --cpu-type)",
+    )
+    p.add_argument(
+        "--hybrid-cpu-types",
+        default="",
+        help="riscv_hybrid rv32,rv64 CPU models, e.g. timing,atomic (overrides --cpu-type)",
+    )
+    p.add_argument(
+        "--host-attribution-period",
+        type=int,
+        default=0,
+        help="riscv_hybrid: cumulative stats dump every N ticks for per-system host-time attribution "
+        "(scripts/host_attribution.py; 0 = off)",
+    )
+    p.add_argument(
+        "--stats-period",
+        type=int,
+        default=0,
+        help="conf targets: cumulative stats dump every N ticks for the stats_series.json time series "
+        "and phase detection (scripts/stats_series.py; 0 = off)",
+    )
+    p.add_argument(
+        "--stats-profile",
+        choices=["full", "minimal", "series"],
+        default="full",
+        help="conf targets: stats kept at each dump (minimal: dashboard summary and checks; "
+        "series: minimal + stats_series.py inputs)",
+    )
+    p.add_argument("--stats-include", default="", help="conf targets: comma-separated stat globs to keep as well")
+    p.add_argument("--stats-exclude", default="", help="conf targets: comma-separated stat globs to drop")
+    p.add_argument(
+        "--stats-format",
+        choices=["text", "json"],
+        default="text",
+        help="conf targets: json writes one compact line per dump to stats.jsonl instead of stats.txt",
+    )
+    p.add_argument("--o3-width", type=int, default=0, help="O3 pipeline width (0: config default)")
+    p.add_argument("--o3-rob-entries", type=int, default=0, help="O3 ROB entries (0: config default)")
     # rv64 simple mode needs a larger tick budget to expose UART boot banners
     # (OpenSBI/Linux early boot) in terminal logs.
     p.add_argument("--max-ticks-simple", type=int, default=1_200_000_000_000)
@@ -252,11 +617,124 @@ def max_ticks_for_mode(args: argparse.Namespace) -> int:
     return args.max_ticks_simple if args.mode == "simple" else args.max_ticks_complex
 
 
+def memory_args(args: argparse.Namespace, prefix: str = "") -> List[str]:
+    out: List[str] = []
+    if args.mem_type:
+        out.extend([f"--{prefix}mem-type", args.mem_type])
+    if args.mem_channels:
+        out.extend([f"--{prefix}mem-channels", str(args.mem_channels)])
+    if args.mem_intlv_size:
+        out.extend([f"--{prefix}mem-intlv-size", str(args.mem_intlv_size)])
+    return out
+
+
+def fs_memory_args(args: argparse.Namespace) -> List[str]:
+    out: List[str] = []
+    if args.mem_type:
+        out.extend(["--mem-type", MEM_TYPES[args.mem_type]])
+    if args.mem_channels:
+        out.extend(["--mem-channels", str(args.mem_channels)])
+    if args.mem_intlv_size:
+        out.extend(["--mem-channels-intlv", str(args.mem_intlv_size)])
+    return out
+
+
+def xbar_args(args: argparse.Namespace, prefix: str = "") -> List[str]:
+    out: List[str] = []
+    for bus in XBAR_BUSES:
+        for suffix in ("width", *(f"{latency}-latency" for latency in XBAR_LATENCIES)):
+            value = getattr(args, f"{bus}_{suffix}".replace("-", "_"), None)
+            if value is not None:
+                out.extend([f"--{prefix}{bus}-{suffix}", str(value)])
+    return out
+
+
+def shared_region_args(args: argparse.Namespace) -> List[str]:
+    out: List[str] = []
+    if args.shared_mem:
+        out.extend(["--shared-mem", args.shared_mem])
+    if args.shared_cacheable:
+        out.extend(["--shared-cacheable", args.shared_cacheable])
+    if args.sram_latency:
+        out.extend(["--sram-latency", args.sram_latency])
+    if args.sram_bandwidth:
+        out.extend(["--sram-bandwidth", args.sram_bandwidth])
+    if args.sram_banks:
+        out.extend(["--sram-banks", str(args.sram_banks)])
+    return out
+
+
+def o3_args(args: argparse.Namespace) -> List[str]:
+    out: List[str] = []
+    if args.o3_width:
+        out.extend(["--o3-width", str(args.o3_width)])
+    if args.o3_rob_entries:
+        out.extend(["--o3-rob-entries", str(args.o3_rob_entries)])
+    return out
+
+
+def prefetcher_args(args: argparse.Namespace, prefix: str = "") -> List[str]:
+    out: List[str] = []
+    if args.l1d_prefetcher:
+        out.extend([f"--{prefix}l1d-prefetcher", args.l1d_prefetcher])
+    if args.l2_prefetcher:
+        out.extend([f"--{prefix}l2-prefetcher", args.l2_prefetcher])
+    return out
+
+
+def fs_prefetcher_args(args: argparse.Namespace) -> List[str]:
+    # gem5 fs.py takes one SimObject class name per level.
+    out: List[str] = []
+    for flag, value in (("--l1d-hwp-type", args.l1d_prefetcher), ("--l2-hwp-type", args.l2_prefetcher)):
+        if not value or value == "none":
+            continue
+        if value not in PREFETCHER_CLASSES:
+            raise ValueError(f"fs.py path takes a single prefetcher name, got {value!r}")
+        out.extend([flag, PREFETCHER_CLASSES[value]])
+    return out
+
+
+BOOT_TIMING_CMDLINE = ("initcall_debug", "printk.time=1")
+
+
+def rv64_command_line(args: argparse.Namespace) -> str:
+    """Kernel command line; --boot-timing adds initcall_debug and printk timestamps."""
+    words = args.command_line.split()
+    if args.boot_timing:
+        words += [word for word in BOOT_TIMING_CMDLINE if word not in words]
+    return " ".join(words)
+
+
+def boot_timing_gem5_args(args: argparse.Namespace) -> List[str]:
+    """gem5 options (before the config) that trace every console line with its tick."""
+    # The OmxTickTerminal sidecar already carries the ticks, on any gem5 build.
+    if not args.boot_timing or args.tick_terminal != "off":
+        return []
+    return ["--debug-flags=Terminal", "--debug-file=terminal_ticks.log"]
+
+
+def tick_terminal_args(args: argparse.Namespace) -> List[str]:
+    return ["--tick-terminal", args.tick_terminal] if args.tick_terminal != "off" else []
+
+
+def stats_args(args: argparse.Namespace) -> List[str]:
+    cmd = ["--stats-period", str(args.stats_period)] if args.stats_period else []
+    if args.stats_profile != "full":
+        cmd.extend(["--stats-profile", args.stats_profile])
+    if args.stats_include:
+        cmd.extend(["--stats-include", args.stats_include])
+    if args.stats_exclude:
+        cmd.extend(["--stats-exclude", args.stats_exclude])
+    if args.stats_format != "text":
+        cmd.extend(["--stats-format", args.stats_format])
+    return cmd
+
+
 def rv64_command(
     args: argparse.Namespace, config_path: Path, logs_dir: Path
 ) -> Tuple[List[str], str, str, str, str, bool]:
     bootloader = args.bootloader or auto_bootloader()
-    initramfs = args.initramfs or auto_initramfs()
+    initramfs = args.initramfs or auto_initramfs(args.mode)
     kernel_elf = auto_kernel_elf(args.kernel) or args.kernel
     use_conf_runtime = config_path.name == "riscv64_smp.py"
     disk_image = args.disk_image
@@ -273,6 +751,7 @@ def rv64_command(
         cmd = [
             args.gem5_bin,
             f"--outdir={logs_dir}",
+            *boot_timing_gem5_args(args),
             str(config_path),
             "--num-cpus",
             str(num_cpus),
@@ -287,10 +766,24 @@ def rv64_command(
             "--kernel-elf",
             kernel_elf,
             "--cmdline",
-            args.command_line,
+            rv64_command_line(args),
             "--max-ticks",
             str(max_ticks_for_mode(args)),
         ]
+        if args.cache_hierarchy:
+            cmd.extend(["--cache-hierarchy", args.cache_hierarchy])
+        if args.ptw_cache:
+            cmd.append("--ptw-cache")
+        cmd.extend(prefetcher_args(args))
+        cmd.extend(o3_args(args))
+        cmd.extend(memory_args(args))
+        cmd.extend(xbar_args(args))
+        cmd.extend(tick_terminal_args(args))
+        cmd.extend(stats_args(args))
+        if args.blk_latency:
+            cmd.extend(["--blk-latency", args.blk_latency])
+        if args.blk_bandwidth:
+            cmd.extend(["--blk-bandwidth", args.blk_bandwidth])
         if bootloader:
             cmd.extend(["--bootloader", bootloader])
         if initramfs:
@@ -302,6 +795,7 @@ def rv64_command(
     cmd = [
         args.gem5_bin,
         f"--outdir={logs_dir}",
+        *boot_timing_gem5_args(args),
         str(config_path),
         "--num-cpus",
         "4",
@@ -320,10 +814,12 @@ def rv64_command(
         "--kernel",
         kernel_elf,
         "--command-line",
-        args.command_line,
+        rv64_command_line(args),
         "--abs-max-tick",
         str(max_ticks_for_mode(args)),
     ]
+    cmd.extend(fs_prefetcher_args(args))
+    cmd.extend(fs_memory_args(args))
     if bootloader:
         cmd.extend(["--bootloader", bootloader])
     if disk_image:
@@ -332,7 +828,10 @@ def rv64_command(
 
 
 def rv32_mixed_command(
-    args: argparse.Namespace, config_path: Path, logs_dir: Path
+    args: argparse.Namespace,
+    config_path: Path,
+    logs_dir: Path,
+    topology: Optional[Dict[str, object]] = None,
 ) -> Tuple[List[str], List[Dict[str, object]], List[str], List[str]]:
     # Keep a longer default runtime for mixed bring-up.
     abs_max_tick = args.max_ticks_complex if args.mode == "simple" else max_ticks_for_mode(args)
@@ -341,44 +840,83 @@ def rv32_mixed_command(
         f"--outdir={logs_dir}",
         str(config_path),
         "--num-cpus",
-        "6",
+        str(topology["num_harts"]) if topology else "6",
         "--cpu-type",
         mixed_cpu_type(args.cpu_type),
         "--max-ticks",
         str(abs_max_tick),
         "--boot-elf",
         args.mixed_boot_elf,
-        "--amp-cpu0-elf",
-        args.amp_cpu0_elf,
-        "--amp-cpu1-elf",
-        args.amp_cpu1_elf,
-        "--smp-elf",
-        args.smp_elf,
-    ]
-
-    assignments = [
-        {
-            "name": "amp_cpu0",
-            "cpu_ids": [0],
-            "elf": args.amp_cpu0_elf,
-            "marker_role": "AMP CPU0",
-            "dt_role": "cluster0-amp-cpu0",
-        },
-        {
-            "name": "amp_cpu1",
-            "cpu_ids": [1],
-            "elf": args.amp_cpu1_elf,
-            "marker_role": "AMP CPU1",
-            "dt_role": "cluster0-amp-cpu1",
-        },
-        {
-            "name": "cluster1_smp",
-            "cpu_ids": [2, 3, 4, 5],
-            "elf": args.smp_elf,
-            "marker_role": "CLUSTER1 SMP",
-            "dt_role": "cluster1-smp",
-        },
     ]
+    if topology:
+        cmd.extend(["--topology", args.topology, "--image-dir", args.image_dir])
+    else:
+        cmd.extend(
+            [
+                "--amp-cpu0-elf",
+                args.amp_cpu0_elf,
+                "--amp-cpu1-elf",
+                args.amp_cpu1_elf,
+                "--smp-elf",
+                args.smp_elf,
+            ]
+        )
+    cmd.extend(["--memory-system", args.memory_system])
+    if args.shared_llc:
+        cmd.append("--shared-llc")
+    if args.cluster_cpu_types:
+        cmd.extend(["--cluster-cpu-types", args.cluster_cpu_types])
+    if args.dvfs:
+        cmd.append("--dvfs")
+    cmd.extend(prefetcher_args(args))
+    cmd.extend(o3_args(args))
+    cmd.extend(memory_args(args))
+    cmd.extend(shared_region_args(args))
+    cmd.extend(xbar_args(args))
+    if args.comm_monitor:
+        cmd.append("--comm-monitor")
+    if args.mem_trace != "off":
+        cmd.extend(["--mem-trace", args.mem_trace])
+    cmd.extend(tick_terminal_args(args))
+    cmd.extend(stats_args(args))
+
+    if topology:
+        assignments = [
+            {
+                "name": image["name"],
+                "cpu_ids": list(image["harts"]),
+                "elf": image["elf"],
+                "marker_role": image["marker_role"],
+                "dt_role": image["role"],
+            }
+            for image in topology["images"]
+        ]
+        ready_mask = int(topology["sync"]["ready_mask"])
+    else:
+        assignments = [
+            {
+                "name": "amp_cpu0",
+                "cpu_ids": [0],
+                "elf": args.amp_cpu0_elf,
+                "marker_role": "AMP CPU0",
+                "dt_role": "cluster0-amp-cpu0",
+            },
+            {
+                "name": "amp_cpu1",
+                "cpu_ids": [1],
+                "elf": args.amp_cpu1_elf,
+                "marker_role": "AMP CPU1",
+                "dt_role": "cluster0-amp-cpu1",
+            },
+            {
+                "name": "cluster1_smp",
+                "cpu_ids": [2, 3, 4, 5],
+                "elf": args.smp_elf,
+                "marker_role": "CLUSTER1 SMP",
+                "dt_role": "cluster1-smp",
+            },
+        ]
+        ready_mask = 0x7
     role_markers: List[str] = []
     done_markers: List[str] = []
     for item in assignments:
@@ -393,11 +931,41 @@ def rv32_mixed_command(
         )
         done_markers.append(f"RISCV32 MIXED {marker_role} WORKLOAD DONE")
 
-    required_markers = done_markers + ["RISCV32 MIXED ROLE_SYNC mask=0x7 status=READY"]
+    required_markers = done_markers + [f"RISCV32 MIXED ROLE_SYNC mask=0x{ready_mask:x} status=READY"]
 
     return cmd, assignments, required_markers, role_markers
 
 
+def traffic_mixed_command(args: argparse.Namespace, config_path: Path, logs_dir: Path) -> List[str]:
+    cmd = [
+        args.gem5_bin,
+        f"--outdir={logs_dir}",
+        str(config_path),
+        "--patterns",
+        args.traffic_patterns,
+        "--read-pct",
+        args.traffic_read_pct,
+        "--period-ticks",
+        args.traffic_period_ticks,
+        "--targets",
+        args.traffic_targets,
+        "--duration-ticks",
+        str(args.traffic_duration_ticks),
+    ]
+    if args.topology:
+        cmd.extend(["--topology", args.topology])
+    if args.shared_llc:
+        cmd.append("--shared-llc")
+    cmd.extend(prefetcher_args(args))
+    cmd.extend(memory_args(args))
+    cmd.extend(shared_region_args(args))
+    cmd.extend(xbar_args(args))
+    if args.comm_monitor:
+        cmd.append("--comm-monitor")
+    cmd.extend(stats_args(args))
+    return cmd
+
+
 def rv_hybrid_command(
     args: argparse.Namespace, config_path: Path, logs_dir: Path
 ) -> Tuple[List[str], str, str, str, str]:
@@ -413,6 +981,11 @@ def rv_hybrid_command(
 
     rv32_cpu_type = mixed_cpu_type(args.cpu_type)
     rv64_cpu_type = "atomic" if args.cpu_type.lower() == "timingsimplecpu" else mixed_cpu_type(args.cpu_type)
+    if args.hybrid_shm:
+        # The shared window needs both systems in timing mode (conf/riscv_hybrid.py _hybrid_shm_plan).
+        rv64_cpu_type = rv32_cpu_type
+    if args.hybrid_cpu_types:
+        rv32_cpu_type, rv64_cpu_type = hybrid_cpu_types(args.hybrid_cpu_types)
     abs_max_tick = max_ticks_for_mode(args)
 
     cmd = [
@@ -446,6 +1019,21 @@ def rv_hybrid_command(
         "--cmdline",
         args.command_line,
     ]
+    cmd.extend(prefetcher_args(args, prefix="rv32-"))
+    cmd.extend(o3_args(args))
+    cmd.extend(memory_args(args, prefix="rv32-"))
+    cmd.extend(memory_args(args, prefix="rv64-"))
+    cmd.extend(shared_region_args(args))
+    cmd.extend(xbar_args(args, prefix="rv32-"))
+    cmd.extend(xbar_args(args, prefix="rv64-"))
+    if args.comm_monitor:
+        cmd.append("--rv32-comm-monitor")
+    cmd.extend(tick_terminal_args(args))
+    if args.hybrid_shm:
+        cmd.append("--hybrid-shm")
+    if args.host_attribution_period:
+        cmd.extend(["--host-attribution-period", str(args.host_attribution_period)])
+    cmd.extend(stats_args(args))
     if bootloader:
         cmd.extend(["--bootloader", bootloader])
     if initramfs:
@@ -487,6 +1075,7 @@ def rv32_simple_command(
         "--kernel",
         args.simple_elf,
     ]
+    cmd.extend(fs_memory_args(args))
     return cmd, args.simple_elf
 
 
@@ -570,6 +1159,25 @@ def evaluate_stage(
     }
 
 
+def host_attribution_stage(attribution: Dict[str, object]) -> Dict[str, object]:
+    """stage_report entry for --host-attribution-period: per-system host share, insts and KIPS."""
+    passed = attribution.get("method") != "none"
+    systems = attribution.get("systems", {})
+    return {
+        "name": "host_attribution",
+        "passed": passed,
+        "required": [],
+        "missing": [] if passed else [f"{MIN_ATTRIBUTION_SLICES}+ stats dumps"],
+        "forbidden": [],
+        "forbidden_hits": [],
+        "systems": {
+            name: {key: item.get(key) for key in ("host_share", "host_seconds", "insts", "kips")}
+            for name, item in systems.items()
+        },
+        "overhead_share": attribution.get("overhead_share"),
+    }
+
+
 def read_markers_from_paths(
     paths: List[Path], markers: List[str], allow_interleaved: bool = False
 ) -> Dict[str, bool]:
@@ -584,7 +1192,7 @@ def read_markers_from_paths(
 def read_stats_counter(stats_path: Path, key: str) -> int:
     if not stats_path.exists():
         return -1
-    for line in stats_path.read_text(encoding="utf-8", errors="ignore").splitlines():
+    for line in last_stats_block(stats_path):
         columns = line.split()
         if len(columns) >= 2 and columns[0] == key:
             try:
@@ -594,6 +1202,397 @@ def read_stats_counter(stats_path: Path, key: str) -> int:
     return -1
 
 
+def read_stats_map(stats_path: Path, keys: List[str]) -> Dict[str, float]:
+    """Last-dump values for `keys`; missing keys are omitted."""
+    values: Dict[str, float] = {}
+    if not stats_path.exists():
+        return values
+    wanted = set(keys)
+    for line in last_stats_block(stats_path):
+        columns = line.split()
+        if len(columns) < 2 or columns[0] not in wanted or columns[0] in values:
+            continue
+        try:
+            values[columns[0]] = float(columns[1])
+        except ValueError:
+            continue
+    return values
+
+
+PREFETCH_STAT_RE = re.compile(r"^(?P<owner>\S+)\.prefetcher\.(?P<stat>pfIssued|pfUseful|accuracy|coverage)$")
+DEMAND_MSHR_MISS_RE = re.compile(r"^(?P<owner>\S+)\.demandMshrMisses::total$")
+
+
+def prefetch_metrics(stats_path: Path) -> Dict[str, object]:
+    """Per-prefetcher accuracy/coverage plus totals over every prefetching cache.
+
+    accuracy = pfUseful / pfIssued, coverage = pfUseful / (pfUseful +
+    demand MSHR misses), as computed by gem5's base prefetcher stats. The
+    totals apply the same formulas to the counts summed over the caches.
+    """
+    per_cache: Dict[str, Dict[str, float]] = {}
+    demand_misses: Dict[str, float] = {}
+    if stats_path.exists():
+        for line in last_stats_block(stats_path):
+            columns = line.split()
+            if len(columns) < 2:
+                continue
+            match = PREFETCH_STAT_RE.match(columns[0])
+            miss = DEMAND_MSHR_MISS_RE.match(columns[0])
+            if not match and not miss:
+                continue
+            try:
+                value = float(columns[1])
+            except ValueError:
+                continue
+            if miss:
+                demand_misses[miss.group("owner")] = value
+            else:
+                per_cache.setdefault(match.group("owner"), {})[match.group("stat")] = value
+    for owner, item in per_cache.items():
+        if owner in demand_misses:
+            item["demandMshrMisses"] = demand_misses[owner]
+
+    issued = sum(item.get("pfIssued", 0.0) for item in per_cache.values())
+    useful = sum(item.get("pfUseful", 0.0) for item in per_cache.values())
+    misses = sum(item.get("demandMshrMisses", 0.0) for item in per_cache.values())
+    return {
+        "per_cache": per_cache,
+        "pf_issued": issued,
+        "pf_useful": useful,
+        "accuracy": (useful / issued) if issued else None,
+        "coverage": (useful / (useful + misses)) if useful + misses else None,
+    }
+
+
+MEMORY_STAT_RE = re.compile(
+    r"^(?P<ctrl>\S*(?:mem_ctrls?|scratchpad)\d*)\.(?:dram\.)?"
+    r"(?P<stat>avgRdBW|avgWrBW|peakBW|busUtil|avgQLat|avgMemAccLat|pageHitRate|"
+    r"avgRdQLen|avgWrQLen|bwTotal::total)$"
+)
+
+
+def memory_metrics(stats_path: Path) -> Dict[str, object]:
+    """Per-controller bandwidth/queueing stats and system-wide totals.
+
+    DRAM controllers report avgRdBW/avgWrBW (bytes/s), busUtil (%), queue
+    lengths and latencies; SimpleMemory only reports bwTotal.
+    """
+    per_ctrl: Dict[str, Dict[str, float]] = {}
+    if stats_path.exists():
+        for line in last_stats_block(stats_path):
+            columns = line.split()
+            if len(columns) < 2:
+                continue
+            match = MEMORY_STAT_RE.match(columns[0])
+            if not match:
+                continue
+            try:
+                value = float(columns[1])
+            except ValueError:
+                continue
+            per_ctrl.setdefault(match.group("ctrl"), {})[match.group("stat")] = value
+
+    total_bw = 0.0
+    for item in per_ctrl.values():
+        if "avgRdBW" in item or "avgWrBW" in item:
+            total_bw += item.get("avgRdBW", 0.0) + item.get("avgWrBW", 0.0)
+        else:
+            total_bw += item.get("bwTotal::total", 0.0)
+    utils = [item["busUtil"] for item in per_ctrl.values() if "busUtil" in item]
+    rd_queues = [item["avgRdQLen"] for item in per_ctrl.values() if "avgRdQLen" in item]
+    wr_queues = [item["avgWrQLen"] for item in per_ctrl.values() if "avgWrQLen" in item]
+    return {
+        "per_ctrl": per_ctrl,
+        "channels": len(per_ctrl),
+        "total_bw_bytes_per_sec": total_bw,
+        "max_bus_util_pct": max(utils) if utils else None,
+        "avg_rd_queue_len": (sum(rd_queues) / len(rd_queues)) if rd_queues else None,
+        "avg_wr_queue_len": (sum(wr_queues) / len(wr_queues)) if wr_queues else None,
+    }
+
+
+XBAR_STAT_RE = re.compile(
+    r"^(?P<xbar>\S*(?:membus|iobus|l2bus|llc_bus|cluster\d+_bus|scratchpad_bus))\."
+    r"(?:pktCount_(?P<port>\S+)::total|(?P<layer>(?:req|resp|snoop)Layer\d+)\.(?P<layer_stat>occupancy|utilization)"
+    r"|(?P<stat>pktCount::total|snoops|snoopTraffic))$"
+)
+MONITOR_STAT_RE = re.compile(
+    r"^(?P<monitor>\S*_monitor)\."
+    r"(?P<stat>readLatencyHist::mean|writeLatencyHist::mean|readBandwidthHist::mean|"
+    r"writeBandwidthHist::mean|totalReadBytes|totalWrittenBytes|"
+    r"outstandingReadsHist::mean|outstandingWritesHist::mean)$"
+)
+
+
+def interconnect_metrics(stats_path: Path) -> Dict[str, object]:
+    """Crossbar layer occupancy/utilisation, per-port packets and CommMonitor stats.
+
+    gem5 keeps one request layer per mem-side port and one response layer per
+    cpu-side port; a layer near utilisation 1.0 is where requests queue.
+    CommMonitor latencies (ticks) cover the whole path below the monitor.
+    """
+    xbars: Dict[str, Dict[str, object]] = {}
+    monitors: Dict[str, Dict[str, float]] = {}
+    if stats_path.exists():
+        for line in last_stats_block(stats_path):
+            columns = line.split()
+            if len(columns) < 2:
+                continue
+            try:
+                value = float(columns[1])
+            except ValueError:
+                continue
+            match = XBAR_STAT_RE.match(columns[0])
+            if match:
+                xbar = xbars.setdefault(match.group("xbar"), {"per_port_packets": {}, "layers": {}})
+                if match.group("port"):
+                    xbar["per_port_packets"][match.group("port")] = value
+                elif match.group("layer"):
+                    xbar["layers"].setdefault(match.group("layer"), {})[match.group("layer_stat")] = value
+                else:
+                    xbar[{"pktCount::total": "packets"}.get(match.group("stat"), match.group("stat"))] = value
+                continue
+            match = MONITOR_STAT_RE.match(columns[0])
+            if match:
+                monitors.setdefault(match.group("monitor"), {})[match.group("stat")] = value
+
+    hottest: Optional[Dict[str, object]] = None
+    for name, xbar in xbars.items():
+        layers = {layer: item for layer, item in xbar["layers"].items() if "utilization" in item}
+        if not layers:
+            continue
+        layer = max(layers, key=lambda key: layers[key]["utilization"])
+        xbar["max_layer_utilization"] = layers[layer]["utilization"]
+        if hottest is None or layers[layer]["utilization"] > hottest["utilization"]:
+            hottest = {"layer": f"{name}.{layer}", "utilization": layers[layer]["utilization"]}
+    return {
+        "xbars": xbars,
+        "monitors": monitors,
+        "hottest_layer": hottest,
+    }
+
+
+def unless_filtered(manifest: Dict[str, object], metrics: Dict[str, object]) -> Dict[str, object]:
+    """metrics, or a marker when a reduced --stats-profile left none of the stats they parse.
+
+    minimal/series keep only what the checks and the target's own summaries
+    read; an empty per-cache/per-ctrl/per-xbar table there means "not dumped",
+    not "no prefetchers/controllers/crossbars".
+    """
+    selection = manifest.get("stats_selection")
+    if not selection or selection["profile"] == "full":
+        return metrics
+    if any(value for value in metrics.values() if isinstance(value, dict)):
+        return metrics
+    return {"filtered": True, "stats_profile": selection["profile"]}
+
+
+def host_metrics(stats_path: Path) -> Dict[str, object]:
+    """Host wall time and simulated instructions of the last stats dump; KIPS = simInsts / hostSeconds / 1e3."""
+    values: Dict[str, float] = {}
+    if stats_path.exists():
+        for line in last_stats_block(stats_path):
+            columns = line.split()
+            if len(columns) >= 2 and columns[0] in ("hostSeconds", "simInsts", "simSeconds", "hostMemory"):
+                try:
+                    values[columns[0]] = float(columns[1])
+                except ValueError:
+                    continue
+    host_seconds = values.get("hostSeconds")
+    sim_insts = values.get("simInsts")
+    return {
+        "host_seconds": host_seconds,
+        "sim_insts": sim_insts,
+        "sim_seconds": values.get("simSeconds"),
+        "host_memory_bytes": values.get("hostMemory"),
+        "kips": round(sim_insts / host_seconds / 1e3, 3) if host_seconds and sim_insts is not None else None,
+    }
+
+
+TGEN_STAT_RE = re.compile(
+    r"^system\.(?P<gen>tgen\d+)\."
+    r"(?P<stat>bytesRead|bytesWritten|totalReads|totalWrites|avgReadLatency|avgWriteLatency|numRetries)$"
+)
+TGEN_HIST_RE = re.compile(
+    r"^system\.(?P<gen>tgen\d+)_monitor\.(?P<hist>read|write)LatencyHist::"
+    r"(?P<key>samples|mean|stdev|overflows|(?P<low>\d+)-(?P<high>\d+))$"
+)
+# Buses at or above this layer utilisation count as saturated.
+SATURATION_UTILIZATION = 0.9
+
+
+def _hist_summary(hist: Dict[str, object]) -> Dict[str, Optional[float]]:
+    """samples/mean/stdev plus p50/p90/p99 as the upper bound of the bucket holding each quantile."""
+    samples = float(hist.get("samples", 0.0))
+    out: Dict[str, Optional[float]] = {key: hist.get(key) for key in ("samples", "mean", "stdev", "overflows")}
+    buckets = sorted(hist.get("buckets", []))
+    for name, quantile in (("p50", 0.5), ("p90", 0.9), ("p99", 0.99)):
+        out[name] = None
+        seen = 0.0
+        for _, high, count in buckets:
+            seen += count
+            if samples and seen >= quantile * samples:
+                out[name] = float(high)
+                break
+    return out
+
+
+def traffic_metrics(stats_path: Path, plan_path: Path) -> Dict[str, object]:
+    """Per-generator achieved bandwidth and latency distribution of a traffic_mixed run.
+
+    plan_path is the traffic_mixed.json sidecar (offered load per generator);
+    latency histograms come from the CommMonitor in front of each generator.
+    """
+    plan = json.loads(plan_path.read_text(encoding="utf-8")) if plan_path.exists() else {}
+    stats: Dict[str, Dict[str, float]] = {}
+    hists: Dict[str, Dict[str, Dict[str, object]]] = {}
+    sim_seconds: Optional[float] = None
+    for line in last_stats_block(stats_path):
+        columns = line.split()
+        if len(columns) < 2:
+            continue
+        try:
+            value = float(columns[1])
+        except ValueError:
+            continue
+        if columns[0] == "simSeconds":
+            sim_seconds = value
+            continue
+        match = TGEN_STAT_RE.match(columns[0])
+        if match:
+            stats.setdefault(match.group("gen"), {})[match.group("stat")] = value
+            continue
+        match = TGEN_HIST_RE.match(columns[0])
+        if match:
+            hist = hists.setdefault(match.group("gen"), {}).setdefault(match.group("hist"), {"buckets": []})
+            if match.group("low") is not None:
+                hist["buckets"].append((int(match.group("low")), int(match.group("high")), value))
+            else:
+                hist[match.group("key")] = value
+
+    specs = {str(gen["name"]): gen for gen in plan.get("generators", [])}
+    generators: Dict[str, Dict[str, object]] = {}
+    for name in sorted(set(specs) | set(stats), key=lambda item: int(item[len("tgen"):])):
+        spec = specs.get(name, {})
+        item = stats.get(name, {})
+        moved = item.get("bytesRead", 0.0) + item.get("bytesWritten", 0.0)
+        achieved = moved / sim_seconds if sim_seconds else None
+        offered = spec.get("offered_bytes_per_sec")
+        generators[name] = {
+            "cluster": spec.get("cluster"),
+            "pattern": spec.get("pattern"),
+            "read_pct": spec.get("read_pct"),
+            "bytes": moved,
+            "offered_bytes_per_sec": offered,
+            "achieved_bytes_per_sec": achieved,
+            "achieved_share": achieved / offered if achieved is not None and offered else None,
+            "retries": item.get("numRetries"),
+            "read_latency": _hist_summary(hists.get(name, {}).get("read", {})),
+            "write_latency": _hist_summary(hists.get(name, {}).get("write", {})),
+        }
+
+    buses = {
+        bus: xbar.get("max_layer_utilization")
+        for bus, xbar in interconnect_metrics(stats_path)["xbars"].items()
+        if bus.endswith(("membus", "llc_bus")) or re.search(r"cluster\d+_bus$", bus)
+    }
+    return {
+        "duration_ticks": plan.get("duration_ticks"),
+        "sim_seconds": sim_seconds,
+        "generators": generators,
+        "total_achieved_bytes_per_sec": (
+            sum(gen["achieved_bytes_per_sec"] or 0.0 for gen in generators.values()) if sim_seconds else None
+        ),
+        "bus_utilization": buses,
+        "saturated_buses": sorted(
+            bus for bus, util in buses.items() if util is not None and util >= SATURATION_UTILIZATION
+        ),
+    }
+
+
+DVFS_SWEEP_RE = re.compile(
+    r"RISCV32 MIXED DVFS (?P<role>.+?) domain=(?P<domain>-?\d+) level=(?P<level>\d+) "
+    r"freq_khz=(?P<freq_khz>\d+) cycles=(?P<cycles>\d+)"
+)
+
+
+def dvfs_summary(stats_path: Path, terminal_logs: List[Path]) -> Dict[str, object]:
+    """Time-at-level residency from OmxDvfsCtrl stats plus guest sweep points."""
+    residency: Dict[str, Dict[str, float]] = {}
+    transitions: Dict[str, float] = {}
+    if stats_path.exists():
+        for line in last_stats_block(stats_path):
+            columns = line.split()
+            if len(columns) < 2 or "dvfs_ctrl." not in columns[0]:
+                continue
+            domain = re.search(r"domain(\d+)", columns[0])
+            if domain is None:
+                continue
+            try:
+                value = float(columns[1])
+            except ValueError:
+                continue
+            level = re.search(r"level(\d+)", columns[0])
+            if ".ticksAtLevel" in columns[0] and level is not None:
+                residency.setdefault(f"domain{domain.group(1)}", {})[f"level{level.group(1)}"] = value
+            elif ".transitions" in columns[0]:
+                transitions[f"domain{domain.group(1)}"] = value
+
+    fractions: Dict[str, Dict[str, float]] = {}
+    for domain, levels in residency.items():
+        total = sum(levels.values())
+        if total:
+            fractions[domain] = {level: ticks / total for level, ticks in levels.items()}
+
+    sweep: List[Dict[str, object]] = []
+    for path in terminal_logs:
+        if not path.exists():
+            continue
+        for match in DVFS_SWEEP_RE.finditer(path.read_text(encoding="utf-8", errors="ignore")):
+            sweep.append(
+                {
+                    "role": match.group("role"),
+                    "domain": int(match.group("domain")),
+                    "level": int(match.group("level")),
+                    "freq_khz": int(match.group("freq_khz")),
+                    "cycles": int(match.group("cycles")),
+                }
+            )
+
+    return {
+        "ticks_at_level": residency,
+        "time_fraction_at_level": fractions,
+        "transitions": transitions,
+        "sweep": sweep,
+    }
+
+
+MIXED_LLC_STATS = [
+    "system.llc.overallHits::total",
+    "system.llc.overallMisses::total",
+    "system.llc.overallAccesses::total",
+    "system.llc_bus.snoops",
+    "system.llc_bus.snoopTraffic",
+    "system.llc_bus.snoop_filter.totRequests",
+    "system.llc_bus.snoop_filter.totSnoops",
+    "system.llc_bus.snoop_filter.hitSingleSnoops",
+    "system.llc_bus.snoop_filter.hitMultiSnoops",
+]
+
+
+def mixed_llc_summary(stats_path: Path) -> Dict[str, object]:
+    raw = read_stats_map(stats_path, MIXED_LLC_STATS)
+    accesses = raw.get("system.llc.overallAccesses::total", 0.0)
+    hits = raw.get("system.llc.overallHits::total", 0.0)
+    return {
+        "llc_hit_rate": (hits / accesses) if accesses else None,
+        # Every snoop on llc_bus targets the other cluster's L2.
+        "cross_cluster_snoops": raw.get("system.llc_bus.snoop_filter.totSnoops"),
+        "raw": raw,
+    }
+
+
 def run_one(cmd: List[str], log_path: Path, timeout_sec: int) -> Dict[str, object]:
     with log_path.open("w", encoding="utf-8") as fp:
         env = os.environ.copy()
@@ -733,7 +1732,7 @@ def run_one_until_markers_multi(
 
 def mixed_terminal_logs(logs_dir: Path) -> List[Path]:
     candidates = sorted(
-        path for path in logs_dir.glob("system.platform.terminal*") if path.is_file()
+        path for path in logs_dir.glob("system.platform.terminal*") if path.is_file() and not is_sidecar(path)
     )
     if candidates:
         return candidates
@@ -741,8 +1740,12 @@ def mixed_terminal_logs(logs_dir: Path) -> List[Path]:
 
 
 def hybrid_terminal_logs(logs_dir: Path) -> Tuple[List[Path], List[Path]]:
-    rv32_logs = sorted(path for path in logs_dir.glob("system32.platform.terminal*") if path.is_file())
-    rv64_logs = sorted(path for path in logs_dir.glob("system64.platform.terminal*") if path.is_file())
+    rv32_logs = sorted(
+        path for path in logs_dir.glob("system32.platform.terminal*") if path.is_file() and not is_sidecar(path)
+    )
+    rv64_logs = sorted(
+        path for path in logs_dir.glob("system64.platform.terminal*") if path.is_file() and not is_sidecar(path)
+    )
     if not rv32_logs:
         rv32_logs = [logs_dir / "system32.platform.terminal"]
     if not rv64_logs:
@@ -752,6 +1755,9 @@ def hybrid_terminal_logs(logs_dir: Path) -> Tuple[List[Path], List[Path]]:
 
 def main() -> int:
     args = parser().parse_args()
+    gem5_variant = "custom" if args.gem5_bin else args.gem5_variant
+    if not args.gem5_bin:
+        args.gem5_bin = GEM5_VARIANTS[args.gem5_variant]
 
     ts = args.timestamp or utc_ts()
     results_dir = Path(args.results_root) / ts
@@ -780,13 +1786,24 @@ def main() -> int:
         "mode": args.mode,
         "dry_run": args.dry_run,
         "gem5_bin": args.gem5_bin,
+        "gem5_variant": gem5_variant,
         "config": str(config_path),
         "results_dir": str(results_dir),
         "logs_dir": str(logs_dir),
         "latest_links": latest_links,
+        "stats_period": args.stats_period,
+        "stats_selection": {
+            "profile": args.stats_profile,
+            "include": args.stats_include,
+            "exclude": args.stats_exclude,
+            "format": args.stats_format,
+        },
     }
 
     if args.target == "riscv64_smp":
+        if args.blk_bench:
+            args.initramfs = args.initramfs or BLK_BENCH_INITRAMFS
+            args.disk_image = args.disk_image or BLK_BENCH_IMAGE
         cmd, disk_image, kernel_elf, bootloader, initramfs, use_conf_runtime = rv64_command(
             args, config_path, logs_dir
         )
@@ -796,6 +1813,26 @@ def main() -> int:
         manifest["bootloader"] = bootloader
         manifest["initramfs"] = initramfs
         manifest["conf_runtime"] = use_conf_runtime
+        bench_info = bench_initramfs_info(initramfs) if use_conf_runtime else None
+        manifest["bench_initramfs"] = bench_info
+        manifest["boot_timing"] = args.boot_timing
+        manifest["tick_terminal"] = args.tick_terminal if use_conf_runtime else "off"
+        if args.tick_terminal != "off" and not use_conf_runtime:
+            print("[WARN] --tick-terminal needs the conf runtime (conf/riscv64_smp.py); ignored for fs.py")
+        if args.boot_timing and manifest["tick_terminal"] == "off" and not args.gem5_bin.endswith(".opt"):
+            print("[WARN] --boot-timing needs tracing (gem5.opt); boot_timeline falls back to printk timestamps")
+        manifest["block"] = {
+            "blk_bench": args.blk_bench,
+            "image": disk_image,
+            "latency": args.blk_latency,
+            "bandwidth": args.blk_bandwidth,
+        }
+        if (args.blk_latency or args.blk_bandwidth) and not use_conf_runtime:
+            print("[WARN] --blk-latency/--blk-bandwidth need the conf runtime (conf/riscv64_smp.py); ignored for fs.py")
+        if stats_args(args) and not use_conf_runtime:
+            print("[WARN] --stats-* options need the conf runtime (conf/riscv64_smp.py); ignored for fs.py")
+            manifest["stats_period"] = 0
+            manifest["stats_selection"] = None
 
         if not Path(kernel_elf).exists():
             missing.append(f"kernel ELF: {kernel_elf}")
@@ -805,6 +1842,8 @@ def main() -> int:
             missing.append("initramfs: not found (expected rootfs-shell.cpio/rootfs.cpio)")
         if (not use_conf_runtime) and (not disk_image and not args.allow_no_disk):
             missing.append("disk image: not found (expected rootfs.ext2)")
+        if args.blk_bench and not Path(disk_image).exists():
+            missing.append(f"blk bench disk: {disk_image} (python3 scripts/build_blk_image.py)")
 
         if args.dry_run:
             print("[INFO] DRY-RUN mode")
@@ -828,7 +1867,12 @@ def main() -> int:
         if not disk_image:
             print("[WARN] Running without disk image (--allow-no-disk).")
         terminal_log = logs_dir / "system.platform.terminal"
-        if use_conf_runtime and args.mode == "simple":
+        if bench_info is not None and bench_info.get("m5_exit"):
+            # init ends the simulation with m5 exit after the last benchmark.
+            run_result = run_one(cmd, run_log, args.timeout_sec)
+        elif bench_info is not None:
+            run_result = run_one_until_markers(cmd, run_log, terminal_log, ["OMX_BENCH_DONE"], args.timeout_sec)
+        elif use_conf_runtime and args.mode == "simple":
             run_result = run_one_until_markers(
                 cmd,
                 run_log,
@@ -848,20 +1892,22 @@ def main() -> int:
                 "Run /init as init process",
                 "INITRAMFS_SHELL_READY",
                 "initramfs#",
+                "OMX_BENCH_DONE",
                 "simulate() limit reached",
                 "Kernel panic",
                 "fatal:",
             ],
         )
+        # The benchmark initramfs has no shell; its init reports OMX_BENCH_DONE.
+        if bench_info is not None:
+            userspace_ok = markers["OMX_BENCH_DONE"]
+        else:
+            userspace_ok = markers["INITRAMFS_SHELL_READY"] and markers["initramfs#"]
         required_markers_ok = markers["Loaded bootloader"] and markers["Loaded kernel"]
         if use_conf_runtime:
             required_markers_ok = required_markers_ok and markers["Run /init as init process"]
             if args.mode == "simple":
-                required_markers_ok = (
-                    required_markers_ok
-                    and markers["INITRAMFS_SHELL_READY"]
-                    and markers["initramfs#"]
-                )
+                required_markers_ok = required_markers_ok and userspace_ok
         checks = {
             "returncode_ok": int(run_result["returncode"]) == 0,
             "required_markers_ok": required_markers_ok,
@@ -872,13 +1918,29 @@ def main() -> int:
             "panic_free": (not markers["Kernel panic"]) and (not markers["fatal:"]),
             "shell_prompt_ok": (not use_conf_runtime)
             or (args.mode != "simple")
-            or (markers["INITRAMFS_SHELL_READY"] and markers["initramfs#"]),
+            or userspace_ok,
         }
+        manifest["boot_timeline"] = boot_timeline(logs_dir, terminal_log)
+        manifest["terminal_ticks"] = terminal_ticks([terminal_log], list(markers))
+        if bench_info is not None:
+            manifest["bench_results"] = bench_results(terminal_log)
+            manifest["bench_scaling"] = bench_scaling(manifest["bench_results"]["results"])
+            checks["bench_status_ok"] = all(
+                item.get("exit") == 0 for item in manifest["bench_results"]["status"].values()
+            ) and len(manifest["bench_results"]["status"]) == len(bench_info.get("benchmarks", []))
+        if disk_image:
+            manifest["blk_metrics"] = blk_metrics(logs_dir / "stats.txt")
+        if manifest["stats_period"]:
+            manifest["stats_series"] = stats_series(logs_dir / "stats.txt", logs_dir)
         manifest.update({
             "run_log": str(run_log),
             "terminal_log": str(terminal_log),
             "run_result": run_result,
             "markers": markers,
+            "prefetch_metrics": unless_filtered(manifest, prefetch_metrics(logs_dir / "stats.txt")),
+            "memory_metrics": unless_filtered(manifest, memory_metrics(logs_dir / "stats.txt")),
+            "interconnect_metrics": unless_filtered(manifest, interconnect_metrics(logs_dir / "stats.txt")),
+            "host_metrics": host_metrics(logs_dir / "stats.txt"),
             "checks": checks,
             "validation": {
                 "single_run": True,
@@ -891,16 +1953,25 @@ def main() -> int:
         return 1 if not all(checks.values()) else 0
 
     if args.target == "riscv_hybrid":
+        if args.hybrid_shm:
+            args.initramfs = args.initramfs or HYBRID_SHM_INITRAMFS
         cmd, disk_image, kernel_elf, bootloader, initramfs = rv_hybrid_command(
             args, config_path, logs_dir
         )
+        bench_info = bench_initramfs_info(initramfs)
+        # The benchmark initramfs has no shell; its init reports OMX_BENCH_DONE.
+        rv64_ready_markers = ["OMX_BENCH_DONE"] if bench_info is not None else ["INITRAMFS_SHELL_READY", "initramfs#"]
         stop_on_marker = args.mode == "simple" and (not args.no_stop_on_marker)
         manifest["commands"] = [cmd]
         manifest["stop_on_marker"] = stop_on_marker
+        manifest["tick_terminal"] = args.tick_terminal
         manifest["kernel_elf"] = kernel_elf
         manifest["bootloader"] = bootloader
         manifest["initramfs"] = initramfs
         manifest["disk_image"] = disk_image
+        manifest["bench_initramfs"] = bench_info
+        manifest["hybrid_shm"] = {"enabled": args.hybrid_shm, "responder_elf": args.amp_cpu1_elf}
+        manifest["host_attribution_period"] = args.host_attribution_period
         manifest["hybrid_components"] = {
             "rv32_mixed": {
                 "boot_elf": args.mixed_boot_elf,
@@ -921,6 +1992,11 @@ def main() -> int:
             missing.append("bootloader: not found (expected fw_jump.elf)")
         if not initramfs:
             missing.append("initramfs: not found (expected rootfs-shell.cpio/rootfs.cpio)")
+        elif args.hybrid_shm and not Path(initramfs).exists():
+            missing.append(
+                f"hybrid shm initramfs: {initramfs} "
+                "(python3 scripts/build_bench_initramfs.py --config conf/initramfs/bench_hybrid_shm.json)"
+            )
         for name, elf in [
             ("amp_cpu0_elf", args.amp_cpu0_elf),
             ("amp_cpu1_elf", args.amp_cpu1_elf),
@@ -981,8 +2057,7 @@ def main() -> int:
                     "RISCV32 MIXED ROLE_SYNC mask=0x7 status=READY",
                     "Linux version",
                     "Run /init as init process",
-                    "INITRAMFS_SHELL_READY",
-                    "initramfs#",
+                    *rv64_ready_markers,
                 ],
                 args.timeout_sec,
             )
@@ -1009,8 +2084,7 @@ def main() -> int:
             "Loaded bootloader",
             "Loaded kernel",
             "Run /init as init process",
-            "INITRAMFS_SHELL_READY",
-            "initramfs#",
+            *rv64_ready_markers,
             "Kernel panic",
             "fatal:",
             "panic",
@@ -1051,7 +2125,7 @@ def main() -> int:
             evaluate_stage(
                 "rv64_shell_ready",
                 markers,
-                ["INITRAMFS_SHELL_READY", "initramfs#"],
+                rv64_ready_markers,
             ),
             evaluate_stage(
                 "panic_free",
@@ -1081,6 +2155,23 @@ def main() -> int:
             ),
             "panic_free": stage_map["panic_free"],
         }
+        if bench_info is not None:
+            manifest["bench_results"] = bench_results(rv64_logs[0])
+            manifest["bench_scaling"] = bench_scaling(manifest["bench_results"]["results"])
+            checks["bench_status_ok"] = all(
+                item.get("exit") == 0 for item in manifest["bench_results"]["status"].values()
+            ) and len(manifest["bench_results"]["status"]) == len(bench_info.get("benchmarks", []))
+        if args.hybrid_shm:
+            manifest["hybrid_shm"]["responder_attached"] = read_markers_from_paths(
+                rv32_logs, [HYBRID_SHM_RESPONDER_MARKER]
+            )[HYBRID_SHM_RESPONDER_MARKER]
+            checks["hybrid_shm_attached"] = manifest["hybrid_shm"]["responder_attached"]
+        if args.host_attribution_period:
+            # Informational: a run too short for the fit fails this stage but no check.
+            manifest["host_attribution"] = host_attribution(logs_dir / "stats.txt")
+            stage_report.append(host_attribution_stage(manifest["host_attribution"]))
+        if args.stats_period:
+            manifest["stats_series"] = stats_series(logs_dir / "stats.txt", logs_dir)
 
         print("[INFO] Hybrid staged report:")
         for stage in stage_report:
@@ -1092,6 +2183,9 @@ def main() -> int:
                 detail += f" missing={','.join(missing)}"
             if forbidden_hits:
                 detail += f" forbidden={','.join(forbidden_hits)}"
+            for name, item in dict(stage.get("systems", {})).items():
+                if item.get("host_share") is not None:
+                    detail += f" {name}={item['host_share'] * 100:.1f}%/{item['kips']}kips"
             print(f"[STAGE][{status}] {stage['name']}{detail}")
 
         manifest.update(
@@ -1102,7 +2196,15 @@ def main() -> int:
                 "run_result": run_result,
                 "timeout_accepted": timeout_accepted,
                 "markers": markers,
+                "terminal_ticks": {
+                    "rv32": terminal_ticks(rv32_logs, rv32_workload_markers + rv32_role_markers),
+                    "rv64": terminal_ticks(rv64_logs, rv64_markers),
+                },
                 "stage_report": stage_report,
+                "prefetch_metrics": unless_filtered(manifest, prefetch_metrics(logs_dir / "stats.txt")),
+                "memory_metrics": unless_filtered(manifest, memory_metrics(logs_dir / "stats.txt")),
+                "interconnect_metrics": unless_filtered(manifest, interconnect_metrics(logs_dir / "stats.txt")),
+                "host_metrics": host_metrics(logs_dir / "stats.txt"),
                 "checks": checks,
                 "validation": {
                     "single_run": True,
@@ -1119,6 +2221,10 @@ def main() -> int:
         cmd, simple_elf = rv32_simple_command(args, config_path, logs_dir)
         manifest["commands"] = [cmd]
         manifest["simple_elf"] = simple_elf
+        if stats_args(args):
+            print("[WARN] --stats-* options are not supported for riscv32_simple; ignored")
+            manifest["stats_period"] = 0
+            manifest["stats_selection"] = None
 
         if not Path(simple_elf).exists():
             missing.append(f"simple_elf: {simple_elf}")
@@ -1161,6 +2267,9 @@ def main() -> int:
             "run_result": run_result,
             "markers": markers,
             "sim_insts": sim_insts,
+            "memory_metrics": unless_filtered(manifest, memory_metrics(stats_path)),
+            "interconnect_metrics": unless_filtered(manifest, interconnect_metrics(stats_path)),
+            "host_metrics": host_metrics(stats_path),
         })
         manifest_path.write_text(json.dumps(manifest, indent=2) + "\n", encoding="utf-8")
         print(f"[INFO] run_log={run_log}")
@@ -1168,25 +2277,125 @@ def main() -> int:
         print(f"[OK] Manifest: {manifest_path}")
         return int(run_result["returncode"])
 
+    if args.target == "traffic_mixed":
+        cmd = traffic_mixed_command(args, config_path, logs_dir)
+        manifest["commands"] = [cmd]
+        manifest["traffic"] = {
+            "patterns": args.traffic_patterns,
+            "read_pct": args.traffic_read_pct,
+            "period_ticks": args.traffic_period_ticks,
+            "targets": args.traffic_targets,
+            "duration_ticks": args.traffic_duration_ticks,
+        }
+        manifest["interconnect"] = {"xbar_args": xbar_args(args), "comm_monitor": args.comm_monitor}
+
+        if args.dry_run:
+            print("[INFO] DRY-RUN mode")
+            for item in missing:
+                print(f"[WARN] Missing path: {item}")
+            print(f"[INFO] command={quoted(cmd)}")
+            manifest_path.write_text(json.dumps(manifest, indent=2) + "\n", encoding="utf-8")
+            print(f"[OK] Manifest: {manifest_path}")
+            return 0
+
+        if missing:
+            for item in missing:
+                print(f"[ERROR] Missing path: {item}", file=sys.stderr)
+            manifest_path.write_text(json.dumps(manifest, indent=2) + "\n", encoding="utf-8")
+            return 2
+
+        run_log = logs_dir / "run_traffic_mixed.log"
+        print(f"[INFO] Executing: {quoted(cmd)}")
+        run_result = run_one(cmd, run_log, args.timeout_sec)
+        stats_path = logs_dir / "stats.txt"
+        traffic = traffic_metrics(stats_path, logs_dir / "traffic_mixed.json")
+        checks = {
+            "returncode_ok": int(run_result["returncode"]) == 0,
+            # Every generator that was meant to move data did.
+            "traffic_ok": bool(traffic["generators"])
+            and all(gen["bytes"] > 0 for gen in traffic["generators"].values() if gen["pattern"] != "idle"),
+        }
+        manifest.update(
+            {
+                "run_log": str(run_log),
+                "stats_path": str(stats_path),
+                "run_result": run_result,
+                "traffic_metrics": traffic,
+                "stats_series": stats_series(stats_path, logs_dir) if args.stats_period else None,
+                "memory_metrics": unless_filtered(manifest, memory_metrics(stats_path)),
+                "interconnect_metrics": unless_filtered(manifest, interconnect_metrics(stats_path)),
+                "host_metrics": host_metrics(stats_path),
+                "checks": checks,
+                "validation": {"single_run": True, "all_passed": all(checks.values())},
+            }
+        )
+        manifest_path.write_text(json.dumps(manifest, indent=2) + "\n", encoding="utf-8")
+        for name, gen in traffic["generators"].items():
+            achieved = gen["achieved_bytes_per_sec"]
+            print(
+                f"[INFO] {name} {gen['pattern']}: "
+                f"{achieved / 1e9 if achieved is not None else 0.0:.2f} GB/s "
+                f"read p50/p99={gen['read_latency']['p50']}/{gen['read_latency']['p99']} ticks"
+            )
+        if traffic["saturated_buses"]:
+            print(f"[INFO] saturated: {', '.join(traffic['saturated_buses'])}")
+        print(f"[OK] Manifest: {manifest_path}")
+        return 1 if not all(checks.values()) else 0
+
     # riscv32_mixed
-    cmd, assignments, workload_markers, role_markers = rv32_mixed_command(args, config_path, logs_dir)
+    topology = None
+    if args.topology:
+        try:
+            topology = generate_topology(args)
+        except (OSError, subprocess.CalledProcessError) as exc:
+            print(f"[ERROR] topology generation failed: {exc}", file=sys.stderr)
+            return 2
+    cmd, assignments, workload_markers, role_markers = rv32_mixed_command(
+        args, config_path, logs_dir, topology
+    )
     manifest["commands"] = [cmd]
+    if topology:
+        manifest["topology"] = {
+            "name": topology["name"],
+            "source": args.topology,
+            "num_harts": topology["num_harts"],
+            "clusters": [
+                {"name": c["name"], "mode": c["mode"], "harts": c["harts"]} for c in topology["clusters"]
+            ],
+            "memory_map": str(Path(str(topology["out_dir"])) / "memory_map.json"),
+        }
     manifest["mixed_boot_elf"] = args.mixed_boot_elf
+    manifest["memory_system"] = args.memory_system
+    manifest["shared_llc"] = args.shared_llc
+    manifest["dvfs_enabled"] = args.dvfs
+    manifest["shared_region"] = {
+        "backing": args.shared_mem or "dram",
+        "cacheable": args.shared_cacheable != "off",
+    }
+    manifest["interconnect"] = {"xbar_args": xbar_args(args), "comm_monitor": args.comm_monitor}
+    manifest["tick_terminal"] = args.tick_terminal
+    manifest["cluster_cpu_types"] = args.cluster_cpu_types or mixed_cpu_type(args.cpu_type)
+    manifest["mem_trace"] = {"mode": args.mem_trace}
+    manifest["prefetchers"] = {"l1d": args.l1d_prefetcher or "none", "l2": args.l2_prefetcher or "none"}
     manifest["workload_assignments"] = assignments
     manifest["workload_markers"] = workload_markers
     manifest["role_markers"] = role_markers
 
-    for name, elf in [
-        ("amp_cpu0_elf", args.amp_cpu0_elf),
-        ("amp_cpu1_elf", args.amp_cpu1_elf),
-        ("smp_elf", args.smp_elf),
-    ]:
+    if topology:
+        image_elfs = [(f"{image['name']}_elf", str(image["elf"])) for image in topology["images"]]
+    else:
+        image_elfs = [
+            ("amp_cpu0_elf", args.amp_cpu0_elf),
+            ("amp_cpu1_elf", args.amp_cpu1_elf),
+            ("smp_elf", args.smp_elf),
+        ]
+    for name, elf in image_elfs:
         if not Path(elf).exists():
             missing.append(f"{name}: {elf}")
 
     if not args.dry_run:
         try:
-            maybe_build_mixed_boot(args)
+            maybe_build_mixed_boot(args, topology)
         except Exception as exc:
             missing.append(f"mixed_boot_build: {exc}")
 
@@ -1238,6 +2447,11 @@ def main() -> int:
         "terminal_markers_ok": terminal_required_ok,
         "panic_free": (not markers["Kernel panic"]) and (not markers["panic"]),
     }
+    if args.mem_trace != "off":
+        # conf/riscv32_mixed.py writes the sidecar after the run; conf/mem_replay.py reads it.
+        sidecar = logs_dir / "mem_trace.json"
+        manifest["mem_trace"]["sidecar"] = str(sidecar) if sidecar.exists() else None
+        checks["mem_trace_ok"] = sidecar.exists()
     role_observations = {m: markers[m] for m in role_markers}
     manifest.update(
         {
@@ -1249,7 +2463,15 @@ def main() -> int:
             "terminal_markers": terminal_markers,
             "markers": markers,
             "role_observations": role_observations,
+            "terminal_ticks": terminal_ticks(terminal_logs, workload_markers + role_markers),
             "sim_insts": sim_insts,
+            "llc_stats": mixed_llc_summary(stats_path) if args.shared_llc else None,
+            "prefetch_metrics": unless_filtered(manifest, prefetch_metrics(stats_path)),
+            "memory_metrics": unless_filtered(manifest, memory_metrics(stats_path)),
+            "interconnect_metrics": unless_filtered(manifest, interconnect_metrics(stats_path)),
+            "host_metrics": host_metrics(stats_path),
+            "dvfs": dvfs_summary(stats_path, terminal_logs) if args.dvfs else None,
+            "stats_series": stats_series(stats_path, logs_dir) if args.stats_period else None,
             "checks": checks,
             "validation": {
                 "single_run": True,
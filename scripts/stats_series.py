@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+"""Time series of periodic stats dumps and phase detection.
+
+The configs dump cumulative stats every --stats-period ticks
+(conf/omx_gem5.py simulate_in_slices). Consecutive dumps are turned into
+per-interval deltas of a few selected stats:
+
+- insts.<cpu> / cycles.<cpu>: committed instructions and active cycles
+- misses.<cache>: overallMisses::total of every cache
+- busy.<xbar>: busiest layer's occupancy / interval ticks per crossbar
+
+plus tick_end, ticks and host_seconds per interval. A counter that goes
+down was reset by the guest (m5 resetstats in the benchmark initramfs);
+that interval counts from the reset. The result is stored as
+a columnar JSON (one array per column) next to the run's other logs.
+
+Phases are detected per top-level system (system, system32, system64):
+each interval's activity (instructions per tick, or the busiest crossbar
+for systems without CPUs) is quantized against the system's peak into
+idle/low/high, equal neighbours are merged and runs shorter than
+--min-intervals are absorbed into the previous phase.
+
+run_gem5.py adds the path and the phases to the manifest as stats_series.
+CLI: write the series for a stats.txt and print the phases.
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence
+
+from host_attribution import INST_STATS, stats_blocks
+
+SERIES_FILE = "stats_series.json"
+CPU_STAT_RE = re.compile(
+    r"^(?P<cpu>(?P<system>system\d*)\.(?:\S+\.)?cpu\d*)\."
+    r"(?P<stat>numCycles|commitStats0\.numInsts|exec_context\.thread_0\.numInsts|committedInsts)$"
+)
+CACHE_MISS_RE = re.compile(r"^(?P<cache>system\d*\.\S+)\.overallMisses::total$")
+LAYER_OCCUPANCY_RE = re.compile(
+    r"^(?P<xbar>system\d*\.(?:\S+\.)?(?:membus|iobus|l2bus|llc_bus|cluster\d+_bus|scratchpad_bus))\."
+    r"(?P<layer>(?:req|resp|snoop)Layer\d+)\.occupancy$"
+)
+# Activity relative to the system's peak interval: <= IDLE_FRACTION is idle, below HIGH_FRACTION is low.
+IDLE_FRACTION = 0.05
+HIGH_FRACTION = 0.5
+MIN_INTERVALS = 2
+
+
+def block_values(lines: Sequence[str]) -> Dict[str, object]:
+    """Tick, host seconds and the selected cumulative counters of one dump."""
+    tick = host_seconds = 0.0
+    cpus: Dict[str, Dict[str, float]] = {}
+    misses: Dict[str, float] = {}
+    layers: Dict[str, Dict[str, float]] = {}
+    for line in lines:
+        columns = line.split()
+        if len(columns) < 2:
+            continue
+        try:
+            value = float(columns[1])
+        except ValueError:
+            continue
+        if columns[0] == "finalTick" or (columns[0] == "simTicks" and not tick):
+            tick = value
+            continue
+        if columns[0] == "hostSeconds":
+            host_seconds = value
+            continue
+        match = CPU_STAT_RE.match(columns[0])
+        if match:
+            cpus.setdefault(match.group("cpu"), {})[match.group("stat")] = value
+            continue
+        match = CACHE_MISS_RE.match(columns[0])
+        if match:
+            misses[match.group("cache")] = value
+            continue
+        match = LAYER_OCCUPANCY_RE.match(columns[0])
+        if match:
+            layers.setdefault(match.group("xbar"), {})[match.group("layer")] = value
+
+    counters: Dict[str, float] = {}
+    for cpu, stats in cpus.items():
+        counters[f"insts.{cpu}"] = next((stats[key] for key in INST_STATS if key in stats), 0.0)
+        counters[f"cycles.{cpu}"] = stats.get("numCycles", 0.0)
+    for cache, value in misses.items():
+        counters[f"misses.{cache}"] = value
+    return {"tick": tick, "host_seconds": host_seconds, "counters": counters, "layers": layers}
+
+
+def _delta(value: float, before: float) -> float:
+    return value - before if value >= before else value
+
+
+def build_series(blocks: List[List[str]]) -> Dict[str, object]:
+    """Columnar per-interval deltas of consecutive cumulative dumps (the first interval starts at tick 0)."""
+    dumps = [block_values(block) for block in blocks]
+    counter_names = sorted({name for dump in dumps for name in dump["counters"]})
+    xbar_names = sorted({name for dump in dumps for name in dump["layers"]})
+    columns: Dict[str, List[float]] = {"tick_end": [], "ticks": [], "host_seconds": []}
+    columns.update({name: [] for name in counter_names})
+    columns.update({f"busy.{name}": [] for name in xbar_names})
+
+    previous = {"tick": 0.0, "host_seconds": 0.0, "counters": {}, "layers": {}}
+    for dump in dumps:
+        ticks = dump["tick"] - previous["tick"]
+        if ticks <= 0:
+            continue
+        columns["tick_end"].append(int(dump["tick"]))
+        columns["ticks"].append(int(ticks))
+        columns["host_seconds"].append(round(max(dump["host_seconds"] - previous["host_seconds"], 0.0), 6))
+        for name in counter_names:
+            before = previous["counters"].get(name, 0.0)
+            columns[name].append(int(_delta(dump["counters"].get(name, before), before)))
+        for name in xbar_names:
+            layers = dump["layers"].get(name, {})
+            before = previous["layers"].get(name, {})
+            busiest = max(
+                (_delta(value, before.get(layer, 0.0)) for layer, value in layers.items()),
+                default=0.0,
+            )
+            columns[f"busy.{name}"].append(round(min(max(busiest / ticks, 0.0), 1.0), 4))
+        previous = dump
+
+    return {
+        "kind": "omx-stats-series",
+        "intervals": len(columns["tick_end"]),
+        "columns": columns,
+    }
+
+
+def _system_of(column: str) -> str:
+    return column.split(".", 2)[1]
+
+
+def _level(activity: float, peak: float, idle_frac: float) -> str:
+    if peak <= 0 or activity <= idle_frac * peak:
+        return "idle"
+    return "high" if activity >= HIGH_FRACTION * peak else "low"
+
+
+def _runs(levels: List[str], min_intervals: int) -> List[List[int]]:
+    """[level_index, start, end) runs of equal levels; short runs merge into the previous one."""
+    runs: List[List[int]] = []
+    for index, level in enumerate(levels):
+        if runs and levels[runs[-1][0]] == level:
+            runs[-1][2] = index + 1
+        else:
+            runs.append([index, index, index + 1])
+    merged: List[List[int]] = []
+    for run in runs:
+        short = run[2] - run[1] < min_intervals
+        if merged and (short or levels[merged[-1][0]] == levels[run[0]]):
+            merged[-1][2] = run[2]
+        elif merged and merged[-1][2] - merged[-1][1] < min_intervals:
+            # A short leading run takes the level of what follows it.
+            merged[-1] = [run[0], merged[-1][1], run[2]]
+        else:
+            merged.append(list(run))
+    return merged
+
+
+def detect_phases(
+    series: Dict[str, object],
+    idle_frac: float = IDLE_FRACTION,
+    min_intervals: int = MIN_INTERVALS,
+) -> Dict[str, List[Dict[str, object]]]:
+    """Per top-level system, phases of similar activity with their IPC, MPKI and bus utilisation."""
+    columns: Dict[str, List[float]] = series["columns"]
+    ticks = columns["ticks"]
+    systems = sorted({_system_of(name) for name in columns if "." in name})
+    phases: Dict[str, List[Dict[str, object]]] = {}
+    for system in systems:
+        def total(prefix: str, index: int) -> float:
+            return sum(
+                values[index]
+                for name, values in columns.items()
+                if name.startswith(prefix + ".") and _system_of(name) == system
+            )
+
+        busy_names = [name for name in columns if name.startswith("busy.") and _system_of(name) == system]
+        has_cpus = any(name.startswith("insts.") and _system_of(name) == system for name in columns)
+        busy = [max((columns[name][i] for name in busy_names), default=0.0) for i in range(len(ticks))]
+        insts = [total("insts", i) for i in range(len(ticks))]
+        activity = [insts[i] / ticks[i] for i in range(len(ticks))] if has_cpus else busy
+        peak = max(activity, default=0.0)
+        levels = [_level(value, peak, idle_frac) for value in activity]
+
+        system_phases: List[Dict[str, object]] = []
+        for level_index, start, end in _runs(levels, min_intervals):
+            phase_insts = sum(insts[start:end])
+            cycles = sum(total("cycles", i) for i in range(start, end))
+            misses = sum(total("misses", i) for i in range(start, end))
+            system_phases.append(
+                {
+                    "level": levels[level_index],
+                    "start_tick": columns["tick_end"][start] - ticks[start],
+                    "end_tick": columns["tick_end"][end - 1],
+                    "intervals": end - start,
+                    "insts": int(phase_insts),
+                    "ipc": round(phase_insts / cycles, 4) if cycles else None,
+                    "mpki": round(misses * 1000.0 / phase_insts, 3) if phase_insts else None,
+                    "bus_utilization": round(sum(busy[start:end]) / (end - start), 4),
+                }
+            )
+        phases[system] = system_phases
+    return phases
+
+
+def write_series(
+    stats_path: Path,
+    out_dir: Path,
+    idle_frac: float = IDLE_FRACTION,
+    min_intervals: int = MIN_INTERVALS,
+) -> Optional[Dict[str, object]]:
+    """Write SERIES_FILE to out_dir; None when the run has fewer than two dumps (no --stats-period)."""
+    blocks = stats_blocks(stats_path)
+    if len(blocks) < 2:
+        return None
+    series = build_series(blocks)
+    out_dir.mkdir(parents=True, exist_ok=True)
+    path = out_dir / SERIES_FILE
+    path.write_text(json.dumps(series, separators=(",", ":")) + "\n", encoding="utf-8")
+    return {
+        "path": str(path),
+        "intervals": series["intervals"],
+        "phases": detect_phases(series, idle_frac, min_intervals),
+    }
+
+
+def main() -> int:
+    p = argparse.ArgumentParser(description="Time series and phases from periodic stats dumps")
+    p.add_argument("stats", help="stats.txt of a run with --stats-period")
+    p.add_argument("--out-dir", default="", help=f"directory for {SERIES_FILE} (default: next to stats.txt)")
+    p.add_argument("--idle-frac", type=float, default=IDLE_FRACTION, help="activity share of the peak that is idle")
+    p.add_argument("--min-intervals", type=int, default=MIN_INTERVALS, help="shortest phase in intervals")
+    args = p.parse_args()
+    stats_path = Path(args.stats)
+    out_dir = Path(args.out_dir) if args.out_dir else stats_path.parent
+    result = write_series(stats_path, out_dir, args.idle_frac, args.min_intervals)
+    if result is None:
+        print(f"[WARN] fewer than two stats dumps in {stats_path}; run with --stats-period", file=sys.stderr)
+        return 1
+    print(json.dumps(result, indent=2))
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
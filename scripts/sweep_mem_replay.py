@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+"""Sweep candidate cache/memory configurations over one recorded trace.
+
+The capture is a riscv32_mixed run with --mem-trace packet|elastic
+(run_gem5.py --target riscv32_mixed --mem-trace ...); each grid point is one
+gem5 run of conf/mem_replay.py against its logs dir. The grid is the
+cartesian product of the comma-separated --l2-sizes, --l2-assocs,
+--l2-prefetchers, --l1d-sizes (elastic only), --mem-types and --mem-channels;
+--jobs runs points in parallel.
+
+Per point, from the replay's last stats dump:
+- sim_ticks: replay length; for elastic traces the candidate's execution time
+- l2_miss_rate / l2_avg_miss_latency: access-weighted over the cluster L2s
+- read_latency / write_latency: packet replays, mean TrafficGen latency (ticks)
+- mem_bw / max_bus_util: memory_metrics of run_gem5.py
+- host_seconds and speedup_vs_capture (capture hostSeconds / replay hostSeconds)
+
+Points are ranked by sim_ticks (elastic) or read_latency (packet).
+
+Outputs:
+- <out-root>/<point>/: the replay outdirs
+- <results-root>/<ts>/mem_replay_sweep.json, summary_mem_replay_sweep.md
+"""
+
+import argparse
+import itertools
+import json
+import re
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+from datetime import datetime, timezone
+from pathlib import Path
+from typing import Dict, List, Optional
+
+REPO_ROOT = Path(__file__).resolve().parents[1]
+sys.path.insert(0, str(REPO_ROOT / "scripts"))
+
+from host_attribution import last_stats_block  # noqa: E402
+from run_gem5 import GEM5_VARIANTS, host_metrics, memory_metrics  # noqa: E402
+
+REPLAY_CONFIG = REPO_ROOT / "conf" / "mem_replay.py"
+L2_STAT_RE = re.compile(
+    r"^system\.cluster\d+_l2\.(?P<stat>overallAccesses|overallMissRate|overallAvgMissLatency)::total$"
+)
+GEN_STAT_RE = re.compile(r"^system\.cluster\d+_gen\.(?P<stat>avgReadLatency|avgWriteLatency|numPackets)$")
+# (axis, replay option, sweep option)
+AXES = (
+    ("l2_size", "--l2-size", "l2_sizes"),
+    ("l2_assoc", "--l2-assoc", "l2_assocs"),
+    ("l2_prefetcher", "--l2-prefetcher", "l2_prefetchers"),
+    ("l1d_size", "--l1d-size", "l1d_sizes"),
+    ("mem_type", "--mem-type", "mem_types"),
+    ("mem_channels", "--mem-channels", "mem_channels"),
+)
+
+
+def utc_ts() -> str:
+    return datetime.now(timezone.utc).strftime("%Y%m%dT%H%M%SZ")
+
+
+def parser() -> argparse.ArgumentParser:
+    p = argparse.ArgumentParser(
+        description="Sweep conf/mem_replay.py over a grid of cache/memory candidates",
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter,
+    )
+    p.add_argument("--trace-dir", required=True, help="logs dir of the --mem-trace capture run")
+    p.add_argument("--l2-sizes", default="", help="e.g. 128kB,256kB,512kB (empty: captured)")
+    p.add_argument("--l2-assocs", default="", help="e.g. 4,8,16 (empty: captured)")
+    p.add_argument("--l2-prefetchers", default="", help="e.g. none,stride,bop (empty: none)")
+    p.add_argument("--l1d-sizes", default="", help="elastic traces only, e.g. 16kB,32kB (empty: captured)")
+    p.add_argument("--mem-types", default="", help="e.g. simple,ddr4,lpddr5 (empty: captured)")
+    p.add_argument("--mem-channels", default="", help="e.g. 1,2,4 (empty: captured)")
+    p.add_argument("--replay-args", default="", help="extra conf/mem_replay.py options for every point")
+    p.add_argument("--gem5-variant", choices=sorted(GEM5_VARIANTS), default="opt")
+    p.add_argument("--gem5-bin", default="", help="gem5 binary (overrides --gem5-variant)")
+    p.add_argument("--jobs", type=int, default=1, help="replays run in parallel")
+    p.add_argument("--timeout-sec", type=int, default=3600)
+    p.add_argument("--timestamp", default="")
+    p.add_argument("--out-root", default="", help="replay outdirs (default: build/mem-replay/<ts>)")
+    p.add_argument("--results-root", default="workloads/results")
+    p.add_argument("--dry-run", action="store_true", help="validate every point with --print-json, run nothing")
+    return p
+
+
+def grid(args: argparse.Namespace) -> List[Dict[str, str]]:
+    values = []
+    for axis, _, option in AXES:
+        items = [item.strip() for item in str(getattr(args, option)).split(",") if item.strip()]
+        values.append([(axis, item) for item in items] or [(axis, "")])
+    return [{axis: value for axis, value in combo if value} for combo in itertools.product(*values)]
+
+
+def point_name(point: Dict[str, str]) -> str:
+    return "-".join(f"{axis}={value}" for axis, value in point.items()) or "captured"
+
+
+def replay_options(point: Dict[str, str], args: argparse.Namespace) -> List[str]:
+    options = ["--trace-dir", args.trace_dir]
+    for axis, option, _ in AXES:
+        if axis in point:
+            options += [option, point[axis]]
+    return options + args.replay_args.split()
+
+
+def stats_summary(stats_path: Path) -> Dict[str, Optional[float]]:
+    l2: List[Dict[str, float]] = []
+    gens: List[Dict[str, float]] = []
+    sim_ticks: Optional[float] = None
+    owner = ""
+    for line in last_stats_block(stats_path):
+        columns = line.split()
+        if len(columns) < 2:
+            continue
+        try:
+            value = float(columns[1])
+        except ValueError:
+            continue
+        if columns[0] == "simTicks":
+            sim_ticks = value
+            continue
+        for regex, items in ((L2_STAT_RE, l2), (GEN_STAT_RE, gens)):
+            match = regex.match(columns[0])
+            if match:
+                name = columns[0].split(".")[1]
+                if name != owner or not items:
+                    items.append({})
+                    owner = name
+                items[-1][match.group("stat")] = value
+
+    accesses = sum(item.get("overallAccesses", 0.0) for item in l2)
+
+    def weighted(key: str) -> Optional[float]:
+        if not accesses:
+            return None
+        return sum(item.get(key, 0.0) * item.get("overallAccesses", 0.0) for item in l2) / accesses
+
+    def mean(key: str) -> Optional[float]:
+        found = [item[key] for item in gens if key in item]
+        return sum(found) / len(found) if found else None
+
+    return {
+        "sim_ticks": sim_ticks,
+        "l2_accesses": accesses,
+        "l2_miss_rate": weighted("overallMissRate"),
+        "l2_avg_miss_latency": weighted("overallAvgMissLatency"),
+        "read_latency": mean("avgReadLatency"),
+        "write_latency": mean("avgWriteLatency"),
+    }
+
+
+def run_point(point: Dict[str, str], args: argparse.Namespace, out_root: Path, gem5_bin: str) -> Dict[str, object]:
+    name = point_name(point)
+    outdir = out_root / name
+    if args.dry_run:
+        cmd = [sys.executable, str(REPLAY_CONFIG), *replay_options(point, args), "--print-json"]
+    else:
+        cmd = [gem5_bin, f"--outdir={outdir}", str(REPLAY_CONFIG), *replay_options(point, args)]
+    print(f"[INFO] {name}: {' '.join(cmd)}")
+    result: Dict[str, object] = {"name": name, "point": point, "outdir": str(outdir), "command": cmd}
+    try:
+        proc = subprocess.run(cmd, cwd=REPO_ROOT, capture_output=True, text=True, timeout=args.timeout_sec)
+    except subprocess.TimeoutExpired:
+        return dict(result, returncode=124, error=f"timeout after {args.timeout_sec}s")
+    output = (proc.stderr or proc.stdout).strip().splitlines()
+    result.update(returncode=proc.returncode, error=output[-1] if proc.returncode != 0 and output else "")
+    if args.dry_run:
+        if proc.returncode == 0:
+            result["plan"] = json.loads(proc.stdout)
+        return result
+
+    stats_path = outdir / "stats.txt"
+    memory = memory_metrics(stats_path)
+    result.update(stats_summary(stats_path))
+    result.update(
+        mem_bw=memory["total_bw_bytes_per_sec"],
+        max_bus_util=memory["max_bus_util_pct"],
+        host_seconds=host_metrics(stats_path)["host_seconds"],
+    )
+    return result
+
+
+def _fmt(value: Optional[float], spec: str) -> str:
+    return format(value, spec) if value is not None else "-"
+
+
+def summarize(report: Dict[str, object]) -> str:
+    lines = [
+        f"# Memory trace replay sweep ({report['timestamp']})",
+        "",
+        f"trace: {report['trace_dir']} ({report['mode']}), ranked by {report['rank_by']}, "
+        f"capture host seconds: {_fmt(report['capture_host_seconds'], '.1f')}",
+        "",
+        "| point | sim ticks | L2 miss rate | L2 miss lat | read lat | mem GB/s | host s | vs capture |",
+        "|---|---:|---:|---:|---:|---:|---:|---:|",
+    ]
+    for run in report["ranking"]:
+        lines.append(
+            f"| {run['name']} | {_fmt(run.get('sim_ticks'), '.0f')} | {_fmt(run.get('l2_miss_rate'), '.4f')} "
+            f"| {_fmt(run.get('l2_avg_miss_latency'), '.0f')} | {_fmt(run.get('read_latency'), '.0f')} "
+            f"| {_fmt(run['mem_bw'] / 1e9 if run.get('mem_bw') is not None else None, '.2f')} "
+            f"| {_fmt(run.get('host_seconds'), '.1f')} | {_fmt(run.get('speedup_vs_capture'), '.1f')}x |"
+        )
+    if report["dry_run"]:
+        lines += ["", "Dry run, planned: " + ", ".join(run["name"] for run in report["runs"] if run["returncode"] == 0)]
+    failed = [run["name"] for run in report["runs"] if run["returncode"] != 0]
+    if failed:
+        lines += ["", "Failed: " + ", ".join(failed)]
+    return "\n".join(lines) + "\n"
+
+
+def main() -> int:
+    args = parser().parse_args()
+    ts = args.timestamp or utc_ts()
+    out_root = Path(args.out_root or REPO_ROOT / "build" / "mem-replay" / ts)
+    sidecar_path = Path(args.trace_dir) / "mem_trace.json"
+    if not sidecar_path.exists():
+        print(f"[ERROR] {sidecar_path} missing: capture with run_gem5.py --target riscv32_mixed --mem-trace ...",
+              file=sys.stderr)
+        return 1
+    mode = json.loads(sidecar_path.read_text(encoding="utf-8")).get("mode")
+    gem5_bin = args.gem5_bin or str(REPO_ROOT / GEM5_VARIANTS[args.gem5_variant])
+    if not args.dry_run and not Path(gem5_bin).exists():
+        print(f"[ERROR] gem5 binary not found: {gem5_bin}", file=sys.stderr)
+        return 1
+
+    points = grid(args)
+    with ThreadPoolExecutor(max_workers=max(1, args.jobs)) as pool:
+        runs = list(pool.map(lambda point: run_point(point, args, out_root, gem5_bin), points))
+
+    capture_host = host_metrics(Path(args.trace_dir) / "stats.txt")["host_seconds"]
+    for run in runs:
+        if capture_host and run.get("host_seconds"):
+            run["speedup_vs_capture"] = capture_host / run["host_seconds"]
+    rank_by = "sim_ticks" if mode == "elastic" else "read_latency"
+    ranking = sorted(
+        (run for run in runs if run["returncode"] == 0 and run.get(rank_by) is not None),
+        key=lambda run: run[rank_by],
+    )
+    report: Dict[str, object] = {
+        "timestamp": ts,
+        "dry_run": args.dry_run,
+        "trace_dir": args.trace_dir,
+        "mode": mode,
+        "gem5_bin": gem5_bin,
+        "out_root": str(out_root),
+        "points": len(points),
+        "rank_by": rank_by,
+        "capture_host_seconds": capture_host,
+        "ranking": [{k: v for k, v in run.items() if k not in ("command", "plan")} for run in ranking],
+        "runs": runs,
+    }
+
+    result_dir = Path(args.results_root) / ts
+    result_dir.mkdir(parents=True, exist_ok=True)
+    json_path = result_dir / "mem_replay_sweep.json"
+    md_path = result_dir / "summary_mem_replay_sweep.md"
+    json_path.write_text(json.dumps(report, indent=2) + "\n", encoding="utf-8")
+    md_path.write_text(summarize(report), encoding="utf-8")
+    print(summarize(report))
+    print(f"[OK] Report: {json_path}")
+
+    failed = [run for run in runs if run["returncode"] != 0]
+    for run in failed:
+        print(f"[ERROR] {run['name']}: {run['error']}", file=sys.stderr)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
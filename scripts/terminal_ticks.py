@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+"""Readers for tick-stamped console captures.
+
+Sources (all "<tick>, line" per complete console line):
+- <terminal>.ticks: OmxTickTerminal text stamps, "<tick>: <name>: <line>"
+- <terminal>.ticks.bin: OmxTickTerminal binary records (gem5_ext/omx/OmxTickTerminal.py)
+- terminal_ticks.log: gem5 `--debug-flags=Terminal` trace, same text layout
+  with every terminal interleaved
+
+`summarize` turns the stamps of a run's terminals into first-seen marker
+ticks, WORKLOAD START -> DONE deltas and heartbeat interval jitter;
+run_gem5.py stores it in the manifest as terminal_ticks.
+
+CLI: print the JSON summary for terminal logs, or `--dump` a .ticks.bin as text.
+"""
+
+import argparse
+import json
+import re
+import statistics
+import struct
+import sys
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Tuple
+
+TICKS_PER_SEC = 10**12
+TICK_LINE_RE = re.compile(r"^\s*(\d+): ([\w.\[\]]+): (.*)$")
+TICK_SIDECARS = (".ticks", ".ticks.bin")
+BIN_MAGIC = b"OMXT"
+BIN_VERSION = 1
+HEARTBEAT_RE = re.compile(r"heartbeat=(\d+)")
+
+
+def is_sidecar(path: Path) -> bool:
+    return path.name.endswith(TICK_SIDECARS)
+
+
+def read_tick_lines(path: Path, terminal: str = "") -> List[Tuple[int, str]]:
+    """(tick, line) pairs of a text stamp file, optionally one terminal only."""
+    lines: List[Tuple[int, str]] = []
+    if not path.exists():
+        return lines
+    for raw in path.read_text(encoding="utf-8", errors="ignore").splitlines():
+        match = TICK_LINE_RE.match(raw)
+        if match and (not terminal or match.group(2) == terminal):
+            lines.append((int(match.group(1)), match.group(3)))
+    return lines
+
+
+def read_bin(path: Path) -> Tuple[str, List[Tuple[int, str]]]:
+    """(terminal name, (tick, line) pairs) of a .ticks.bin; a truncated tail is dropped."""
+    data = path.read_bytes()
+    if data[:4] != BIN_MAGIC or len(data) < 12:
+        raise ValueError(f"{path}: not an OmxTickTerminal binary capture")
+    version, name_len = struct.unpack_from("<II", data, 4)
+    if version != BIN_VERSION:
+        raise ValueError(f"{path}: unsupported version {version}")
+    pos = 12 + name_len
+    name = data[12:pos].decode("utf-8", errors="replace")
+    lines: List[Tuple[int, str]] = []
+    while pos + 12 <= len(data):
+        tick, length = struct.unpack_from("<QI", data, pos)
+        if pos + 12 + length > len(data):
+            break
+        lines.append((tick, data[pos + 12 : pos + 12 + length].decode("utf-8", errors="replace")))
+        pos += 12 + length
+    return name, lines
+
+
+def read_terminal(terminal_log: Path) -> List[Tuple[int, str]]:
+    """Stamped lines of one terminal capture: <log>.ticks, else <log>.ticks.bin."""
+    text = terminal_log.with_name(terminal_log.name + ".ticks")
+    if text.exists():
+        return read_tick_lines(text)
+    binary = terminal_log.with_name(terminal_log.name + ".ticks.bin")
+    if binary.exists():
+        return read_bin(binary)[1]
+    return []
+
+
+def first_ticks(lines: Sequence[Tuple[int, str]], markers: Sequence[str]) -> Dict[str, Optional[int]]:
+    out: Dict[str, Optional[int]] = {marker: None for marker in markers}
+    for tick, text in lines:
+        for marker in markers:
+            if out[marker] is None and marker in text:
+                out[marker] = tick
+    return out
+
+
+def start_done_deltas(marker_ticks: Dict[str, Optional[int]]) -> Dict[str, Dict[str, Optional[int]]]:
+    """"<prefix> START" / "<prefix> DONE" marker pairs -> start, done and ticks."""
+    out: Dict[str, Dict[str, Optional[int]]] = {}
+    for marker, start in marker_ticks.items():
+        if not marker.endswith(" START"):
+            continue
+        prefix = marker[: -len(" START")]
+        done = marker_ticks.get(f"{prefix} DONE")
+        out[prefix] = {
+            "start": start,
+            "done": done,
+            "ticks": done - start if start is not None and done is not None and done >= start else None,
+        }
+    return out
+
+
+def heartbeat_jitter(lines: Sequence[Tuple[int, str]]) -> Optional[Dict[str, object]]:
+    """Spread of the tick gaps between consecutive heartbeat=<n> lines."""
+    ticks = [tick for tick, text in lines if HEARTBEAT_RE.search(text)]
+    gaps = [b - a for a, b in zip(ticks, ticks[1:])]
+    if not gaps:
+        return None
+    mean = statistics.mean(gaps)
+    return {
+        "count": len(ticks),
+        "mean_ticks": mean,
+        "min_ticks": min(gaps),
+        "max_ticks": max(gaps),
+        "stdev_ticks": statistics.pstdev(gaps),
+        "jitter_ticks": max(gaps) - min(gaps),
+    }
+
+
+def summarize(terminal_logs: Sequence[Path], markers: Sequence[str]) -> Dict[str, object]:
+    """Marker ticks, START/DONE deltas and heartbeat jitter over the stamped terminals."""
+    merged: List[Tuple[int, str]] = []
+    per_terminal: Dict[str, object] = {}
+    for log in terminal_logs:
+        lines = read_terminal(log)
+        if not lines:
+            continue
+        merged.extend(lines)
+        per_terminal[log.name] = {"lines": len(lines), "heartbeat": heartbeat_jitter(lines)}
+    if not merged:
+        return {"source": "none"}
+    merged.sort(key=lambda item: item[0])
+    ticks = first_ticks(merged, markers)
+    return {
+        "source": "tick_terminal",
+        "ticks_per_sec": TICKS_PER_SEC,
+        "terminals": per_terminal,
+        "marker_ticks": ticks,
+        "start_done": start_done_deltas(ticks),
+    }
+
+
+def main() -> int:
+    p = argparse.ArgumentParser(description="Summarize or dump OmxTickTerminal captures")
+    p.add_argument("paths", nargs="+", help="terminal capture files (the plain file next to its .ticks*)")
+    p.add_argument("--marker", action="append", default=[], help="marker to time (repeatable)")
+    p.add_argument("--dump", action="store_true", help="print a .ticks.bin as '<tick>: <name>: <line>'")
+    args = p.parse_args()
+    if args.dump:
+        for raw in args.paths:
+            name, lines = read_bin(Path(raw))
+            for tick, text in lines:
+                print(f"{tick}: {name}: {text}")
+        return 0
+    data = summarize([Path(raw) for raw in args.paths], args.marker)
+    print(json.dumps(data, indent=2))
+    if data["source"] == "none":
+        print("[ERROR] no .ticks/.ticks.bin next to the given terminal logs", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
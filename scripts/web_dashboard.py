@@ -26,6 +26,8 @@ from typing import Any, Deque, Dict, List, Optional
 
 from flask import Flask, Response, abort, jsonify, render_template, request
 
+from host_attribution import last_stats_block
+
 REPO_ROOT = Path(__file__).resolve().parents[1]
 RESULTS_ROOT = REPO_ROOT / "workloads" / "results"
 LOGS_ROOT = REPO_ROOT / "build" / "logs"
@@ -68,7 +70,7 @@ def parse_stats_file(path: Path) -> Dict[str, float]:
         "hostTickRate",
     }
     stats: Dict[str, float] = {}
-    for line in path.read_text(encoding="utf-8", errors="ignore").splitlines():
+    for line in last_stats_block(path):
         columns = line.split()
         if len(columns) < 2:
             continue
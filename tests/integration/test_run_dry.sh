@@ -12,8 +12,491 @@ python3 scripts/run_gem5.py --target riscv32_mixed --mode complex --timestamp "$
 python3 scripts/run_gem5.py --target riscv32_simple --mode simple --timestamp "${TS}" --dry-run
 python3 scripts/run_gem5.py --target riscv_hybrid --mode simple --timestamp "${TS}" --dry-run
 
+echo "[INFO] topology generator"
+python3 scripts/gen_topology.py --topology conf/topology/riscv32_mixed.json --out-dir build/topology/riscv32_mixed
+for f in conf/zephyr/cluster0_amp_cpu0 conf/zephyr/cluster0_amp_cpu1 conf/zephyr/cluster1_smp; do
+  for ext in overlay conf; do
+    if ! diff -u "${f}.${ext}" "build/topology/riscv32_mixed/zephyr/$(basename "${f}").${ext}"; then
+      echo "[FAIL] ${f}.${ext} differs from scripts/gen_topology.py output"
+      exit 1
+    fi
+  done
+done
+python3 scripts/gen_topology.py --topology conf/topology/riscv32_2x8.json
+python3 conf/riscv32_mixed.py --print-json \
+  | python3 scripts/gen_topology.py --plan-json - --out-dir build/topology/riscv32_mixed_plan
+if ! diff -u <(grep -v '^/\* Generated' build/topology/riscv32_mixed/riscv32_mixed_boot_table.h) \
+  <(grep -v '^/\* Generated' build/topology/riscv32_mixed_plan/riscv32_mixed_boot_table.h); then
+  echo "[FAIL] boot table from the platform plan differs from scripts/gen_topology.py output"
+  exit 1
+fi
+python3 - conf/topology/riscv32_mixed.json build/topology/dvfs_moved.json <<'EOF2'
+import json
+import sys
+
+desc = json.load(open(sys.argv[1]))
+desc["name"] = "dvfs_moved"
+desc["memory"]["dvfs_ctrl"] = {"base": "0x10005000"}
+json.dump(desc, open(sys.argv[2], "w"))
+EOF2
+python3 scripts/gen_topology.py --topology build/topology/dvfs_moved.json
+DVFS_PLAN="$(python3 conf/riscv32_mixed.py --print-json --dvfs --topology build/topology/dvfs_moved.json)"
+if ! grep -q 'omx-dvfs-base = <0x10005000>' build/topology/dvfs_moved/zephyr/cluster1_smp.overlay \
+  || ! grep -q '"ctrl_base": "0x10005000"' <<<"${DVFS_PLAN}"; then
+  echo "[FAIL] memory.dvfs_ctrl.base should reach both the overlays and the riscv32_mixed plan"
+  exit 1
+fi
+python3 scripts/gen_topology.py --topology conf/topology/riscv32_mixed_staggered.json
+if ! grep -q '0x00000002, 0x000186a0 /\* hart 1: cluster0_amp_cpu1 \*/' \
+  build/topology/riscv32_mixed_staggered/riscv32_mixed_boot_table.h; then
+  echo "[FAIL] staggered release missing from the riscv32_mixed_staggered boot table"
+  exit 1
+fi
+python3 scripts/run_gem5.py --target riscv32_mixed --mode simple --topology conf/topology/riscv32_4x4.json \
+  --results-root build/topology/results --log-root build/topology/logs --dry-run
+if python3 conf/riscv32_mixed.py --print-json --memory-system ruby-mesi --l2-cluster0-size 128kB >/dev/null 2>&1; then
+  echo "[FAIL] riscv32_mixed.py: Ruby has no per-cluster L2 size, --l2-cluster0-size should be rejected"
+  exit 1
+fi
+
+echo "[INFO] build graph"
+python3 scripts/build_all.py --dry-run
+python3 scripts/build_all.py --dry-run --topology conf/topology/riscv32_4x4.json --targets boot
+
+echo "[INFO] gem5 variants"
+scripts/build_gem5.sh --variant all --dry-run
+python3 scripts/bench_gem5_variants.py --timestamp "${TS}" --dry-run
+
+echo "[INFO] benchmark initramfs"
+python3 scripts/build_bench_initramfs.py --dry-run
+python3 scripts/build_bench_initramfs.py --config conf/initramfs/bench_scaling.json --dry-run
+python3 scripts/bench_linux_scaling.py --timestamp "${TS}" --dry-run
+
+echo "[INFO] boot timeline"
+python3 scripts/run_gem5.py --target riscv64_smp --mode simple --boot-timing \
+  --results-root build/boot-timeline-test/results --log-root build/boot-timeline-test/logs --dry-run
+BOOT_LOGS="build/boot-timeline-test/trace"
+mkdir -p "${BOOT_LOGS}"
+cat > "${BOOT_LOGS}/terminal_ticks.log" <<'EOF2'
+   2000000: system.platform.terminal: OpenSBI v1.3
+  40000000: system.platform.terminal: [    0.000000] Linux version 6.6.0
+  60000000: system.platform.terminal: [    0.020000] calling  slow_init+0x0/0x22 @ 1
+  90000000: system.platform.terminal: [    0.050000] initcall slow_init+0x0/0x22 returned 0 after 30000 usecs
+ 120000000: system.platform.terminal: [    0.080000] Run /init as init process
+ 150000000: system.platform.terminal: INITRAMFS_SHELL_READY
+EOF2
+python3 scripts/boot_timeline.py "${BOOT_LOGS}"
+if ! grep -q '"boot_time_sec": 0.00015' "${BOOT_LOGS}/boot_timeline.json"; then
+  echo "[FAIL] boot_timeline.py: unexpected boot_time_sec"
+  exit 1
+fi
+
+echo "[INFO] tick-stamped terminal capture"
+python3 scripts/run_gem5.py --target riscv32_mixed --tick-terminal binary \
+  --results-root build/tick-terminal-test/results --log-root build/tick-terminal-test/logs --dry-run
+TICK_LOGS="build/tick-terminal-test/capture"
+mkdir -p "${TICK_LOGS}"
+: > "${TICK_LOGS}/system.platform.terminal1"
+python3 - "${TICK_LOGS}/system.platform.terminal1.ticks.bin" <<'EOF2'
+import struct
+import sys
+
+name = b"system.platform.terminal1"
+lines = [
+    (1000, "RISCV32 MIXED AMP CPU1 WORKLOAD START"),
+    (5000, "heartbeat=0 total=1 role=AMP CPU1"),
+    (9000, "heartbeat=5 total=6 role=AMP CPU1"),
+    (14000, "heartbeat=10 total=11 role=AMP CPU1"),
+    (21000, "RISCV32 MIXED AMP CPU1 WORKLOAD DONE"),
+]
+out = b"OMXT" + struct.pack("<II", 1, len(name)) + name
+for tick, text in lines:
+    out += struct.pack("<QI", tick, len(text)) + text.encode()
+open(sys.argv[1], "wb").write(out)
+EOF2
+python3 scripts/terminal_ticks.py "${TICK_LOGS}/system.platform.terminal1" \
+  --marker "RISCV32 MIXED AMP CPU1 WORKLOAD START" --marker "RISCV32 MIXED AMP CPU1 WORKLOAD DONE" \
+  > "${TICK_LOGS}/terminal_ticks.json"
+python3 - "${TICK_LOGS}/terminal_ticks.json" <<'EOF2'
+import json
+import sys
+
+data = json.load(open(sys.argv[1]))
+assert data["start_done"]["RISCV32 MIXED AMP CPU1 WORKLOAD"]["ticks"] == 20000, data
+assert data["terminals"]["system.platform.terminal1"]["heartbeat"]["jitter_ticks"] == 1000, data
+EOF2
+python3 scripts/terminal_ticks.py --dump "${TICK_LOGS}/system.platform.terminal1.ticks.bin" \
+  | grep -q '^21000: system.platform.terminal1: RISCV32 MIXED AMP CPU1 WORKLOAD DONE$'
+
+echo "[INFO] block I/O benchmark"
+python3 scripts/build_blk_image.py --size-mb 1 --out build/blk-test/blkbench.img
+python3 scripts/build_bench_initramfs.py --config conf/initramfs/bench_blkio.json --dry-run
+python3 scripts/run_gem5.py --target riscv64_smp --mode complex --blk-bench \
+  --disk-image build/blk-test/blkbench.img --blk-latency 80us --blk-bandwidth 500MB/s \
+  --results-root build/blk-test/results --log-root build/blk-test/logs --dry-run
+BLK_PLAN="$(python3 conf/riscv64_smp.py --print-json --disk-image build/blk-test/blkbench.img --blk-latency 80us)"
+if ! grep -q '"device": "OmxVirtIOBlock"' <<<"${BLK_PLAN}"; then
+  echo "[FAIL] riscv64_smp.py: --blk-latency should select OmxVirtIOBlock"
+  exit 1
+fi
+
+echo "[INFO] hybrid shared window"
+python3 scripts/build_bench_initramfs.py --config conf/initramfs/bench_hybrid_shm.json --dry-run
+python3 scripts/run_gem5.py --target riscv_hybrid --mode complex --hybrid-shm \
+  --results-root build/hshm-test/results --log-root build/hshm-test/logs --dry-run
+HSHM_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/hshm-test/results/*/run_gem5_riscv_hybrid_complex.json)"
+if ! grep -q -- "--rv64-cpu-type timing" <<<"${HSHM_CMD}"; then
+  echo "[FAIL] run_gem5.py: --hybrid-shm should run the rv64 side in timing mode"
+  exit 1
+fi
+if python3 conf/riscv_hybrid.py --print-json --hybrid-shm --rv64-cpu-type atomic >/dev/null 2>&1; then
+  echo "[FAIL] riscv_hybrid.py: --hybrid-shm should reject an atomic rv64 CPU model"
+  exit 1
+fi
+HSHM_PLAN="$(python3 conf/riscv_hybrid.py --print-json --hybrid-shm --rv64-cpu-type timing)"
+if ! grep -q '"uio_name": "omx-hybrid-shm"' <<<"${HSHM_PLAN}"; then
+  echo "[FAIL] riscv_hybrid.py: --hybrid-shm should plan the omx-hybrid-shm UIO window"
+  exit 1
+fi
+if ! grep -q 'omx-hybrid-shm-base' conf/zephyr/cluster0_amp_cpu1.overlay; then
+  echo "[FAIL] cluster0_amp_cpu1.overlay: missing the hybrid shared window"
+  exit 1
+fi
+
+echo "[INFO] hybrid host-time attribution"
+python3 scripts/run_gem5.py --target riscv_hybrid --mode complex --hybrid-cpu-types timing,o3 \
+  --host-attribution-period 1000000000 \
+  --results-root build/attribution-test/results --log-root build/attribution-test/logs --dry-run
+ATTR_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/attribution-test/results/*/run_gem5_riscv_hybrid_complex.json)"
+if ! grep -q -- "--rv64-cpu-type o3 .*--host-attribution-period 1000000000" <<<"${ATTR_CMD}"; then
+  echo "[FAIL] run_gem5.py: --hybrid-cpu-types/--host-attribution-period not passed to riscv_hybrid.py"
+  exit 1
+fi
+python3 - build/attribution-test/stats.txt <<'EOF2'
+import sys
+
+# Cumulative dumps; each slice costs 0.1 s + 20 ns per rv32 inst + 5 ns per rv64 inst.
+out, host, i32, i64 = [], 0.0, 0, 0
+for d32, d64 in [(4e7, 1e7), (3e7, 9e7), (1e3, 2e8), (1e3, 5e7), (2e7, 1.5e8)]:
+    host += 0.1 + 20e-9 * d32 + 5e-9 * d64
+    i32, i64 = i32 + int(d32), i64 + int(d64)
+    out += [
+        "---------- Begin Simulation Statistics ----------",
+        f"hostSeconds {host:.6f}",
+        f"system32.cpu0.commitStats0.numInsts {i32}",
+        f"system64.cpu0.commitStats0.numInsts {i64}",
+        "---------- End Simulation Statistics   ----------",
+    ]
+open(sys.argv[1], "w").write("\n".join(out) + "\n")
+EOF2
+python3 scripts/host_attribution.py build/attribution-test/stats.txt > build/attribution-test/host_attribution.json
+python3 - build/attribution-test/host_attribution.json <<'EOF2'
+import json
+import sys
+
+data = json.load(open(sys.argv[1]))
+assert data["method"] == "nnls" and data["slices"] == 5, data
+assert abs(data["systems"]["system32"]["host_ns_per_inst"] - 20.0) < 0.1, data
+assert abs(data["systems"]["system64"]["host_ns_per_inst"] - 5.0) < 0.1, data
+EOF2
+
+echo "[INFO] memory trace capture and replay"
+python3 scripts/run_gem5.py --target riscv32_mixed --mode complex --mem-trace packet \
+  --results-root build/mem-trace-test/results --log-root build/mem-trace-test/logs --dry-run
+TRACE_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/mem-trace-test/results/*/run_gem5_riscv32_mixed_complex.json)"
+if ! grep -q -- "--mem-trace packet" <<<"${TRACE_CMD}"; then
+  echo "[FAIL] run_gem5.py: --mem-trace not passed to riscv32_mixed.py"
+  exit 1
+fi
+mkdir -p build/mem-trace-test/capture
+python3 - build/mem-trace-test/capture <<'EOF2'
+import json
+import sys
+from pathlib import Path
+
+out = Path(sys.argv[1])
+for idx in (0, 1):
+    (out / f"cluster{idx}_l1l2.trc.gz").write_bytes(b"")
+sidecar = {
+    "kind": "omx-mem-trace",
+    "mode": "packet",
+    "source": "riscv32_mixed",
+    "topology": "riscv32_mixed",
+    "sim_ticks": 1000000,
+    "memory_ranges": [{"name": "boot", "base": 0x80000000, "size": 0x1000000}],
+    "capture": {
+        "l1i_size": "16kB",
+        "l1d_size": "16kB",
+        "l1_assoc": 2,
+        "l2_assoc": 8,
+        "memory": {"type": "simple", "gem5_class": "SimpleMemory", "channels": 1, "intlv_size": 64},
+        "o3": {},
+    },
+    "clusters": [
+        {"index": idx, "name": f"cluster{idx}", "harts": [idx], "cpu_model": "timing", "l2_size": "256kB",
+         "packet_trace": f"cluster{idx}_l1l2.trc.gz"}
+        for idx in (0, 1)
+    ],
+    "harts": [],
+}
+(out / "mem_trace.json").write_text(json.dumps(sidecar), encoding="utf-8")
+EOF2
+REPLAY_PLAN="$(python3 conf/mem_replay.py --trace-dir build/mem-trace-test/capture --l2-size 1MB --mem-type ddr4 --print-json)"
+if ! grep -q '"size": "1MB"' <<<"${REPLAY_PLAN}" || ! grep -q '"missing_traces": \[\]' <<<"${REPLAY_PLAN}"; then
+  echo "[FAIL] mem_replay.py: candidate L2 or capture traces not planned"
+  exit 1
+fi
+python3 scripts/sweep_mem_replay.py --trace-dir build/mem-trace-test/capture --l2-sizes 256kB,1MB \
+  --mem-types simple,ddr4 --results-root build/mem-trace-test/results --timestamp sweep --dry-run
+python3 - build/mem-trace-test/results/sweep/mem_replay_sweep.json <<'EOF2'
+import json
+import sys
+
+data = json.load(open(sys.argv[1]))
+assert data["points"] == 4 and all(run["returncode"] == 0 for run in data["runs"]), data
+EOF2
+
+echo "[INFO] synthetic traffic target"
+python3 scripts/run_gem5.py --target traffic_mixed --traffic-patterns linear,dram --traffic-read-pct 100,70 \
+  --mem-type ddr4 --results-root build/traffic-test/results --log-root build/traffic-test/logs --dry-run
+TRAFFIC_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/traffic-test/results/*/run_gem5_traffic_mixed_simple.json)"
+if ! grep -q -- "conf/traffic_mixed.py --patterns linear,dram --read-pct 100,70" <<<"${TRAFFIC_CMD}"; then
+  echo "[FAIL] run_gem5.py: traffic options not passed to traffic_mixed.py"
+  exit 1
+fi
+python3 conf/traffic_mixed.py --print-json --targets shared --patterns random,idle > build/traffic-test/plan.json
+python3 - build/traffic-test/plan.json <<'EOF2'
+import json
+import sys
+
+plan = json.load(open(sys.argv[1]))
+gens = plan["generators"]
+assert len(gens) == 6 and plan["clusters"][1]["l2"]["size"] == "512kB", plan
+active = [gen for gen in gens if gen["pattern"] == "random"]
+assert len(active) == 2 and all(gen["segment"] == "shared" for gen in active), gens
+assert active[0]["max_addr"] <= active[1]["min_addr"], gens
+EOF2
+if python3 conf/traffic_mixed.py --print-json --patterns dram >/dev/null 2>&1; then
+  echo "[FAIL] traffic_mixed.py: dram pattern accepted with --mem-type simple"
+  exit 1
+fi
+
+echo "[INFO] periodic stats time series"
+python3 scripts/run_gem5.py --target traffic_mixed --stats-period 10000000 \
+  --results-root build/series-test/results --log-root build/series-test/logs --dry-run
+SERIES_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/series-test/results/*/run_gem5_traffic_mixed_simple.json)"
+if ! grep -q -- "--stats-period 10000000" <<<"${SERIES_CMD}"; then
+  echo "[FAIL] run_gem5.py: --stats-period not passed to traffic_mixed.py"
+  exit 1
+fi
+SERIES_PLAN="$(python3 conf/riscv32_mixed.py --print-json --stats-period 10000000)"
+if ! grep -q '"stats_period": 10000000' <<<"${SERIES_PLAN}"; then
+  echo "[FAIL] riscv32_mixed.py: --stats-period missing from the plan"
+  exit 1
+fi
+python3 - build/series-test/stats.txt <<'EOF2'
+import sys
+
+# Cumulative dumps every 1000 ticks: a busy boot, an idle stretch, then a memory-bound phase.
+out, insts, misses = [], 0, 0
+for i, (d_insts, d_misses) in enumerate([(900, 1), (1000, 2), (950, 1), (0, 0), (10, 0), (0, 0), (400, 40), (420, 42)]):
+    insts, misses = insts + d_insts, misses + d_misses
+    out += [
+        "---------- Begin Simulation Statistics ----------",
+        f"finalTick {1000 * (i + 1)}",
+        f"system.cpu0.commitStats0.numInsts {insts}",
+        f"system.cpu0.numCycles {1000 * (i + 1)}",
+        f"system.cpu0.dcache.overallMisses::total {misses}",
+        f"system.membus.reqLayer0.occupancy {100 * (i + 1)}",
+        "---------- End Simulation Statistics   ----------",
+    ]
+open(sys.argv[1], "w").write("\n".join(out) + "\n")
+EOF2
+python3 scripts/stats_series.py build/series-test/stats.txt > build/series-test/phases.json
+python3 - build/series-test/phases.json build/series-test/stats_series.json <<'EOF2'
+import json
+import sys
+
+data = json.load(open(sys.argv[1]))
+phases = data["phases"]["system"]
+assert [phase["level"] for phase in phases] == ["high", "idle", "low"], phases
+assert phases[1]["start_tick"] == 3000 and phases[1]["end_tick"] == 6000, phases
+assert phases[2]["mpki"] == 100.0 and phases[2]["bus_utilization"] == 0.1, phases
+series = json.load(open(sys.argv[2]))
+assert series["intervals"] == 8 and series["columns"]["insts.system.cpu0"][6] == 400, series
+EOF2
+mkdir -p build/series-test/blk
+python3 - build/series-test/blk <<'EOF2'
+import sys
+from pathlib import Path
+
+sys.path.insert(0, "scripts")
+from run_gem5 import blk_metrics
+
+# Guest resets before each benchmark and dumps after it; periodic dumps at 1000/3000 sit in between.
+# The second benchmark passes its pre-reset count before a periodic dump, so no counter goes down.
+out = Path(sys.argv[1])
+dumps = [(1000, 2), (2000, 5), (3000, 6), (4000, 8)]
+text = []
+for tick, reqs in dumps:
+    text += [
+        "---------- Begin Simulation Statistics ----------",
+        f"finalTick {tick}",
+        f"system.platform.disk.vio.readReqs {reqs}",
+        "---------- End Simulation Statistics   ----------",
+    ]
+(out / "stats.txt").write_text("\n".join(text) + "\n")
+(out / "periodic_dumps.txt").write_text("1000\n3000\n")
+assert blk_metrics(out / "stats.txt")["readReqs"] == 13, blk_metrics(out / "stats.txt")
+EOF2
+python3 - build/series-test/blk/pf_stats.txt <<'EOF2'
+import sys
+from pathlib import Path
+
+sys.path.insert(0, "scripts")
+from run_gem5 import prefetch_metrics
+
+# Two prefetching caches; the membus line has no prefetcher and stays out of coverage.
+Path(sys.argv[1]).write_text(
+    "\n".join([
+        "system.cpu0.dcache.prefetcher.pfIssued 100",
+        "system.cpu0.dcache.prefetcher.pfUseful 60",
+        "system.cpu0.dcache.demandMshrMisses::total 40",
+        "system.l2.prefetcher.pfIssued 100",
+        "system.l2.prefetcher.pfUseful 20",
+        "system.l2.demandMshrMisses::total 80",
+        "system.l3.demandMshrMisses::total 1000",
+    ]) + "\n"
+)
+metrics = prefetch_metrics(Path(sys.argv[1]))
+assert metrics["accuracy"] == 0.4 and metrics["coverage"] == 0.4, metrics
+assert metrics["per_cache"]["system.l2"]["demandMshrMisses"] == 80, metrics
+EOF2
+
+echo "[INFO] stats subset selection"
+python3 scripts/run_gem5.py --target riscv32_mixed --mode complex --stats-period 10000000 --stats-profile series \
+  --stats-exclude '*Layer*.occupancy' --stats-format json \
+  --results-root build/stats-subset-test/results --log-root build/stats-subset-test/logs --dry-run
+SUBSET_CMD="$(python3 -c 'import json, sys; print(" ".join(json.load(open(sys.argv[1]))["commands"][0]))' \
+  build/stats-subset-test/results/*/run_gem5_riscv32_mixed_complex.json)"
+if ! grep -q -- "--stats-profile series --stats-exclude \*Layer\*.occupancy --stats-format json" \
+  <<<"${SUBSET_CMD}"; then
+  echo "[FAIL] run_gem5.py: --stats-profile/--stats-exclude/--stats-format not passed to riscv32_mixed.py"
+  exit 1
+fi
+python3 conf/traffic_mixed.py --print-json --stats-profile minimal --stats-include 'system.membus.*' \
+  > build/stats-subset-test/plan.json
+python3 - build/stats-subset-test/plan.json <<'EOF2'
+import json
+import sys
+
+stats = json.load(open(sys.argv[1]))["stats"]
+assert stats["profile"] == "minimal" and stats["format"] == "text", stats
+assert "simInsts" not in stats["include"] and "sim*" in stats["include"], stats
+assert "system.tgen*.bytesRead" in stats["include"] and stats["include"][-1] == "system.membus.*", stats
+EOF2
+python3 conf/riscv32_mixed.py --print-json --stats-profile minimal --shared-llc --dvfs \
+  > build/stats-subset-test/mixed_plan.json
+python3 - build/stats-subset-test/mixed_plan.json <<'EOF2'
+import json
+import sys
+
+sys.path.insert(0, "scripts")
+from run_gem5 import memory_metrics, unless_filtered
+from pathlib import Path
+
+stats = json.load(open(sys.argv[1]))["stats"]
+assert "system.llc.overall*" in stats["include"] and "system.platform.dvfs_ctrl.*" in stats["include"], stats
+# Nothing parsed under a reduced profile: marked filtered, not reported as zero controllers.
+manifest = {"stats_selection": {"profile": "minimal"}}
+assert unless_filtered(manifest, memory_metrics(Path("missing/stats.txt"))) == {
+    "filtered": True,
+    "stats_profile": "minimal",
+}
+assert "per_ctrl" in unless_filtered({"stats_selection": None}, memory_metrics(Path("missing/stats.txt")))
+EOF2
+mkdir -p build/stats-subset-test/json
+: > build/stats-subset-test/json/stats.txt
+python3 - build/stats-subset-test/json/stats.jsonl <<'EOF2'
+import json
+import sys
+
+# --stats-format json: one line per cumulative dump, stats.txt left empty.
+with open(sys.argv[1], "w") as fp:
+    for i, insts in enumerate([1000, 2000, 2010, 2020]):
+        stats = {"finalTick": 1000 * (i + 1), "hostSeconds": 0.1 * (i + 1), "system.cpu0.committedInsts": insts}
+        fp.write(json.dumps({"tick": 1000 * (i + 1), "stats": stats}, separators=(",", ":")) + "\n")
+EOF2
+python3 scripts/stats_series.py build/stats-subset-test/json/stats.txt > build/stats-subset-test/json/phases.json
+python3 - build/stats-subset-test/json/phases.json <<'EOF2'
+import json
+import sys
+
+data = json.load(open(sys.argv[1]))
+assert data["intervals"] == 4, data
+assert [phase["level"] for phase in data["phases"]["system"]] == ["high", "idle"], data
+EOF2
+python3 - build/stats-subset-test/json <<'EOF2'
+import argparse
+import json
+import sys
+import types
+
+sys.path.insert(0, "conf")
+from omx_gem5 import add_stats_profile_arguments, apply_stats_profile, stats_profile_plan
+
+
+# Just enough of m5/_m5.stats for apply_stats_profile: a legacy global in stats_list,
+# one group under Root, and m5.stats.dump() passing roots=[] as upstream does.
+class ScalarInfo:
+    def __init__(self, name, value):
+        self.name, self.value = name, value
+
+
+class Group:
+    def __init__(self, stats, groups):
+        self.stats, self.groups = stats, groups
+
+    def getStats(self):  # noqa: N802
+        return self.stats
+
+    def getStatGroups(self):  # noqa: N802
+        return self.groups
+
+    def path_list(self):
+        return []
+
+
+root = Group([ScalarInfo("simTicks", 5)], {"system": Group([ScalarInfo("l2.overallMisses", 3)], {})})
+m5_stats = types.SimpleNamespace(stats_list=[ScalarInfo("simInsts", 42)], outputList=[], enable=lambda: None)
+m5_stats._dump_to_visitor = None
+m5_stats.dump = lambda: [
+    (out.begin(), m5_stats._dump_to_visitor(out, roots=[]), out.end()) for out in m5_stats.outputList
+]
+m5, _m5 = types.ModuleType("m5"), types.ModuleType("_m5")
+m5.stats, m5.curTick = m5_stats, lambda: 5
+m5.objects = types.SimpleNamespace(Root=types.SimpleNamespace(getInstance=lambda: root))
+_m5.stats = types.SimpleNamespace(ScalarInfo=ScalarInfo, DistInfo=(), VectorInfo=(), FormulaInfo=(), Vector2dInfo=())
+sys.modules.update({"m5": m5, "m5.stats": m5.stats, "m5.objects": m5.objects, "_m5": _m5, "_m5.stats": _m5.stats})
+
+p = argparse.ArgumentParser()
+add_stats_profile_arguments(p)
+args = p.parse_args(["--stats-profile", "minimal", "--stats-format", "json"])
+apply_stats_profile(stats_profile_plan(args), sys.argv[1])
+m5_stats.enable()
+m5_stats.dump()
+stats = json.loads(open(f"{sys.argv[1]}/stats.jsonl").read())["stats"]
+assert stats == {"simInsts": 42, "simTicks": 5}, stats
+EOF2
+
 echo "[INFO] dry-run benchmark wrapper"
 scripts/run_bench.sh --target riscv64_smp --mode simple --timestamp "${TS}" --dry-run
+scripts/run_bench.sh --target riscv64_smp --mode complex --timestamp "${TS}" --dry-run
 scripts/run_bench.sh --target riscv32_mixed --mode complex --timestamp "${TS}" --dry-run --ipc-case mailbox_pingpong
 scripts/run_bench.sh --target riscv32_simple --mode simple --timestamp "${TS}" --dry-run
 
@@ -62,12 +545,42 @@ assert_file "workloads/results/${TS}/run_gem5_riscv32_mixed_complex.json"
 assert_file "workloads/results/${TS}/run_gem5_riscv32_simple_simple.json"
 assert_file "workloads/results/${TS}/run_gem5_riscv_hybrid_simple.json"
 assert_file "workloads/results/${TS}/bench_riscv64_smp_simple.json"
+assert_file "workloads/results/${TS}/bench_riscv64_smp_complex.json"
+assert_file "workloads/results/${TS}/linux_scaling.json"
+assert_file "workloads/results/${TS}/summary_linux_scaling.md"
 assert_file "workloads/results/${TS}/bench_riscv32_mixed_complex.json"
 assert_file "workloads/results/${TS}/bench_riscv32_simple_simple.json"
 assert_file "workloads/results/${TS}/summary_riscv64_smp_simple.md"
 assert_file "workloads/results/${TS}/summary_riscv32_mixed_complex.md"
 assert_file "workloads/results/${TS}/summary_riscv32_simple_simple.md"
 
+assert_file "workloads/results/${TS}/gem5_variants.json"
+assert_file "workloads/results/${TS}/summary_gem5_variants.md"
+assert_file "build/gem5-bench/${TS}/pgo/riscv64_smp/results/${TS}/run_gem5_riscv64_smp_simple.json"
+
+assert_file "build/topology/riscv32_mixed/riscv32_mixed_boot_table.h"
+assert_file "build/boot-timeline-test/trace/boot_timeline.svg"
+assert_file "build/boot-timeline-test/trace/boot_timeline.md"
+assert_file "build/tick-terminal-test/capture/terminal_ticks.json"
+assert_file "build/blk-test/blkbench.img.json"
+assert_file "build/topology/riscv32_2x8/zephyr/cluster1_smp.overlay"
+assert_file "build/topology/riscv32_4x4/memory_map.json"
+
+echo "[INFO] artifact cache round trip"
+CACHE_TEST="build/artifact-cache-test"
+mkdir -p "${CACHE_TEST}/out/zephyr"
+echo "fake elf" > "${CACHE_TEST}/out/zephyr/zephyr.elf"
+cache_args=(zephyr --target cluster1_smp --overlay conf/zephyr/cluster1_smp.overlay --out-dir "${CACHE_TEST}/out")
+python3 scripts/artifact_cache.py --store "${CACHE_TEST}/store" store "${cache_args[@]}"
+rm -rf "${CACHE_TEST}/out"
+python3 scripts/artifact_cache.py --store "${CACHE_TEST}/store" restore "${cache_args[@]}"
+assert_file "${CACHE_TEST}/out/zephyr/zephyr.elf"
+if python3 scripts/artifact_cache.py --store "${CACHE_TEST}/store" restore zephyr --target cluster0_amp_cpu0 \
+  --out-dir "${CACHE_TEST}/miss"; then
+  echo "[FAIL] artifact cache hit for a key that was never stored"
+  exit 1
+fi
+
 assert_link_target "workloads/results/latest" "${TS}"
 assert_link_target "workloads/results/latest-riscv64_smp-simple" "${TS}"
 assert_link_target "workloads/results/latest-riscv32_mixed-complex" "${TS}"
@@ -9,6 +9,18 @@ required_files=(
   conf/riscv32_mixed.py
   conf/riscv32_simple.py
   conf/riscv_hybrid.py
+  conf/mem_replay.py
+  conf/traffic_mixed.py
+  conf/omx_gem5.py
+  conf/omx_topology.py
+  conf/topology/riscv32_mixed.json
+  conf/topology/riscv32_2x8.json
+  conf/topology/riscv32_4x4.json
+  conf/topology/riscv32_mixed_staggered.json
+  conf/initramfs/bench_default.json
+  conf/initramfs/bench_scaling.json
+  conf/initramfs/bench_blkio.json
+  conf/initramfs/bench_hybrid_shm.json
   conf/submodules.lock.json
   conf/ip/mailbox_hwsem_map.yaml
   conf/zephyr/cluster0_amp_cpu0.conf
@@ -17,7 +29,18 @@ required_files=(
   conf/zephyr/cluster0_amp_cpu1.overlay
   conf/zephyr/cluster1_smp.conf
   conf/zephyr/cluster1_smp.overlay
+  conf/zephyr/hybrid_shm.conf
   conf/zephyr/riscv32_simple.overlay
+  gem5_ext/omx/SConscript
+  gem5_ext/omx/OmxDvfsCtrl.py
+  gem5_ext/omx/dvfs_ctrl.hh
+  gem5_ext/omx/dvfs_ctrl.cc
+  gem5_ext/omx/OmxTickTerminal.py
+  gem5_ext/omx/tick_terminal.hh
+  gem5_ext/omx/tick_terminal.cc
+  gem5_ext/omx/OmxVirtIOBlock.py
+  gem5_ext/omx/virtio_block.hh
+  gem5_ext/omx/virtio_block.cc
   docs/ip-implementation-plan.md
   docs/web-dashboard.md
   docs/acceptance.md
@@ -30,6 +53,18 @@ required_files=(
   workloads/zephyr/riscv32_simple/CMakeLists.txt
   workloads/zephyr/riscv32_simple/prj.conf
   workloads/zephyr/riscv32_simple/src/main.c
+  workloads/linux/bench_initramfs/src/omx_bench.h
+  workloads/linux/bench_initramfs/src/init.c
+  workloads/linux/bench_initramfs/src/membw.c
+  workloads/linux/bench_initramfs/src/ptrchase.c
+  workloads/linux/bench_initramfs/src/futex.c
+  workloads/linux/bench_initramfs/src/ctxsw.c
+  workloads/linux/bench_initramfs/src/spin.c
+  workloads/linux/bench_initramfs/src/pipe.c
+  workloads/linux/bench_initramfs/src/forkexec.c
+  workloads/linux/bench_initramfs/src/blkio.c
+  workloads/linux/bench_initramfs/src/hshm.c
+  workloads/ipc/omx_shm_ring.h
   scripts/bootstrap_sources.sh
   scripts/env.sh
   scripts/build_linux.sh
@@ -37,8 +72,21 @@ required_files=(
   scripts/build_linux_buildroot.sh
   scripts/build_riscv32_mixed_boot.sh
   scripts/build_zephyr.sh
+  scripts/build_gem5.sh
   scripts/riscv32_mixed_boot.S
   scripts/riscv32_mixed_boot.ld
+  scripts/gen_topology.py
+  scripts/build_all.py
+  scripts/artifact_cache.py
+  scripts/bench_gem5_variants.py
+  scripts/bench_linux_scaling.py
+  scripts/boot_timeline.py
+  scripts/terminal_ticks.py
+  scripts/build_bench_initramfs.py
+  scripts/build_blk_image.py
+  scripts/host_attribution.py
+  scripts/sweep_mem_replay.py
+  scripts/stats_series.py
   scripts/run_gem5.py
   scripts/run_bench.sh
   scripts/web_dashboard.py
@@ -56,6 +104,19 @@ required_exec=(
   scripts/build_linux_buildroot.sh
   scripts/build_riscv32_mixed_boot.sh
   scripts/build_zephyr.sh
+  scripts/build_gem5.sh
+  scripts/gen_topology.py
+  scripts/build_all.py
+  scripts/artifact_cache.py
+  scripts/bench_gem5_variants.py
+  scripts/bench_linux_scaling.py
+  scripts/boot_timeline.py
+  scripts/terminal_ticks.py
+  scripts/build_bench_initramfs.py
+  scripts/build_blk_image.py
+  scripts/host_attribution.py
+  scripts/sweep_mem_replay.py
+  scripts/stats_series.py
   scripts/run_bench.sh
   scripts/run_web_dashboard.sh
 )
@@ -11,6 +11,7 @@ bash -n scripts/build_linux.sh
 bash -n scripts/build_buildroot.sh
 bash -n scripts/build_linux_buildroot.sh
 bash -n scripts/build_zephyr.sh
+bash -n scripts/build_gem5.sh
 bash -n scripts/run_bench.sh
 bash -n scripts/run_web_dashboard.sh
 bash -n tests/smoke/test_layout.sh
@@ -22,6 +23,25 @@ python3 -m py_compile \
   conf/riscv64_smp.py \
   conf/riscv32_mixed.py \
   conf/riscv_hybrid.py \
+  conf/mem_replay.py \
+  conf/traffic_mixed.py \
+  conf/omx_gem5.py \
+  conf/omx_topology.py \
+  gem5_ext/omx/OmxDvfsCtrl.py \
+  gem5_ext/omx/OmxTickTerminal.py \
+  gem5_ext/omx/OmxVirtIOBlock.py \
+  scripts/gen_topology.py \
+  scripts/build_all.py \
+  scripts/artifact_cache.py \
+  scripts/bench_gem5_variants.py \
+  scripts/bench_linux_scaling.py \
+  scripts/boot_timeline.py \
+  scripts/terminal_ticks.py \
+  scripts/build_bench_initramfs.py \
+  scripts/build_blk_image.py \
+  scripts/host_attribution.py \
+  scripts/sweep_mem_replay.py \
+  scripts/stats_series.py \
   scripts/run_gem5.py \
   scripts/web_dashboard.py
 
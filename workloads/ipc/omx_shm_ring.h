@@ -0,0 +1,195 @@
+/*
+ * Lock-free ring pair in the riscv_hybrid Linux<->Zephyr shared window
+ * (conf/riscv_hybrid.py --hybrid-shm). Used by the Linux benchmark
+ * (workloads/linux/bench_initramfs/src/hshm.c) and the Zephyr responder
+ * (workloads/zephyr/riscv32_mixed, CONFIG_RISCV32_MIXED_HYBRID_SHM).
+ *
+ * Layout, offsets from the window base (one 64-byte line per index):
+ *   0x000 header: magic, version, slots, slot_bytes, session, peer_session
+ *   0x040 l2z head (Linux writes)    0x080 l2z tail (Zephyr writes)
+ *   0x0c0 z2l head (Zephyr writes)   0x100 z2l tail (Linux writes)
+ *   0x140 l2z slots, then z2l slots, slots x slot_bytes each
+ *
+ * Each ring has one producer and one consumer and every index one writer,
+ * so acquire/release loads and stores are enough: nothing needs an atomic
+ * read-modify-write across the two systems, which share neither caches nor
+ * a reservation domain. Indices run freely as u32; slots is a power of two.
+ *
+ * Linux owns the session: it lays out the rings, sets a new session number
+ * and publishes magic last. Zephyr attaches by copying the session into
+ * peer_session. Clearing magic ends the session.
+ */
+#ifndef OMX_SHM_RING_H
+#define OMX_SHM_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define OMX_SHM_MAGIC UINT32_C(0x53584d4f) /* "OMXS" */
+#define OMX_SHM_VERSION 1U
+#define OMX_SHM_LINE 64U
+#define OMX_SHM_SLOTS_OFF (5U * OMX_SHM_LINE)
+#define OMX_SHM_UIO_NAME "omx-hybrid-shm"
+
+struct omx_shm_hdr {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t slots;
+	uint32_t slot_bytes;
+	uint32_t session;
+	uint32_t peer_session;
+};
+
+/* Slot contents: this header, then len payload bytes. */
+struct omx_shm_msg {
+	uint32_t seq;
+	uint32_t len;
+	uint64_t stamp;
+};
+
+struct omx_shm_ring {
+	uint32_t *head;
+	uint32_t *tail;
+	uint8_t *slot;
+	uint32_t slots;
+	uint32_t slot_bytes;
+};
+
+static inline uint32_t omx_shm_bytes(uint32_t slots, uint32_t slot_bytes)
+{
+	return OMX_SHM_SLOTS_OFF + 2U * slots * slot_bytes;
+}
+
+static inline int omx_shm_geometry_ok(uint32_t size, uint32_t slots, uint32_t slot_bytes)
+{
+	return slots && !(slots & (slots - 1U)) && slot_bytes >= sizeof(struct omx_shm_msg) &&
+	       slot_bytes % 8U == 0U && (uint64_t)OMX_SHM_SLOTS_OFF + 2ULL * slots * slot_bytes <= size;
+}
+
+/* l2z carries Linux->Zephyr requests, z2l the replies. */
+static inline void omx_shm_rings(void *base, uint32_t slots, uint32_t slot_bytes, struct omx_shm_ring *l2z,
+				 struct omx_shm_ring *z2l)
+{
+	uint8_t *b = (uint8_t *)base;
+
+	l2z->head = (uint32_t *)(b + 1U * OMX_SHM_LINE);
+	l2z->tail = (uint32_t *)(b + 2U * OMX_SHM_LINE);
+	l2z->slot = b + OMX_SHM_SLOTS_OFF;
+	z2l->head = (uint32_t *)(b + 3U * OMX_SHM_LINE);
+	z2l->tail = (uint32_t *)(b + 4U * OMX_SHM_LINE);
+	z2l->slot = l2z->slot + (size_t)slots * slot_bytes;
+	l2z->slots = z2l->slots = slots;
+	l2z->slot_bytes = z2l->slot_bytes = slot_bytes;
+}
+
+/* Linux: lay out and publish a new session; 0 if the geometry does not fit. */
+static inline int omx_shm_open(void *base, uint32_t size, uint32_t slots, uint32_t slot_bytes, uint32_t session,
+			       struct omx_shm_ring *l2z, struct omx_shm_ring *z2l)
+{
+	struct omx_shm_hdr *h = (struct omx_shm_hdr *)base;
+
+	if (!session || !omx_shm_geometry_ok(size, slots, slot_bytes)) {
+		return 0;
+	}
+	__atomic_store_n(&h->magic, 0U, __ATOMIC_RELEASE);
+	omx_shm_rings(base, slots, slot_bytes, l2z, z2l);
+	__atomic_store_n(l2z->head, 0U, __ATOMIC_RELAXED);
+	__atomic_store_n(l2z->tail, 0U, __ATOMIC_RELAXED);
+	__atomic_store_n(z2l->head, 0U, __ATOMIC_RELAXED);
+	__atomic_store_n(z2l->tail, 0U, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->version, OMX_SHM_VERSION, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->slots, slots, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->slot_bytes, slot_bytes, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->peer_session, 0U, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->session, session, __ATOMIC_RELAXED);
+	__atomic_store_n(&h->magic, OMX_SHM_MAGIC, __ATOMIC_RELEASE);
+	return 1;
+}
+
+static inline void omx_shm_close(void *base)
+{
+	__atomic_store_n(&((struct omx_shm_hdr *)base)->magic, 0U, __ATOMIC_RELEASE);
+}
+
+/* Linux: has the peer attached to this session? */
+static inline int omx_shm_peer_attached(void *base, uint32_t session)
+{
+	return __atomic_load_n(&((struct omx_shm_hdr *)base)->peer_session, __ATOMIC_ACQUIRE) == session;
+}
+
+/* Is session still the published one? */
+static inline int omx_shm_live(void *base, uint32_t session)
+{
+	struct omx_shm_hdr *h = (struct omx_shm_hdr *)base;
+
+	return __atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) == OMX_SHM_MAGIC &&
+	       __atomic_load_n(&h->session, __ATOMIC_RELAXED) == session;
+}
+
+/* Zephyr: attach to a published session other than last; returns it, or 0. */
+static inline uint32_t omx_shm_attach(void *base, uint32_t size, uint32_t last, struct omx_shm_ring *l2z,
+				      struct omx_shm_ring *z2l)
+{
+	struct omx_shm_hdr *h = (struct omx_shm_hdr *)base;
+	uint32_t session;
+	uint32_t slots;
+	uint32_t slot_bytes;
+
+	if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != OMX_SHM_MAGIC ||
+	    __atomic_load_n(&h->version, __ATOMIC_RELAXED) != OMX_SHM_VERSION) {
+		return 0U;
+	}
+	session = __atomic_load_n(&h->session, __ATOMIC_RELAXED);
+	slots = __atomic_load_n(&h->slots, __ATOMIC_RELAXED);
+	slot_bytes = __atomic_load_n(&h->slot_bytes, __ATOMIC_RELAXED);
+	if (!session || session == last || !omx_shm_geometry_ok(size, slots, slot_bytes)) {
+		return 0U;
+	}
+	omx_shm_rings(base, slots, slot_bytes, l2z, z2l);
+	__atomic_store_n(&h->peer_session, session, __ATOMIC_RELEASE);
+	return session;
+}
+
+static inline struct omx_shm_msg *omx_shm_at(const struct omx_shm_ring *r, uint32_t index)
+{
+	return (struct omx_shm_msg *)(r->slot + (size_t)(index & (r->slots - 1U)) * r->slot_bytes);
+}
+
+static inline uint32_t omx_shm_max_payload(const struct omx_shm_ring *r)
+{
+	return r->slot_bytes - (uint32_t)sizeof(struct omx_shm_msg);
+}
+
+/* Producer: the next free slot, or NULL when full. Fill it, then omx_shm_push. */
+static inline struct omx_shm_msg *omx_shm_slot(const struct omx_shm_ring *r)
+{
+	const uint32_t head = __atomic_load_n(r->head, __ATOMIC_RELAXED);
+
+	if (head - __atomic_load_n(r->tail, __ATOMIC_ACQUIRE) >= r->slots) {
+		return NULL;
+	}
+	return omx_shm_at(r, head);
+}
+
+static inline void omx_shm_push(const struct omx_shm_ring *r)
+{
+	__atomic_store_n(r->head, __atomic_load_n(r->head, __ATOMIC_RELAXED) + 1U, __ATOMIC_RELEASE);
+}
+
+/* Consumer: the oldest message, or NULL when empty. Read it, then omx_shm_pop. */
+static inline struct omx_shm_msg *omx_shm_peek(const struct omx_shm_ring *r)
+{
+	const uint32_t tail = __atomic_load_n(r->tail, __ATOMIC_RELAXED);
+
+	if (__atomic_load_n(r->head, __ATOMIC_ACQUIRE) == tail) {
+		return NULL;
+	}
+	return omx_shm_at(r, tail);
+}
+
+static inline void omx_shm_pop(const struct omx_shm_ring *r)
+{
+	__atomic_store_n(r->tail, __atomic_load_n(r->tail, __ATOMIC_RELAXED) + 1U, __ATOMIC_RELEASE);
+}
+
+#endif /* OMX_SHM_RING_H */
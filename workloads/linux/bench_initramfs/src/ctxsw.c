@@ -0,0 +1,56 @@
+/*
+ * Context switch cost: parent and child bounce one byte over two pipes
+ * --iters times (two switches per round trip). With --same-cpu 1 (default)
+ * both are pinned to CPU 0 so every hand-off is a real switch.
+ */
+#define _GNU_SOURCE
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "omx_bench.h"
+
+int main(int argc, char **argv)
+{
+	const unsigned long iters = omx_opt_ul(argc, argv, "--iters", 10000);
+	const int same_cpu = (int)omx_opt_ul(argc, argv, "--same-cpu", 1);
+	int ping[2];
+	int pong[2];
+	char byte = 0;
+	uint64_t start;
+	pid_t pid;
+
+	if (same_cpu) {
+		cpu_set_t set;
+
+		CPU_ZERO(&set);
+		CPU_SET(0, &set);
+		sched_setaffinity(0, sizeof(set), &set);
+	}
+	if (pipe(ping) < 0 || pipe(pong) < 0) {
+		return 1;
+	}
+	pid = fork();
+	if (pid < 0) {
+		return 1;
+	}
+	if (pid == 0) {
+		for (unsigned long i = 0; i < iters; ++i) {
+			if (read(ping[0], &byte, 1) != 1 || write(pong[1], &byte, 1) != 1) {
+				_exit(1);
+			}
+		}
+		_exit(0);
+	}
+
+	start = omx_now_ns();
+	for (unsigned long i = 0; i < iters; ++i) {
+		if (write(ping[1], &byte, 1) != 1 || read(pong[0], &byte, 1) != 1) {
+			return 1;
+		}
+	}
+	omx_result("ctxsw", "pipe", same_cpu ? "\"same_cpu\":true" : "\"same_cpu\":false",
+		   (double)(omx_now_ns() - start) / (double)(2 * iters), "ns/switch");
+	waitpid(pid, NULL, 0);
+	return 0;
+}
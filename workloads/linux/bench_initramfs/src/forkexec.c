@@ -0,0 +1,85 @@
+/*
+ * Process creation throughput with --procs (default auto) concurrent
+ * workers, each doing --iters rounds of:
+ * - fork: fork + _exit + waitpid
+ * - exec: fork + execv(/proc/self/exe --child) + waitpid
+ * Reports aggregate ops/s per worker count.
+ */
+#include <sys/wait.h>
+
+#include "omx_bench.h"
+
+static int spawn_loop(unsigned long iters, int do_exec)
+{
+	char *child_argv[] = {"forkexec", "--child", NULL};
+
+	for (unsigned long i = 0; i < iters; ++i) {
+		int status;
+		pid_t pid = fork();
+
+		if (pid < 0) {
+			return 1;
+		}
+		if (pid == 0) {
+			if (do_exec) {
+				execv("/proc/self/exe", child_argv);
+			}
+			_exit(do_exec ? 127 : 0);
+		}
+		if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int run(unsigned long procs, unsigned long iters, int do_exec, double *ops_per_sec)
+{
+	const uint64_t start = omx_now_ns();
+	int rc = 0;
+
+	for (unsigned long i = 0; i < procs; ++i) {
+		pid_t pid = fork();
+
+		if (pid < 0) {
+			return 1;
+		}
+		if (pid == 0) {
+			_exit(spawn_loop(iters, do_exec));
+		}
+	}
+	for (unsigned long i = 0; i < procs; ++i) {
+		int status;
+
+		if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			rc = 1;
+		}
+	}
+	*ops_per_sec = (double)(procs * iters) / ((double)(omx_now_ns() - start) / 1e9);
+	return rc;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long procs[OMX_BENCH_MAX_LIST];
+	int count;
+	unsigned long iters;
+	char extra[64];
+	int rc = 0;
+
+	if (argc > 1 && strcmp(argv[1], "--child") == 0) {
+		return 0;
+	}
+	count = omx_opt_list(argc, argv, "--procs", "auto", procs, OMX_BENCH_MAX_LIST);
+	iters = omx_opt_ul(argc, argv, "--iters", 100);
+	for (int t = 0; t < count; ++t) {
+		double ops;
+
+		snprintf(extra, sizeof(extra), "\"threads\":%lu", procs[t]);
+		rc |= run(procs[t], iters, 0, &ops);
+		omx_result("forkexec", "fork", extra, ops, "ops/s");
+		rc |= run(procs[t], iters, 1, &ops);
+		omx_result("forkexec", "exec", extra, ops, "ops/s");
+	}
+	return rc;
+}
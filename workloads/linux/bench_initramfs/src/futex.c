@@ -0,0 +1,113 @@
+/*
+ * futex/pthread scaling:
+ * - mutex: --threads list, each thread doing --ops lock/increment/unlock on
+ *   one shared pthread mutex (contended futex path)
+ * - pingpong: --pairs (default 1) independent thread pairs, each handing
+ *   its own token back and forth with raw FUTEX_WAIT/FUTEX_WAKE, --ops round
+ *   trips per pair
+ */
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "omx_bench.h"
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long counter;
+static unsigned long ops;
+
+struct pair_side {
+	atomic_int *token;
+	int me;
+};
+
+static void *mutex_worker(void *arg)
+{
+	(void)arg;
+	for (unsigned long i = 0; i < ops; ++i) {
+		pthread_mutex_lock(&lock);
+		counter++;
+		pthread_mutex_unlock(&lock);
+	}
+	return NULL;
+}
+
+static void futex_wait(atomic_int *addr, int val)
+{
+	syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static void futex_wake(atomic_int *addr)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+/* Side `me` waits for token == me, then passes it to the other side. */
+static void *pingpong_worker(void *arg)
+{
+	const struct pair_side *side = arg;
+
+	for (unsigned long i = 0; i < ops; ++i) {
+		int cur;
+
+		while ((cur = atomic_load(side->token)) != side->me) {
+			futex_wait(side->token, cur);
+		}
+		atomic_store(side->token, 1 - side->me);
+		futex_wake(side->token);
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long threads[OMX_BENCH_MAX_LIST];
+	unsigned long pairs[OMX_BENCH_MAX_LIST];
+	const int count = omx_opt_list(argc, argv, "--threads", "1,2,4", threads, OMX_BENCH_MAX_LIST);
+	const int pair_count = omx_opt_list(argc, argv, "--pairs", "1", pairs, OMX_BENCH_MAX_LIST);
+	static atomic_int tokens[32];
+	struct pair_side sides[64];
+	pthread_t tids[64];
+	char extra[64];
+	uint64_t start;
+	int rc = 0;
+
+	ops = omx_opt_ul(argc, argv, "--ops", 20000);
+	for (int t = 0; t < count; ++t) {
+		unsigned long n = threads[t] < 64 ? threads[t] : 64;
+
+		counter = 0;
+		start = omx_now_ns();
+		for (unsigned long i = 0; i < n; ++i) {
+			pthread_create(&tids[i], NULL, mutex_worker, NULL);
+		}
+		for (unsigned long i = 0; i < n; ++i) {
+			pthread_join(tids[i], NULL);
+		}
+		snprintf(extra, sizeof(extra), "\"threads\":%lu", n);
+		omx_result("futex", "mutex", extra, (double)counter / ((double)(omx_now_ns() - start) / 1e9) / 1e3,
+			   "kops/s");
+		rc |= counter != n * ops;
+	}
+
+	for (int t = 0; t < pair_count; ++t) {
+		unsigned long n = pairs[t] < 32 ? pairs[t] : 32;
+
+		for (unsigned long i = 0; i < 2 * n; ++i) {
+			sides[i] = (struct pair_side){.token = &tokens[i / 2], .me = (int)(i % 2)};
+			atomic_store(&tokens[i / 2], 0);
+		}
+		start = omx_now_ns();
+		for (unsigned long i = 0; i < 2 * n; ++i) {
+			pthread_create(&tids[i], NULL, pingpong_worker, &sides[i]);
+		}
+		for (unsigned long i = 0; i < 2 * n; ++i) {
+			pthread_join(tids[i], NULL);
+		}
+		snprintf(extra, sizeof(extra), "\"pairs\":%lu,\"threads\":%lu", n, 2 * n);
+		omx_result("futex", "pingpong", extra, (double)(omx_now_ns() - start) / (double)ops, "ns/roundtrip");
+	}
+	return rc;
+}
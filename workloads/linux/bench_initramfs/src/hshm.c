@@ -0,0 +1,288 @@
+/*
+ * Linux user -> Zephyr -> Linux user round trips over the riscv_hybrid
+ * shared window (conf/riscv_hybrid.py --hybrid-shm; ring protocol in
+ * workloads/ipc/omx_shm_ring.h). The window is the "omx-hybrid-shm"
+ * generic-uio device, or --size bytes of /dev/mem at --phys when UIO is
+ * missing.
+ *
+ * For each --sizes payload (default "8,64,512" bytes): --iters ping-pongs
+ * with one message in flight (cases rtt, rtt_p50, rtt_p99 in ns), then
+ * --stream messages with up to --slots in flight per ring (stream in MB/s
+ * of echoed payload, stream_msgs in msg/s). Every echo is checked against
+ * what was sent; the Zephyr responder (AMP CPU1) must attach within
+ * --timeout-ms.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "omx_bench.h"
+#include "omx_shm_ring.h"
+
+#define MAX_UIO 16
+
+static uint64_t timeout_ns;
+
+static int read_sys(const char *path, char *buf, size_t len)
+{
+	FILE *f = fopen(path, "r");
+	int ok;
+
+	if (!f) {
+		return 0;
+	}
+	ok = fgets(buf, (int)len, f) != NULL;
+	fclose(f);
+	buf[strcspn(buf, "\n")] = '\0';
+	return ok;
+}
+
+static int make_node(const char *path, mode_t type, unsigned int major, unsigned int minor)
+{
+	if (mknod(path, type | 0600, makedev(major, minor)) < 0 && errno != EEXIST) {
+		fprintf(stderr, "hshm: mknod %s: %s\n", path, strerror(errno));
+		return -1;
+	}
+	return open(path, O_RDWR | O_SYNC);
+}
+
+/* Map the UIO window by name; the node is created from sysfs, since there is no udev. */
+static void *map_uio(uint32_t *size)
+{
+	char path[96];
+	char buf[64];
+
+	for (int i = 0; i < MAX_UIO; ++i) {
+		unsigned int major;
+		unsigned int minor;
+		void *base;
+		int fd;
+
+		snprintf(path, sizeof(path), "/sys/class/uio/uio%d/name", i);
+		if (!read_sys(path, buf, sizeof(buf)) || strcmp(buf, OMX_SHM_UIO_NAME) != 0) {
+			continue;
+		}
+		snprintf(path, sizeof(path), "/sys/class/uio/uio%d/dev", i);
+		if (!read_sys(path, buf, sizeof(buf)) || sscanf(buf, "%u:%u", &major, &minor) != 2) {
+			return NULL;
+		}
+		snprintf(path, sizeof(path), "/sys/class/uio/uio%d/maps/map0/size", i);
+		if (!read_sys(path, buf, sizeof(buf))) {
+			return NULL;
+		}
+		*size = (uint32_t)strtoul(buf, NULL, 0);
+		snprintf(path, sizeof(path), "/dev/uio%d", i);
+		fd = make_node(path, S_IFCHR, major, minor);
+		if (fd < 0) {
+			return NULL;
+		}
+		base = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		return base == MAP_FAILED ? NULL : base;
+	}
+	return NULL;
+}
+
+static void *map_devmem(unsigned long phys, uint32_t size)
+{
+	void *base;
+	int fd;
+
+	if (!phys) {
+		return NULL;
+	}
+	fd = make_node("/dev/mem", S_IFCHR, 1, 1);
+	if (fd < 0) {
+		return NULL;
+	}
+	base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, (off_t)phys);
+	close(fd);
+	return base == MAP_FAILED ? NULL : base;
+}
+
+static void fill(struct omx_shm_msg *msg, uint32_t seq, const uint8_t *payload, uint32_t len)
+{
+	msg->seq = seq;
+	msg->len = len;
+	msg->stamp = omx_now_ns();
+	memcpy(msg + 1, payload, len);
+}
+
+static int echoed(const struct omx_shm_msg *msg, uint32_t seq, const uint8_t *payload, uint32_t len)
+{
+	return msg->seq == seq && msg->len == len && memcmp(msg + 1, payload, len) == 0;
+}
+
+/* Spin for the reply; NULL once --timeout-ms has passed. */
+static struct omx_shm_msg *wait_reply(const struct omx_shm_ring *z2l, uint64_t since)
+{
+	for (unsigned long spin = 0;; ++spin) {
+		struct omx_shm_msg *msg = omx_shm_peek(z2l);
+
+		if (msg) {
+			return msg;
+		}
+		if ((spin & 1023U) == 1023U && omx_now_ns() - since > timeout_ns) {
+			return NULL;
+		}
+	}
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	const uint64_t x = *(const uint64_t *)a;
+	const uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int pingpong(const struct omx_shm_ring *l2z, const struct omx_shm_ring *z2l, const uint8_t *payload,
+		    uint32_t len, unsigned long iters, uint32_t *seq, const char *extra)
+{
+	uint64_t *rtt = calloc(iters, sizeof(*rtt));
+	double sum = 0.0;
+
+	if (!rtt) {
+		return 1;
+	}
+	for (unsigned long i = 0; i < iters; ++i) {
+		const uint64_t start = omx_now_ns();
+		struct omx_shm_msg *msg = omx_shm_slot(l2z);
+		struct omx_shm_msg *reply;
+
+		if (!msg) {
+			fprintf(stderr, "hshm: request ring full with nothing in flight\n");
+			free(rtt);
+			return 1;
+		}
+		fill(msg, *seq, payload, len);
+		omx_shm_push(l2z);
+		reply = wait_reply(z2l, start);
+		if (!reply || !echoed(reply, *seq, payload, len)) {
+			fprintf(stderr, "hshm: %s reply %u of %u bytes\n", reply ? "bad" : "no", *seq, len);
+			free(rtt);
+			return 1;
+		}
+		omx_shm_pop(z2l);
+		rtt[i] = omx_now_ns() - start;
+		sum += (double)rtt[i];
+		++*seq;
+	}
+	qsort(rtt, iters, sizeof(*rtt), cmp_u64);
+	omx_result("hshm", "rtt", extra, sum / (double)iters, "ns");
+	omx_result("hshm", "rtt_p50", extra, (double)rtt[iters / 2], "ns");
+	omx_result("hshm", "rtt_p99", extra, (double)rtt[(iters * 99) / 100], "ns");
+	free(rtt);
+	return 0;
+}
+
+static int stream(const struct omx_shm_ring *l2z, const struct omx_shm_ring *z2l, const uint8_t *payload,
+		  uint32_t len, unsigned long count, uint32_t *seq, const char *extra)
+{
+	const uint32_t first = *seq;
+	const uint64_t start = omx_now_ns();
+	unsigned long sent = 0;
+	unsigned long recv = 0;
+	uint64_t last = start;
+	double sec;
+
+	while (recv < count) {
+		struct omx_shm_msg *msg;
+
+		while (sent < count && (msg = omx_shm_slot(l2z)) != NULL) {
+			fill(msg, first + (uint32_t)sent, payload, len);
+			omx_shm_push(l2z);
+			++sent;
+		}
+		while ((msg = omx_shm_peek(z2l)) != NULL) {
+			if (!echoed(msg, first + (uint32_t)recv, payload, len)) {
+				fprintf(stderr, "hshm: stream reply %lu of %u bytes out of order or corrupt\n", recv, len);
+				return 1;
+			}
+			omx_shm_pop(z2l);
+			++recv;
+			last = omx_now_ns();
+		}
+		if (omx_now_ns() - last > timeout_ns) {
+			fprintf(stderr, "hshm: stream stalled after %lu of %lu replies\n", recv, count);
+			return 1;
+		}
+	}
+	*seq = first + (uint32_t)count;
+	sec = (double)(omx_now_ns() - start) / 1e9;
+	omx_result("hshm", "stream", extra, sec > 0 ? (double)count * len / sec / 1e6 : 0.0, "MB/s");
+	omx_result("hshm", "stream_msgs", extra, sec > 0 ? (double)count / sec : 0.0, "msg/s");
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	const uint32_t slots = (uint32_t)omx_opt_ul(argc, argv, "--slots", 32);
+	const unsigned long iters = omx_opt_ul(argc, argv, "--iters", 1000);
+	const unsigned long count = omx_opt_ul(argc, argv, "--stream", 4096);
+	unsigned long sizes[OMX_BENCH_MAX_LIST];
+	const int nsizes = omx_opt_list(argc, argv, "--sizes", "8,64,512", sizes, OMX_BENCH_MAX_LIST);
+	uint32_t size = (uint32_t)omx_opt_ul(argc, argv, "--size", 0x100000);
+	struct omx_shm_ring l2z;
+	struct omx_shm_ring z2l;
+	uint32_t slot_bytes;
+	uint32_t max_len = 0;
+	uint32_t session;
+	uint32_t seq = 1;
+	uint8_t *payload;
+	uint64_t start;
+	char extra[32];
+	void *base;
+	int rc = 0;
+
+	timeout_ns = omx_opt_ul(argc, argv, "--timeout-ms", 10000) * 1000000ULL;
+	for (int i = 0; i < nsizes; ++i) {
+		max_len = sizes[i] > max_len ? (uint32_t)sizes[i] : max_len;
+	}
+	base = map_uio(&size);
+	if (!base) {
+		base = map_devmem(omx_opt_ul(argc, argv, "--phys", 0), size);
+	}
+	if (!base || nsizes == 0 || iters == 0) {
+		fprintf(stderr, "hshm: no %s UIO device and no usable --phys window\n", OMX_SHM_UIO_NAME);
+		return 1;
+	}
+	slot_bytes = (uint32_t)((sizeof(struct omx_shm_msg) + max_len + OMX_SHM_LINE - 1) / OMX_SHM_LINE * OMX_SHM_LINE);
+	/* A new session number per run, so the responder reattaches after a rerun. */
+	session = (uint32_t)omx_now_ns() | 1U;
+	if (!omx_shm_open(base, size, slots, slot_bytes, session, &l2z, &z2l)) {
+		fprintf(stderr, "hshm: %u slots of %u bytes do not fit the %u byte window\n", slots, slot_bytes, size);
+		return 1;
+	}
+
+	start = omx_now_ns();
+	while (!omx_shm_peer_attached(base, session)) {
+		if (omx_now_ns() - start > timeout_ns) {
+			fprintf(stderr, "hshm: responder did not attach within the timeout\n");
+			omx_shm_close(base);
+			return 1;
+		}
+		usleep(100);
+	}
+	omx_result("hshm", "attach", "", (double)(omx_now_ns() - start) / 1e6, "ms");
+
+	payload = malloc(max_len ? max_len : 1);
+	if (!payload) {
+		return 1;
+	}
+	for (uint32_t i = 0; i < max_len; ++i) {
+		payload[i] = (uint8_t)(i * 7U + 1U);
+	}
+	for (int i = 0; i < nsizes && rc == 0; ++i) {
+		snprintf(extra, sizeof(extra), "\"bytes\":%lu", sizes[i]);
+		rc = pingpong(&l2z, &z2l, payload, (uint32_t)sizes[i], iters, &seq, extra);
+		if (rc == 0 && count) {
+			rc = stream(&l2z, &z2l, payload, (uint32_t)sizes[i], count, &seq, extra);
+		}
+	}
+	omx_shm_close(base);
+	free(payload);
+	return rc;
+}
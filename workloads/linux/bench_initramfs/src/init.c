@@ -0,0 +1,116 @@
+/*
+ * PID 1 of the benchmark initramfs (no busybox, no shell).
+ *
+ * Runs every line of /etc/omx_bench.list ("<binary> [args...]", binaries
+ * in /bin) in order, bracketing each with m5 reset/dump stats so stats.txt
+ * holds one section per benchmark, then ends the simulation with m5 exit.
+ * Directive lines: "@m5_exit 0|1", "@stats_per_bench 0|1".
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mount.h>
+#include <sys/reboot.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "omx_bench.h"
+
+#define LIST_PATH "/etc/omx_bench.list"
+#define MAX_ARGS 32
+
+static int run_one(char *line, int stats_per_bench)
+{
+	char *argv[MAX_ARGS + 1];
+	char path[256];
+	int argc = 0;
+	int status = 0;
+	uint64_t start;
+	pid_t pid;
+
+	for (char *tok = strtok(line, " \t\n"); tok && argc < MAX_ARGS; tok = strtok(NULL, " \t\n")) {
+		argv[argc++] = tok;
+	}
+	if (argc == 0) {
+		return 0;
+	}
+	argv[argc] = NULL;
+	snprintf(path, sizeof(path), "/bin/%s", argv[0]);
+
+	printf("OMX_BENCH_START %s\n", argv[0]);
+	fflush(stdout);
+	if (stats_per_bench) {
+		omx_m5_reset_stats();
+	}
+	start = omx_now_ns();
+	pid = fork();
+	if (pid == 0) {
+		execv(path, argv);
+		fprintf(stderr, "exec %s: %s\n", path, strerror(errno));
+		_exit(127);
+	}
+	if (pid < 0 || waitpid(pid, &status, 0) < 0) {
+		status = -1;
+	}
+	if (stats_per_bench) {
+		omx_m5_dump_stats();
+	}
+	printf(OMX_BENCH_PREFIX "{\"bench\":\"%s\",\"case\":\"status\",\"exit\":%d,\"value\":%.3f,\"unit\":\"ms\"}\n",
+	       argv[0], (status >= 0 && WIFEXITED(status)) ? WEXITSTATUS(status) : -1,
+	       (double)(omx_now_ns() - start) / 1e6);
+	fflush(stdout);
+	return (status >= 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+int main(void)
+{
+	char line[512];
+	int m5_exit = 1;
+	int stats_per_bench = 1;
+	int runs = 0;
+	int failures = 0;
+	FILE *list;
+
+	mount("proc", "/proc", "proc", 0, NULL);
+	mount("sysfs", "/sys", "sysfs", 0, NULL);
+
+	printf("OMX_BENCH_BEGIN cpus=%ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+	list = fopen(LIST_PATH, "r");
+	if (!list) {
+		printf("OMX_BENCH_ERROR cannot open %s\n", LIST_PATH);
+		failures = 1;
+	}
+	while (list && fgets(line, sizeof(line), list)) {
+		int value;
+
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+		if (sscanf(line, "@m5_exit %d", &value) == 1) {
+			m5_exit = value;
+			continue;
+		}
+		if (sscanf(line, "@stats_per_bench %d", &value) == 1) {
+			stats_per_bench = value;
+			continue;
+		}
+		failures += run_one(line, stats_per_bench);
+		runs++;
+	}
+	if (list) {
+		fclose(list);
+	}
+
+	printf("OMX_BENCH_DONE runs=%d failures=%d\n", runs, failures);
+	fflush(stdout);
+	sync();
+	if (m5_exit) {
+		omx_m5_exit();
+	}
+	reboot(RB_POWER_OFF);
+	for (;;) {
+		pause();
+	}
+	return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ * STREAM-style memory bandwidth: copy, scale, add, triad over three double
+ * arrays of --size-kb each, best of --iters passes. With --threads (default
+ * "1") each pass splits the arrays across that many threads, which meet at a
+ * barrier before and after every kernel.
+ */
+#include <pthread.h>
+
+#include "omx_bench.h"
+
+#define MAX_THREADS 64
+
+static const char *const names[] = {"copy", "scale", "add", "triad"};
+static const int arrays[] = {2, 2, 3, 3};
+static double *a;
+static double *b;
+static double *c;
+static size_t n;
+static unsigned long iters;
+static unsigned long nthreads;
+static uint64_t best[4];
+static pthread_barrier_t bar;
+
+static void kernel(int k, size_t lo, size_t hi)
+{
+	switch (k) {
+	case 0:
+		for (size_t i = lo; i < hi; ++i) {
+			c[i] = a[i];
+		}
+		break;
+	case 1:
+		for (size_t i = lo; i < hi; ++i) {
+			b[i] = 3.0 * c[i];
+		}
+		break;
+	case 2:
+		for (size_t i = lo; i < hi; ++i) {
+			c[i] = a[i] + b[i];
+		}
+		break;
+	default:
+		for (size_t i = lo; i < hi; ++i) {
+			a[i] = b[i] + 3.0 * c[i];
+		}
+		break;
+	}
+}
+
+/* Thread 0 times each kernel between the two barriers. */
+static void *worker(void *arg)
+{
+	const size_t id = (size_t)(uintptr_t)arg;
+	const size_t lo = n * id / nthreads;
+	const size_t hi = n * (id + 1) / nthreads;
+
+	for (unsigned long it = 0; it < iters; ++it) {
+		for (int k = 0; k < 4; ++k) {
+			uint64_t start = 0;
+
+			pthread_barrier_wait(&bar);
+			if (id == 0) {
+				start = omx_now_ns();
+			}
+			kernel(k, lo, hi);
+			pthread_barrier_wait(&bar);
+			if (id == 0) {
+				const uint64_t ns = omx_now_ns() - start;
+
+				best[k] = ns < best[k] ? ns : best[k];
+			}
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	const size_t size_kb = omx_opt_ul(argc, argv, "--size-kb", 4096);
+	unsigned long threads[OMX_BENCH_MAX_LIST];
+	const int count = omx_opt_list(argc, argv, "--threads", "1", threads, OMX_BENCH_MAX_LIST);
+	pthread_t tids[MAX_THREADS];
+	char extra[64];
+
+	iters = omx_opt_ul(argc, argv, "--iters", 4);
+	n = size_kb * 1024 / sizeof(double);
+	a = malloc(n * sizeof(double));
+	b = malloc(n * sizeof(double));
+	c = malloc(n * sizeof(double));
+	if (!a || !b || !c || n == 0) {
+		return 1;
+	}
+
+	for (int t = 0; t < count; ++t) {
+		nthreads = threads[t] < 1 ? 1 : (threads[t] > MAX_THREADS ? MAX_THREADS : threads[t]);
+		for (size_t i = 0; i < n; ++i) {
+			a[i] = 1.0;
+			b[i] = 2.0;
+			c[i] = 0.0;
+		}
+		for (int k = 0; k < 4; ++k) {
+			best[k] = UINT64_MAX;
+		}
+		pthread_barrier_init(&bar, NULL, (unsigned)nthreads);
+		for (unsigned long i = 1; i < nthreads; ++i) {
+			pthread_create(&tids[i], NULL, worker, (void *)(uintptr_t)i);
+		}
+		worker((void *)0);
+		for (unsigned long i = 1; i < nthreads; ++i) {
+			pthread_join(tids[i], NULL);
+		}
+		pthread_barrier_destroy(&bar);
+
+		snprintf(extra, sizeof(extra), "\"size_kb\":%zu,\"threads\":%lu", size_kb, nthreads);
+		for (int k = 0; k < 4; ++k) {
+			double bytes = (double)arrays[k] * (double)n * sizeof(double);
+
+			omx_result("membw", names[k], extra, best[k] ? bytes / ((double)best[k] / 1e9) / 1e6 : 0.0,
+				   "MB/s");
+		}
+	}
+	/* Keep the arrays observable so the loops are not optimised away. */
+	return a[n / 2] > 0.0 ? 0 : 1;
+}
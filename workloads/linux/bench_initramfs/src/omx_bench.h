@@ -0,0 +1,127 @@
+/*
+ * Shared helpers for the benchmark initramfs binaries: timing, option
+ * parsing, one-line JSON results and gem5 m5ops.
+ *
+ * Result lines start with OMX_BENCH and carry one JSON object so
+ * scripts/run_gem5.py can collect them from the terminal log.
+ */
+#ifndef OMX_BENCH_H
+#define OMX_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OMX_BENCH_PREFIX "OMX_BENCH "
+#define OMX_BENCH_MAX_LIST 16
+
+static inline uint64_t omx_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Value of "--name <v>" in argv, or fallback. */
+static inline const char *omx_opt(int argc, char **argv, const char *name, const char *fallback)
+{
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (strcmp(argv[i], name) == 0) {
+			return argv[i + 1];
+		}
+	}
+	return fallback;
+}
+
+static inline unsigned long omx_opt_ul(int argc, char **argv, const char *name, unsigned long fallback)
+{
+	const char *v = omx_opt(argc, argv, name, NULL);
+
+	return v ? strtoul(v, NULL, 0) : fallback;
+}
+
+/*
+ * Comma-separated unsigned list ("1,2,4"); returns the number of entries.
+ * "auto" expands to 1, 2, 4, ... up to the online CPU count, plus the count
+ * itself, so a scaling sweep follows the simulated --num-cpus.
+ */
+static inline int omx_opt_list(int argc, char **argv, const char *name, const char *fallback,
+			       unsigned long *out, int max)
+{
+	const char *p = omx_opt(argc, argv, name, fallback);
+	int n = 0;
+
+	if (p && strcmp(p, "auto") == 0) {
+		const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		unsigned long v = 1;
+
+		for (; n < max && (long)v < cpus; v *= 2) {
+			out[n++] = v;
+		}
+		if (n < max) {
+			out[n++] = cpus > 0 ? (unsigned long)cpus : 1;
+		}
+		return n;
+	}
+	while (p && *p && n < max) {
+		char *end;
+
+		out[n++] = strtoul(p, &end, 0);
+		p = (*end == ',') ? end + 1 : NULL;
+	}
+	return n;
+}
+
+/* Emit one result: OMX_BENCH {"bench":..,"case":..,<extra>,"value":..,"unit":..} */
+static inline void omx_result(const char *bench, const char *bench_case, const char *extra, double value,
+			      const char *unit)
+{
+	printf(OMX_BENCH_PREFIX "{\"bench\":\"%s\",\"case\":\"%s\"%s%s,\"value\":%.3f,\"unit\":\"%s\"}\n", bench,
+	       bench_case, extra && *extra ? "," : "", extra ? extra : "", value, unit);
+	fflush(stdout);
+}
+
+/*
+ * gem5 pseudo instructions (util/m5/src/abi/riscv/m5op.S): custom-3 opcode
+ * with the m5op number in funct7, arguments in a0/a1. No-ops off RISC-V so
+ * the benchmarks can be smoke-tested on the host.
+ */
+#define OMX_M5OP_EXIT 0x21
+#define OMX_M5OP_RESET_STATS 0x40
+#define OMX_M5OP_DUMP_STATS 0x41
+
+#define OMX_STR_(x) #x
+#define OMX_STR(x) OMX_STR_(x)
+
+#if defined(__riscv)
+#define OMX_M5OP(func, arg0, arg1) \
+	do { \
+		register uint64_t a0_ __asm__("a0") = (arg0); \
+		register uint64_t a1_ __asm__("a1") = (arg1); \
+		__asm__ volatile(".long 0x0000007b | (" OMX_STR(func) " << 25)" \
+				 : "+r"(a0_) : "r"(a1_) : "memory"); \
+	} while (0)
+#else
+#define OMX_M5OP(func, arg0, arg1) ((void)(arg0), (void)(arg1))
+#endif
+
+static inline void omx_m5_exit(void)
+{
+	OMX_M5OP(OMX_M5OP_EXIT, 0, 0);
+}
+
+static inline void omx_m5_reset_stats(void)
+{
+	OMX_M5OP(OMX_M5OP_RESET_STATS, 0, 0);
+}
+
+static inline void omx_m5_dump_stats(void)
+{
+	OMX_M5OP(OMX_M5OP_DUMP_STATS, 0, 0);
+}
+
+#endif /* OMX_BENCH_H */
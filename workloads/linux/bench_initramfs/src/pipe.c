@@ -0,0 +1,101 @@
+/*
+ * Pipe round-trip latency with --pairs (default "1,2") independent process
+ * pairs bouncing one byte --iters times, unpinned so the scheduler may place
+ * the two ends on different harts. Reports the mean per round trip.
+ */
+#include <sys/wait.h>
+
+#include "omx_bench.h"
+
+static int bounce(int in, int out, unsigned long iters, int first)
+{
+	char byte = 0;
+
+	for (unsigned long i = 0; i < iters; ++i) {
+		if (first && write(out, &byte, 1) != 1) {
+			return 1;
+		}
+		if (read(in, &byte, 1) != 1) {
+			return 1;
+		}
+		if (!first && write(out, &byte, 1) != 1) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* One pair: the parent side of the pair times its own round trips. */
+static void run_pair(int report, unsigned long iters)
+{
+	int ping[2];
+	int pong[2];
+	uint64_t start;
+	double ns;
+	pid_t pid;
+	int rc;
+
+	if (pipe(ping) < 0 || pipe(pong) < 0) {
+		_exit(1);
+	}
+	pid = fork();
+	if (pid < 0) {
+		_exit(1);
+	}
+	if (pid == 0) {
+		_exit(bounce(ping[0], pong[1], iters, 0));
+	}
+	start = omx_now_ns();
+	rc = bounce(pong[0], ping[1], iters, 1);
+	ns = (double)(omx_now_ns() - start) / (double)iters;
+	if (write(report, &ns, sizeof(ns)) != sizeof(ns)) {
+		rc = 1;
+	}
+	waitpid(pid, NULL, 0);
+	_exit(rc);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long pairs[OMX_BENCH_MAX_LIST];
+	const int count = omx_opt_list(argc, argv, "--pairs", "1,2", pairs, OMX_BENCH_MAX_LIST);
+	const unsigned long iters = omx_opt_ul(argc, argv, "--iters", 5000);
+	char extra[64];
+	int rc = 0;
+
+	for (int t = 0; t < count; ++t) {
+		const unsigned long n = pairs[t] < 32 ? pairs[t] : 32;
+		int report[2];
+		double sum = 0.0;
+
+		if (pipe(report) < 0) {
+			return 1;
+		}
+		for (unsigned long i = 0; i < n; ++i) {
+			if (fork() == 0) {
+				close(report[0]);
+				run_pair(report[1], iters);
+			}
+		}
+		close(report[1]);
+		for (unsigned long i = 0; i < n; ++i) {
+			double ns = 0.0;
+
+			if (read(report[0], &ns, sizeof(ns)) != sizeof(ns)) {
+				rc = 1;
+			}
+			sum += ns;
+		}
+		close(report[0]);
+		for (unsigned long i = 0; i < n; ++i) {
+			int status;
+
+			if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+				rc = 1;
+			}
+		}
+		snprintf(extra, sizeof(extra), "\"pairs\":%lu,\"threads\":%lu", n, 2 * n);
+		omx_result("pipe", "roundtrip", extra, sum / (double)n, "ns/roundtrip");
+	}
+	return rc;
+}
@@ -0,0 +1,62 @@
+/*
+ * Dependent-load latency: a random cyclic permutation of 64-byte nodes per
+ * working-set size (--sizes-kb), --loads chased loads each.
+ */
+#include <stdlib.h>
+
+#include "omx_bench.h"
+
+struct node {
+	struct node *next;
+	char pad[64 - sizeof(struct node *)];
+};
+
+int main(int argc, char **argv)
+{
+	unsigned long sizes[OMX_BENCH_MAX_LIST];
+	const int count = omx_opt_list(argc, argv, "--sizes-kb", "16,256,4096", sizes, OMX_BENCH_MAX_LIST);
+	const unsigned long loads = omx_opt_ul(argc, argv, "--loads", 200000);
+	uintptr_t sink = 0;
+	char extra[64];
+
+	srand(1);
+	for (int s = 0; s < count; ++s) {
+		const size_t n = sizes[s] * 1024 / sizeof(struct node);
+		struct node *nodes = malloc(n * sizeof(struct node));
+		size_t *order = malloc(n * sizeof(size_t));
+		struct node *p;
+		uint64_t start;
+
+		if (!nodes || !order || n < 2) {
+			return 1;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			order[i] = i;
+		}
+		for (size_t i = n - 1; i > 0; --i) {
+			size_t j = (size_t)rand() % (i + 1);
+			size_t tmp = order[i];
+
+			order[i] = order[j];
+			order[j] = tmp;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			nodes[order[i]].next = &nodes[order[(i + 1) % n]];
+		}
+
+		p = &nodes[order[0]];
+		for (size_t i = 0; i < n; ++i) {
+			p = p->next; /* warm up */
+		}
+		start = omx_now_ns();
+		for (unsigned long i = 0; i < loads; ++i) {
+			p = p->next;
+		}
+		sink += (uintptr_t)p;
+		snprintf(extra, sizeof(extra), "\"size_kb\":%lu", sizes[s]);
+		omx_result("ptrchase", "latency", extra, (double)(omx_now_ns() - start) / (double)loads, "ns/load");
+		free(order);
+		free(nodes);
+	}
+	return sink == 1 ? 1 : 0;
+}
@@ -0,0 +1,85 @@
+/*
+ * Spinning synchronization scaling over --threads (default auto), --ops per
+ * thread:
+ * - spinlock: lock/increment/unlock on one pthread spinlock (no futex, pure
+ *   cache-line contention plus lock handoff)
+ * - atomic: fetch-add on one shared counter (cache-line ping-pong only)
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "omx_bench.h"
+
+static pthread_spinlock_t lock;
+static pthread_barrier_t start_line;
+static unsigned long counter;
+static atomic_ulong atomic_counter;
+static unsigned long ops;
+
+static void *spin_worker(void *arg)
+{
+	(void)arg;
+	pthread_barrier_wait(&start_line);
+	for (unsigned long i = 0; i < ops; ++i) {
+		pthread_spin_lock(&lock);
+		counter++;
+		pthread_spin_unlock(&lock);
+	}
+	return NULL;
+}
+
+static void *atomic_worker(void *arg)
+{
+	(void)arg;
+	pthread_barrier_wait(&start_line);
+	for (unsigned long i = 0; i < ops; ++i) {
+		atomic_fetch_add_explicit(&atomic_counter, 1, memory_order_relaxed);
+	}
+	return NULL;
+}
+
+/* kops/s of n threads running worker; the clock starts once all are created. */
+static double run(void *(*worker)(void *), unsigned long n)
+{
+	pthread_t tids[64];
+	uint64_t start;
+
+	pthread_barrier_init(&start_line, NULL, (unsigned)n + 1);
+	for (unsigned long i = 0; i < n; ++i) {
+		pthread_create(&tids[i], NULL, worker, NULL);
+	}
+	start = omx_now_ns();
+	pthread_barrier_wait(&start_line);
+	for (unsigned long i = 0; i < n; ++i) {
+		pthread_join(tids[i], NULL);
+	}
+	pthread_barrier_destroy(&start_line);
+	return (double)(n * ops) / ((double)(omx_now_ns() - start) / 1e9) / 1e3;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long threads[OMX_BENCH_MAX_LIST];
+	const int count = omx_opt_list(argc, argv, "--threads", "auto", threads, OMX_BENCH_MAX_LIST);
+	char extra[64];
+	int rc = 0;
+
+	ops = omx_opt_ul(argc, argv, "--ops", 20000);
+	pthread_spin_init(&lock, PTHREAD_PROCESS_PRIVATE);
+	for (int t = 0; t < count; ++t) {
+		const unsigned long n = threads[t] < 64 ? threads[t] : 64;
+		double kops;
+
+		snprintf(extra, sizeof(extra), "\"threads\":%lu", n);
+		counter = 0;
+		kops = run(spin_worker, n);
+		omx_result("spin", "spinlock", extra, kops, "kops/s");
+		rc |= counter != n * ops;
+
+		atomic_store(&atomic_counter, 0);
+		kops = run(atomic_worker, n);
+		omx_result("spin", "atomic", extra, kops, "kops/s");
+		rc |= atomic_load(&atomic_counter) != n * ops;
+	}
+	return rc;
+}
@@ -7,43 +7,55 @@
 #include <zephyr/sys/printk.h>
 #include <zephyr/sys/util.h>
 
+#include "omx_shm_ring.h"
+
 #define OMX_ROLE DT_PROP(DT_PATH(zephyr_user), omx_role)
+#define OMX_MARKER_ROLE DT_PROP_OR(DT_PATH(zephyr_user), omx_marker_role, "UNKNOWN")
 #define OMX_UART_POLICY DT_PROP(DT_PATH(zephyr_user), omx_uart_policy)
+#define OMX_IMAGE_INDEX DT_PROP_OR(DT_PATH(zephyr_user), omx_image_index, 0)
+#define OMX_IMAGE_COUNT DT_PROP_OR(DT_PATH(zephyr_user), omx_image_count, 1)
+#define OMX_SYNC_BASE DT_PROP_OR(DT_PATH(zephyr_user), omx_sync_base, 0x90000000)
+#define OMX_SYNC_MASTER DT_PROP_OR(DT_PATH(zephyr_user), omx_sync_master, 0)
+#define OMX_DVFS_BASE DT_PROP_OR(DT_PATH(zephyr_user), omx_dvfs_base, 0)
+#define OMX_DVFS_DOMAIN DT_PROP_OR(DT_PATH(zephyr_user), omx_dvfs_domain, -1)
+#define OMX_HYBRID_SHM_BASE DT_PROP_OR(DT_PATH(zephyr_user), omx_hybrid_shm_base, 0)
+#define OMX_HYBRID_SHM_SIZE DT_PROP_OR(DT_PATH(zephyr_user), omx_hybrid_shm_size, 0)
 
 LOG_MODULE_REGISTER(riscv32_mixed, LOG_LEVEL_INF);
 
-#define MIXED_SYNC_BASE ((uintptr_t)0x90000000U)
-#define MIXED_SYNC_SLOT_AMP0 (MIXED_SYNC_BASE + 0x0U)
-#define MIXED_SYNC_SLOT_AMP1 (MIXED_SYNC_BASE + 0x4U)
-#define MIXED_SYNC_SLOT_SMP (MIXED_SYNC_BASE + 0x8U)
-#define MIXED_SYNC_SIG_AMP0 UINT32_C(0x41504330)
-#define MIXED_SYNC_SIG_AMP1 UINT32_C(0x41504331)
-#define MIXED_SYNC_SIG_SMP UINT32_C(0x534d5032)
-#define MIXED_SYNC_READY_MASK (BIT(0) | BIT(1) | BIT(2))
+/* One ready slot per image (scripts/gen_topology.py numbers the images). */
+#define MIXED_SYNC_SLOT(index) ((volatile uint32_t *)((uintptr_t)OMX_SYNC_BASE + 4U * (index)))
+#define MIXED_SYNC_SIG(index) (UINT32_C(0x53594e00) | (uint32_t)(index))
+#define MIXED_SYNC_READY_MASK ((uint32_t)BIT64_MASK(OMX_IMAGE_COUNT))
+
+/* gem5_ext/omx/OmxDvfsCtrl.py register map */
+#define DVFS_REG_ID 0x00U
+#define DVFS_REG_DOMAIN_SEL 0x08U
+#define DVFS_REG_NUM_PERF_LEVELS 0x0cU
+#define DVFS_REG_PERF_LEVEL 0x10U
+#define DVFS_REG_CUR_FREQ_KHZ 0x14U
+#define DVFS_ID_VALUE UINT32_C(0x4f4d5844)
 
 struct workload_profile {
 	const char *dt_role;
-	const char *marker_role;
 	uint32_t phases;
 	uint32_t loops_per_phase;
 };
 
+/* Roles of the default topology; generated roles use the defaults in main(). */
 static const struct workload_profile profiles[] = {
 	{
 		.dt_role = "cluster0-amp-cpu0",
-		.marker_role = "AMP CPU0",
 		.phases = 4U,
 		.loops_per_phase = 1600U,
 	},
 	{
 		.dt_role = "cluster0-amp-cpu1",
-		.marker_role = "AMP CPU1",
 		.phases = 4U,
 		.loops_per_phase = 1700U,
 	},
 	{
 		.dt_role = "cluster1-smp",
-		.marker_role = "CLUSTER1 SMP",
 		.phases = 5U,
 		.loops_per_phase = 2400U,
 	},
@@ -60,72 +72,138 @@ static const struct workload_profile *resolve_profile(const char *dt_role)
 	return NULL;
 }
 
-static volatile uint32_t *sync_slot(const char *dt_role)
+static void mark_role_ready(void)
 {
-	if (strcmp(dt_role, "cluster0-amp-cpu0") == 0) {
-		return (volatile uint32_t *)MIXED_SYNC_SLOT_AMP0;
-	}
+	__atomic_store_n(MIXED_SYNC_SLOT(OMX_IMAGE_INDEX), MIXED_SYNC_SIG(OMX_IMAGE_INDEX),
+			 __ATOMIC_RELEASE);
+}
 
-	if (strcmp(dt_role, "cluster0-amp-cpu1") == 0) {
-		return (volatile uint32_t *)MIXED_SYNC_SLOT_AMP1;
-	}
+static uint32_t role_ready_mask(void)
+{
+	uint32_t mask = 0U;
 
-	if (strcmp(dt_role, "cluster1-smp") == 0) {
-		return (volatile uint32_t *)MIXED_SYNC_SLOT_SMP;
+	for (uint32_t index = 0U; index < OMX_IMAGE_COUNT; ++index) {
+		if (__atomic_load_n(MIXED_SYNC_SLOT(index), __ATOMIC_ACQUIRE) ==
+		    MIXED_SYNC_SIG(index)) {
+			mask |= BIT(index);
+		}
 	}
 
-	return NULL;
+	return mask;
 }
 
-static uint32_t sync_signature(const char *dt_role)
+static volatile uint32_t *dvfs_reg(uint32_t offset)
 {
-	if (strcmp(dt_role, "cluster0-amp-cpu0") == 0) {
-		return MIXED_SYNC_SIG_AMP0;
-	}
+	return (volatile uint32_t *)((uintptr_t)OMX_DVFS_BASE + offset);
+}
 
-	if (strcmp(dt_role, "cluster0-amp-cpu1") == 0) {
-		return MIXED_SYNC_SIG_AMP1;
-	}
+static uint32_t run_phase(uint32_t phase, uint32_t loops, char seed)
+{
+	uint32_t phase_acc = 0U;
 
-	if (strcmp(dt_role, "cluster1-smp") == 0) {
-		return MIXED_SYNC_SIG_SMP;
+	for (uint32_t i = 0U; i < loops; ++i) {
+		phase_acc += (i + (phase * 3U) + seed) & 0x1FU;
 	}
 
-	return 0U;
+	return phase_acc;
 }
 
-static void mark_role_ready(const char *dt_role)
+static void dvfs_sweep(const char *marker_role, uint32_t loops)
 {
-	volatile uint32_t *slot = sync_slot(dt_role);
-	uint32_t signature = sync_signature(dt_role);
+	uint32_t levels;
+
+	if (OMX_DVFS_BASE == 0 || OMX_DVFS_DOMAIN < 0) {
+		return;
+	}
 
-	if (slot == NULL || signature == 0U) {
+	if (*dvfs_reg(DVFS_REG_ID) != DVFS_ID_VALUE) {
+		printk("RISCV32 MIXED DVFS %s status=NO_DEVICE\n", marker_role);
 		return;
 	}
 
-	__atomic_store_n(slot, signature, __ATOMIC_RELEASE);
+	*dvfs_reg(DVFS_REG_DOMAIN_SEL) = (uint32_t)OMX_DVFS_DOMAIN;
+	levels = *dvfs_reg(DVFS_REG_NUM_PERF_LEVELS);
+
+	for (uint32_t level = 0U; level < levels; ++level) {
+		uint32_t start;
+		uint32_t cycles;
+
+		*dvfs_reg(DVFS_REG_PERF_LEVEL) = level;
+		/* Let the handler's transition latency elapse before measuring. */
+		k_sleep(K_MSEC(1));
+
+		start = k_cycle_get_32();
+		(void)run_phase(level, loops, marker_role[0]);
+		cycles = k_cycle_get_32() - start;
+
+		printk("RISCV32 MIXED DVFS %s domain=%d level=%u freq_khz=%u cycles=%u\n",
+		       marker_role, OMX_DVFS_DOMAIN, level, *dvfs_reg(DVFS_REG_CUR_FREQ_KHZ),
+		       cycles);
+	}
+
+	*dvfs_reg(DVFS_REG_PERF_LEVEL) = 0U;
 }
 
-static uint32_t role_ready_mask(void)
+/* Echo one session's requests back until Linux ends or replaces it. */
+static uint32_t hybrid_shm_echo(void *base, uint32_t session, const struct omx_shm_ring *l2z,
+				const struct omx_shm_ring *z2l)
 {
-	uint32_t mask = 0U;
+	uint32_t echoed = 0U;
 
-	if (__atomic_load_n((volatile uint32_t *)MIXED_SYNC_SLOT_AMP0,
-			    __ATOMIC_ACQUIRE) == MIXED_SYNC_SIG_AMP0) {
-		mask |= BIT(0);
-	}
+	for (;;) {
+		const struct omx_shm_msg *req = omx_shm_peek(l2z);
+		struct omx_shm_msg *rsp;
 
-	if (__atomic_load_n((volatile uint32_t *)MIXED_SYNC_SLOT_AMP1,
-			    __ATOMIC_ACQUIRE) == MIXED_SYNC_SIG_AMP1) {
-		mask |= BIT(1);
+		if (req == NULL) {
+			if (!omx_shm_live(base, session)) {
+				return echoed;
+			}
+			continue;
+		}
+		while ((rsp = omx_shm_slot(z2l)) == NULL) {
+			if (!omx_shm_live(base, session)) {
+				return echoed;
+			}
+		}
+		memcpy(rsp, req, sizeof(*req) + MIN(req->len, omx_shm_max_payload(l2z)));
+		omx_shm_push(z2l);
+		omx_shm_pop(l2z);
+		++echoed;
 	}
+}
 
-	if (__atomic_load_n((volatile uint32_t *)MIXED_SYNC_SLOT_SMP,
-			    __ATOMIC_ACQUIRE) == MIXED_SYNC_SIG_SMP) {
-		mask |= BIT(2);
-	}
+/*
+ * Responder of the riscv_hybrid Linux<->Zephyr window (gem5 --hybrid-shm).
+ * Sleeps until Linux publishes a session, then busy-polls the request ring
+ * so the round trip measures the window rather than the tick rate.
+ */
+static void hybrid_shm_serve(const char *marker_role)
+{
+	void *base = (void *)(uintptr_t)OMX_HYBRID_SHM_BASE;
+	uint32_t session = 0U;
 
-	return mask;
+	if (OMX_HYBRID_SHM_BASE == 0 || OMX_HYBRID_SHM_SIZE == 0) {
+		printk("RISCV32 MIXED HSHM %s status=NO_WINDOW\n", marker_role);
+		return;
+	}
+	printk("RISCV32 MIXED HSHM %s status=WAITING base=0x%x size=0x%x\n", marker_role,
+	       (uint32_t)OMX_HYBRID_SHM_BASE, (uint32_t)OMX_HYBRID_SHM_SIZE);
+	for (;;) {
+		struct omx_shm_ring l2z;
+		struct omx_shm_ring z2l;
+		uint32_t next;
+		uint32_t echoed;
+
+		while ((next = omx_shm_attach(base, OMX_HYBRID_SHM_SIZE, session, &l2z, &z2l)) == 0U) {
+			k_sleep(K_MSEC(1));
+		}
+		session = next;
+		printk("RISCV32 MIXED HSHM %s status=ATTACHED session=0x%x slots=%u slot_bytes=%u\n",
+		       marker_role, session, l2z.slots, l2z.slot_bytes);
+		echoed = hybrid_shm_echo(base, session, &l2z, &z2l);
+		printk("RISCV32 MIXED HSHM %s status=CLOSED session=0x%x echoed=%u\n", marker_role,
+		       session, echoed);
+	}
 }
 
 int main(void)
@@ -133,7 +211,7 @@ int main(void)
 	const char *dt_role = OMX_ROLE;
 	const char *uart_policy = OMX_UART_POLICY;
 	const struct workload_profile *profile = resolve_profile(dt_role);
-	const char *marker_role = profile ? profile->marker_role : "UNKNOWN";
+	const char *marker_role = OMX_MARKER_ROLE;
 	uint32_t phases = profile ? profile->phases : 3U;
 	uint32_t loops_per_phase = profile ? profile->loops_per_phase : 1200U;
 	uint32_t total = 0U;
@@ -146,11 +224,7 @@ int main(void)
 		IS_ENABLED(CONFIG_RISCV32_MIXED_VERBOSE) ? "enabled" : "disabled");
 
 	for (uint32_t phase = 0U; phase < phases; ++phase) {
-		uint32_t phase_acc = 0U;
-
-		for (uint32_t i = 0U; i < loops_per_phase; ++i) {
-			phase_acc += (i + (phase * 3U) + marker_role[0]) & 0x1FU;
-		}
+		uint32_t phase_acc = run_phase(phase, loops_per_phase, marker_role[0]);
 
 		total += phase_acc;
 
@@ -159,11 +233,19 @@ int main(void)
 		}
 	}
 
+	if (IS_ENABLED(CONFIG_RISCV32_MIXED_DVFS_SWEEP)) {
+		dvfs_sweep(marker_role, loops_per_phase);
+	}
+
 	printk("RISCV32 MIXED %s WORKLOAD DONE total=%u\n", marker_role, total);
 	LOG_INF("mixed workload completed marker=%s total=%u", marker_role, total);
-	mark_role_ready(dt_role);
+	mark_role_ready();
+
+	if (IS_ENABLED(CONFIG_RISCV32_MIXED_HYBRID_SHM)) {
+		hybrid_shm_serve(marker_role);
+	}
 
-	if (strcmp(dt_role, "cluster1-smp") == 0) {
+	if (OMX_SYNC_MASTER) {
 		uint32_t ready_mask = 0U;
 
 		for (uint32_t attempt = 0U; attempt < 300U; ++attempt) {